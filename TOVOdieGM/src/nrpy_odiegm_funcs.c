@@ -1,4 +1,5 @@
 #include "nrpy_odiegm_proto.c"
+#include "nrpy_odiegm_kernels.c" // The generated step kernels, see nrpy_odiegm_codegen.py.
 
 // This file contains the actual definitions for the funcitons outlined in nrpy_odiegm_proto.c
 
@@ -22,12 +23,72 @@ nrpy_odiegm_step_alloc (const nrpy_odiegm_step_type * T, size_t dim)
     s->adams_bashforth_order = 4; // default order chosen, if user wants control they will 
     // specify elsewhere after allocation is run.  
   }
+  if (T->method_type != 0) {
+    s->method_type = T->method_type; // Implicit methods tell us what they are, 
+    // their tables can have the same shape as an explicit method's. 
+  }
 
   s->y_values = (double *) malloc ((double)19.0 * dim * sizeof (double));
   // This here is the array used to store past values.
   // Only used for AB methods, but it still needs to be dynamically allocated. 
   // Having an adams_bashforth_order of 0 doesn't throw any errors, which is conveinent.
 
+  s->jacobian = NULL;
+  s->dfdx = NULL;
+  s->lu = NULL;
+  s->pivots = NULL;
+  s->jacobian_work = NULL;
+  s->jacobian_lanes = NULL;
+  // The implicit methods' workspace is allocated by nrpy_odiegm_step_implicit_workspace when first needed,
+  // since how big it is depends on whether the system has a sparse Jacobian. 
+  s->lu_h_gamma = 0.0;
+  s->jacobian_current = false;
+  s->jacobian_refresh = false;
+  s->jacobian_count = 0;
+  s->lu_count = 0;
+
+  s->krylov_dimension = 0;
+  s->krylov_tolerance = 1.0e-6;
+  s->krylov_max_restarts = 5;
+  s->krylov_x = 0.0;
+  s->krylov_y = NULL;
+  s->krylov_f = NULL;
+  s->krylov_basis = NULL;
+  s->krylov_work = NULL;
+  s->krylov_iterations = 0;
+
+  s->nonstiff_type = T;
+  s->stiff_type = NULL;
+  s->stiffness_threshold = 3.25;
+  s->stiff_count = 0;
+  s->nonstiff_count = 0;
+  s->switch_count = 0;
+
+  s->fsal_valid = false;
+  s->fsal_x = 0.0;
+  s->fsal_y = (double *) malloc (dim * sizeof (double));
+  s->fsal_f = (double *) malloc (dim * sizeof (double));
+  s->dense_x = 0.0;
+  s->dense_h = 0.0;
+  s->dense_y = NULL;
+  s->dense_k = NULL;
+  s->dense_stages = 0;
+  s->dense_type = NULL;
+  s->dense_valid = false;
+  // The dense output storage depends on the method's stage count, so it's allocated when first used. 
+
+  s->extrapolation_columns = 0;
+  s->extrapolation_columns_used = 0;
+  s->extrapolation_threads = 1;
+  s->extrapolation_table = NULL;
+  s->extrapolation_work = NULL;
+  s->low_storage_registers = NULL;
+  s->stage_work = NULL;
+  s->stage_work_size = 0;
+  s->method_work = NULL;
+  s->method_work_size = 0;
+  s->parallel_threshold = 100000;
+
   return s;
 }
 
@@ -74,6 +135,19 @@ nrpy_odiegm_control_y_new (double eps_abs, double eps_rel)
     // These are all the default values, virtually all responsible for adaptive timestep and 
     // error estimation.
 
+    c->abs_lim_vector = NULL;
+    c->rel_lim_vector = NULL;
+    c->error_weight = NULL;
+    c->error_weight_sum = 0.0;
+    c->error_norm = 0;
+    c->gridfunctions = 0;
+    for (int d = 0; d < 3; d++) {
+        c->grid_size[d] = 1;
+        c->grid_ghosts[d] = 0;
+    }
+    // By default every component uses the scalar limits above and the max norm. 
+    // nrpy_odiegm_control_set_tolerances changes that. 
+
     return c;
 }
 
@@ -93,6 +167,8 @@ nrpy_odiegm_driver * nrpy_odiegm_driver_alloc_y_new (const nrpy_odiegm_system *
 
     state->e = nrpy_odiegm_evolve_alloc (dim);
     state->h = hstart; // the step size. 
+    // A zero or negative hstart means "pick one for me." We can't do that yet since we don't
+    // know the initial conditions, so the estimate happens on the first call to evolve_apply. 
 
     state->c = nrpy_odiegm_control_y_new (epsabs, epsrel);
 
@@ -102,9 +178,301 @@ nrpy_odiegm_driver * nrpy_odiegm_driver_alloc_y_new (const nrpy_odiegm_system *
   return state;
 }
 
+nrpy_odiegm_driver * nrpy_odiegm_driver_alloc_gridfunctions (const nrpy_odiegm_system * sys,
+                                                             const nrpy_odiegm_step_type * T,
+                                                             const double hstart,
+                                                             const double epsabs, const double epsrel,
+                                                             int gridfunctions,
+                                                             int Nxx_plus_2NGHOSTS0, int Nxx_plus_2NGHOSTS1,
+                                                             int Nxx_plus_2NGHOSTS2, int NGHOSTS)
+{
+    // The driver for the method of lines on NRPy+ gridfunctions. y is the gridfunction storage itself 
+    // (y_n_gfs, say), it's updated in place, and the result isn't copied anywhere else. 
+    // sys->dimension has to be gridfunctions*Nxx_plus_2NGHOSTS0*Nxx_plus_2NGHOSTS1*Nxx_plus_2NGHOSTS2. 
+    // An NRPy+ right hand side plugs straight into sys->function: apply the boundary conditions to y 
+    // (which is always a stage input the function is free to change), then call rhs_eval with y as 
+    // in_gfs and dydx as rhs_gfs. The grid and params go in through sys->params. 
+    // Size: nothing the size of the grid goes on the stack, so the grid is limited by memory alone. 
+    // Besides y, the step allocates its K-values and working vectors on the first step, about 
+    // stages+10 copies of y for a method with an embedded error estimate (ADP5, ADP8) and about 
+    // 3*stages+12 for step doubling, plus e->yerr. 10^7 doubles of grid (80 MB) with ADP5 
+    // comes to roughly 2 GB in all. 
+    nrpy_odiegm_driver *state = nrpy_odiegm_driver_alloc_y_new (sys, T, hstart, epsabs, epsrel);
+    nrpy_odiegm_control_set_gridfunctions (state->c, gridfunctions, 
+                                           Nxx_plus_2NGHOSTS0, Nxx_plus_2NGHOSTS1, Nxx_plus_2NGHOSTS2, NGHOSTS);
+    free (state->e->y0);
+    state->e->y0 = NULL;
+    return state;
+}
+
+nrpy_odiegm_parareal * nrpy_odiegm_parareal_alloc (const nrpy_odiegm_system * sys,
+                                                   const nrpy_odiegm_step_type * coarse_type,
+                                                   const double coarse_step,
+                                                   const nrpy_odiegm_step_type * fine_type,
+                                                   const double epsabs, const double epsrel,
+                                                   const int slices)
+{
+    // Sets up a Parareal solve, see the struct in nrpy_odiegm.h. 
+    // Both methods have to be one-step methods (anything but Adams-Bashforth). 
+    // The coarse method should be cheap and stable at coarse_step, the fine method accurate: 
+    // ADP8 at the error limits given here, say. 
+    nrpy_odiegm_parareal *p = (nrpy_odiegm_parareal *) malloc (sizeof (nrpy_odiegm_parareal));
+    const size_t dim = sys->dimension;
+    p->sys = sys;
+    p->c = nrpy_odiegm_control_y_new (epsabs, epsrel);
+    p->slices = slices;
+
+    p->coarse_s = nrpy_odiegm_step_alloc (coarse_type, dim);
+    p->coarse_e = nrpy_odiegm_evolve_alloc (dim);
+    p->coarse_e->no_adaptive_step = true;
+    p->coarse_step = coarse_step;
+
+    p->fine_s = (nrpy_odiegm_step **) malloc (slices * sizeof (nrpy_odiegm_step *));
+    p->fine_e = (nrpy_odiegm_evolve **) malloc (slices * sizeof (nrpy_odiegm_evolve *));
+    p->fine_h = (double *) malloc (slices * sizeof (double));
+    for (int n = 0; n < slices; n++) {
+        p->fine_s[n] = nrpy_odiegm_step_alloc (fine_type, dim);
+        p->fine_e[n] = nrpy_odiegm_evolve_alloc (dim);
+        p->fine_h[n] = 0.0; // Estimated on the first solve. 
+    }
+
+    p->u = (double *) malloc ((slices + 1) * dim * sizeof (double));
+    p->coarse = (double *) malloc (slices * dim * sizeof (double));
+    p->fine = (double *) malloc (slices * dim * sizeof (double));
+
+    p->max_iterations = slices;
+    p->tolerance = 1.0;
+    p->threads = 1;
+    p->iterations = 0;
+    p->correction = 0.0;
+    return p;
+}
+
+void nrpy_odiegm_control_set_tolerances (nrpy_odiegm_control * c, size_t dim,
+                                         const double abs_lim_vector[], const double rel_lim_vector[],
+                                         const bool error_mask[])
+{
+    // Gives every component its own absolute and relative error limit, and optionally 
+    // removes components from step control entirely (error_mask[n] = false).
+    // Any of the three arrays may be NULL, in which case the scalar abs_lim/rel_lim 
+    // (or "every component counts") is used for that part. 
+    // The arrays are copied, so the caller doesn't need to keep them around. 
+    if (c->abs_lim_vector == NULL) {
+        c->abs_lim_vector = (double *) malloc (dim * sizeof (double));
+        c->rel_lim_vector = (double *) malloc (dim * sizeof (double));
+        c->error_weight = (double *) malloc (dim * sizeof (double));
+    }
+    c->error_weight_sum = 0.0;
+    for (size_t n = 0; n < dim; n++) {
+        c->abs_lim_vector[n] = c->abs_lim;
+        c->rel_lim_vector[n] = c->rel_lim;
+        c->error_weight[n] = 1.0;
+        if (abs_lim_vector != NULL) {
+            c->abs_lim_vector[n] = abs_lim_vector[n];
+        }
+        if (rel_lim_vector != NULL) {
+            c->rel_lim_vector[n] = rel_lim_vector[n];
+        }
+        if (error_mask != NULL && error_mask[n] == false) {
+            c->error_weight[n] = 0.0;
+        }
+        c->error_weight_sum = c->error_weight_sum + c->error_weight[n];
+    }
+}
+
+void nrpy_odiegm_control_set_gridfunctions (nrpy_odiegm_control * c, int gridfunctions,
+                                            int Nxx_plus_2NGHOSTS0, int Nxx_plus_2NGHOSTS1,
+                                            int Nxx_plus_2NGHOSTS2, int NGHOSTS)
+{
+    // Tells the error control that y is NRPy+ gridfunctions (IDX4S order), so that only the 
+    // interior points count. The ghost zones are filled in by boundary conditions, not by the 
+    // method, so their "error" says nothing about whether the step was good. 
+    // Unlike nrpy_odiegm_control_set_tolerances this needs no per-component arrays, the interior 
+    // is worked out from the layout. The two can be used together. 
+    c->gridfunctions = gridfunctions;
+    int sizes[3] = {Nxx_plus_2NGHOSTS0, Nxx_plus_2NGHOSTS1, Nxx_plus_2NGHOSTS2};
+    for (int d = 0; d < 3; d++) {
+        c->grid_size[d] = sizes[d];
+        c->grid_ghosts[d] = NGHOSTS;
+        if (sizes[d] <= 2*NGHOSTS) {
+            c->grid_ghosts[d] = 0;
+            // A direction that's only a point or two across (a 1D or 2D problem) has no ghost zones. 
+        }
+    }
+}
+
+void nrpy_odiegm_step_set_stiff_switching (nrpy_odiegm_step * s, 
+                                           const nrpy_odiegm_step_type * stiff_type)
+{
+    // Turns on automatic switching between the step's (explicit) method and an implicit one, 
+    // in the spirit of LSODA. Passing NULL turns it back off. 
+    s->nonstiff_type = s->type;
+    s->stiff_type = stiff_type;
+    s->stiff_count = 0;
+    s->nonstiff_count = 0;
+}
+
+void nrpy_odiegm_step_set_matrix_free (nrpy_odiegm_step * s, int krylov_dimension)
+{
+    // Makes the implicit methods solve their linear systems with GMRES instead of a stored, 
+    // decomposed Jacobian (Jacobian-free Newton-Krylov). Worth it when even a sparse Jacobian 
+    // is too big to form or factor. Pair it with a preconditioner on the system if you can, 
+    // plain GMRES on a stiff system can take a lot of iterations. 
+    // 0 goes back to storing the Jacobian. Something like 20-50 is a sensible krylov_dimension. 
+    // Any workspace allocated for the old mode is dropped, the right one gets allocated on first use. 
+    free (s->jacobian);
+    free (s->dfdx);
+    free (s->lu);
+    free (s->pivots);
+    free (s->jacobian_work);
+    free (s->jacobian_lanes);
+    free (s->krylov_y);
+    free (s->krylov_f);
+    free (s->krylov_basis);
+    free (s->krylov_work);
+    s->jacobian = NULL;
+    s->dfdx = NULL;
+    s->lu = NULL;
+    s->pivots = NULL;
+    s->jacobian_work = NULL;
+    s->jacobian_lanes = NULL;
+    s->krylov_y = NULL;
+    s->krylov_f = NULL;
+    s->krylov_basis = NULL;
+    s->krylov_work = NULL;
+    s->krylov_dimension = krylov_dimension;
+    s->lu_h_gamma = 0.0;
+    s->jacobian_current = false;
+    s->jacobian_refresh = true;
+}
+
+void nrpy_odiegm_step_set_extrapolation_threads (nrpy_odiegm_step * s, int threads)
+{
+    // Lets the extrapolation methods (GBS) run their midpoint sequences at the same time, 
+    // one per thread. They're completely independent until the extrapolation at the end, 
+    // so a single high accuracy solve can use several cores. 
+    // The system's function gets called from several threads at once, so it must not write 
+    // to anything shared (the params struct included). Only does anything when compiled with OpenMP. 
+    if (threads < 1) {
+        threads = 1;
+    }
+    s->extrapolation_threads = threads;
+}
+
+nrpy_odiegm_sparsity * nrpy_odiegm_sparsity_alloc (size_t dim, size_t nonzeros,
+                                                   const int row_start[], const int column_index[])
+{
+    // Takes a Jacobian sparsity pattern in CSR form (row_start has dim+1 entries) and works out
+    // everything needed to build the Jacobian cheaply: the same pattern by column, 
+    // a column coloring, and the bandwidth. The arrays are copied. 
+    // Attach the result to the system's sparsity slot. 
+    nrpy_odiegm_sparsity *p = (nrpy_odiegm_sparsity *) malloc (sizeof (nrpy_odiegm_sparsity));
+    p->dimension = (int)dim;
+    p->nonzeros = (int)nonzeros;
+    p->row_start = (int *) malloc ((dim + 1) * sizeof (int));
+    p->column_index = (int *) malloc (nonzeros * sizeof (int));
+    p->column_start = (int *) calloc (dim + 1, sizeof (int));
+    p->row_index = (int *) malloc (nonzeros * sizeof (int));
+    p->csr_position = (int *) malloc (nonzeros * sizeof (int));
+    p->color = (int *) malloc (dim * sizeof (int));
+    for (int n = 0; n <= (int)dim; n++) {
+        p->row_start[n] = row_start[n];
+    }
+    p->lower_bandwidth = 0;
+    p->upper_bandwidth = 0;
+    for (int i = 0; i < (int)dim; i++) {
+        for (int k = row_start[i]; k < row_start[i+1]; k++) {
+            int j = column_index[k];
+            p->column_index[k] = j;
+            p->column_start[j+1]++;
+            if (i - j > p->lower_bandwidth) {
+                p->lower_bandwidth = i - j;
+            }
+            if (j - i > p->upper_bandwidth) {
+                p->upper_bandwidth = j - i;
+            }
+        }
+    }
+
+    // Flip the pattern around so we can go through it by column. 
+    for (int j = 0; j < (int)dim; j++) {
+        p->column_start[j+1] = p->column_start[j+1] + p->column_start[j];
+    }
+    int *fill = (int *) malloc (dim * sizeof (int));
+    // Heap rather than stack, these patterns can be for very large systems. 
+    for (int j = 0; j < (int)dim; j++) {
+        fill[j] = p->column_start[j];
+    }
+    for (int i = 0; i < (int)dim; i++) {
+        for (int k = row_start[i]; k < row_start[i+1]; k++) {
+            int j = column_index[k];
+            p->row_index[fill[j]] = i;
+            p->csr_position[fill[j]] = k;
+            fill[j]++;
+        }
+    }
+
+    // Greedy coloring: give every column the smallest color not already used by 
+    // a column it shares a row with. Optimal for banded patterns, good enough for the rest. 
+    int *last_seen = fill; // last_seen[c] == j means color c is taken by a neighbor of column j. 
+    // (Reuses the fill array, we're done with it.) 
+    for (int j = 0; j < (int)dim; j++) {
+        p->color[j] = -1;
+        last_seen[j] = -1;
+    }
+    p->number_of_colors = 0;
+    for (int j = 0; j < (int)dim; j++) {
+        for (int k = p->column_start[j]; k < p->column_start[j+1]; k++) {
+            int i = p->row_index[k];
+            for (int m = row_start[i]; m < row_start[i+1]; m++) {
+                int neighbor_color = p->color[column_index[m]];
+                if (neighbor_color >= 0) {
+                    last_seen[neighbor_color] = j;
+                }
+            }
+        }
+        int new_color = 0;
+        while (last_seen[new_color] == j) {
+            new_color++;
+        }
+        p->color[j] = new_color;
+        if (new_color + 1 > p->number_of_colors) {
+            p->number_of_colors = new_color + 1;
+        }
+    }
+    free (fill);
+    return p;
+}
+
+nrpy_odiegm_sparsity * nrpy_odiegm_sparsity_banded_alloc (size_t dim, int lower_bandwidth, int upper_bandwidth)
+{
+    // Convenience for the most common case: a Jacobian that's nonzero only within 
+    // lower_bandwidth below and upper_bandwidth above the diagonal (method of lines, for example). 
+    int *row_start = (int *) malloc ((dim + 1) * sizeof (int));
+    int *column_index = (int *) malloc (dim * (lower_bandwidth + upper_bandwidth + 1) * sizeof (int));
+    int nonzeros = 0;
+    for (int i = 0; i < (int)dim; i++) {
+        row_start[i] = nonzeros;
+        for (int j = i - lower_bandwidth; j <= i + upper_bandwidth; j++) {
+            if (j >= 0 && j < (int)dim) {
+                column_index[nonzeros] = j;
+                nonzeros++;
+            }
+        }
+    }
+    row_start[dim] = nonzeros;
+    nrpy_odiegm_sparsity *p = nrpy_odiegm_sparsity_alloc (dim, nonzeros, row_start, column_index);
+    free (row_start);
+    free (column_index);
+    return p;
+}
+
 // Memory freeing methods. 
 void nrpy_odiegm_control_free (nrpy_odiegm_control * c)
 {
+  free (c->abs_lim_vector);
+  free (c->rel_lim_vector);
+  free (c->error_weight);
   free (c);
 }
 void nrpy_odiegm_evolve_free (nrpy_odiegm_evolve * e)
@@ -116,8 +484,38 @@ void nrpy_odiegm_evolve_free (nrpy_odiegm_evolve * e)
 void nrpy_odiegm_step_free (nrpy_odiegm_step * s)
 { 
   free (s->y_values);
+  free (s->jacobian);
+  free (s->dfdx);
+  free (s->lu);
+  free (s->pivots);
+  free (s->jacobian_work);
+  free (s->jacobian_lanes);
+  free (s->krylov_y);
+  free (s->krylov_f);
+  free (s->krylov_basis);
+  free (s->krylov_work);
+  free (s->fsal_y);
+  free (s->fsal_f);
+  free (s->dense_y);
+  free (s->dense_k);
+  free (s->extrapolation_table);
+  free (s->extrapolation_work);
+  free (s->low_storage_registers);
+  free (s->stage_work);
+  free (s->method_work);
   free (s);
 }
+void nrpy_odiegm_sparsity_free (nrpy_odiegm_sparsity * p)
+{
+  // Not freed by the driver, since it belongs to the system, which the user owns. 
+  free (p->row_start);
+  free (p->column_index);
+  free (p->column_start);
+  free (p->row_index);
+  free (p->csr_position);
+  free (p->color);
+  free (p);
+}
 void nrpy_odiegm_driver_free (nrpy_odiegm_driver * state)
 {
   // In most cases, this method should be called alone, calling the others would be redundant. 
@@ -132,12 +530,1653 @@ void nrpy_odiegm_driver_free (nrpy_odiegm_driver * state)
 
   free (state);
 }
+void nrpy_odiegm_parareal_free (nrpy_odiegm_parareal * p)
+{
+  // Like the driver, frees everything it allocated. The system belongs to the user. 
+  nrpy_odiegm_control_free (p->c);
+  nrpy_odiegm_step_free (p->coarse_s);
+  nrpy_odiegm_evolve_free (p->coarse_e);
+  for (int n = 0; n < p->slices; n++) {
+    nrpy_odiegm_step_free (p->fine_s[n]);
+    nrpy_odiegm_evolve_free (p->fine_e[n]);
+  }
+  free (p->fine_s);
+  free (p->fine_e);
+  free (p->fine_h);
+  free (p->u);
+  free (p->coarse);
+  free (p->fine);
+  free (p);
+}
+
+// The actual stepping functions follow. 
+
+// The goal is for these functions to be completely agnostic to whatever the user is doing, 
+// they should always work regardless of the form of the system passed, the method passed, and even
+// if the user does something dumb it shouldn't crash. It will spit out nonsense in those cases, though. 
+
+void nrpy_odiegm_stage_combination (const nrpy_odiegm_step * s, int number_of_equations, const double y[],
+                                    int terms, const double weight[], double * const k[], double y_out[]) {
+    // y_out = y + weight[0]*k[0] + weight[1]*k[1] + ..., which is how every explicit stage gets its input 
+    // and how the answer is put together at the end. y_out may be y itself. 
+    // Done in blocks small enough to stay in cache, adding every k into one block before moving on, 
+    // so y_out is only written to memory once however many terms there are, and each inner loop 
+    // is a plain sweep the compiler can vectorize. The terms are still added in order, 
+    // so the answer is exactly what adding them one full pass at a time would give. 
+    // Big systems spread the blocks over threads, see parallel_threshold in the step struct. 
+    const int block_size = 512; // 4 kB per array, so y_out and a k fit in L1 together. 
+    int blocks = (number_of_equations + block_size - 1)/block_size;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(number_of_equations >= s->parallel_threshold)
+#endif
+    for (int b = 0; b < blocks; b++) {
+        int start = b*block_size;
+        int length = number_of_equations - start;
+        if (length > block_size) {
+            length = block_size;
+        }
+        if (y_out != y) {
+            for (int n = 0; n < length; n++) {
+                y_out[start + n] = y[start + n];
+            }
+        }
+        double * restrict out = y_out + start;
+        for (int t = 0; t < terms; t++) {
+            const double * restrict k_t = k[t] + start;
+            double w = weight[t];
+            for (int n = 0; n < length; n++) {
+                out[n] = out[n] + w*k_t[n];
+            }
+        }
+    }
+}
+
+int nrpy_odiegm_evaluate_batch (const nrpy_odiegm_system * dydt, int points, const double x[],
+                                double *y[], double *dydx[]) {
+    // Evaluates the system at several points that don't depend on each other. 
+    // If the user gave us a batch_function it gets all of them in one call, 
+    // otherwise this is just a loop over the ordinary function. 
+    // Returns the first nonzero status, like the function itself would. 
+    if (dydt->batch_function != NULL) {
+        return dydt->batch_function(points, x, y, dydx, dydt->params);
+    }
+    int status = 0;
+    for (int p = 0; p < points; p++) {
+        int result = dydt->function(x[p], y[p], dydx[p], dydt->params);
+        if (status == 0) {
+            status = result;
+        }
+    }
+    return status;
+}
+
+double * nrpy_odiegm_step_work (double **work, size_t *work_size, size_t size) {
+    // Hands back *work (s->stage_work or s->method_work), first growing it to at least size doubles 
+    // if it isn't that big already. Anything it held before is gone if it grows. 
+    if (*work_size < size) {
+        free(*work);
+        *work = (double *) malloc (size * sizeof (double));
+        *work_size = size;
+    }
+    return *work;
+}
+
+void nrpy_odiegm_doubling_stages (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt, int rows, int columns,
+                                  const double * restrict butcher, double x, double step, const double y[],
+                                  double f_start[], bool *have_f_start, double y_full[], double y_half[]) {
+    // Step doubling's full step (into y_full) and first half step (into y_half). 
+    // Both start from y, so stage j of one never waits on the other: each stage is one 
+    // batched evaluation of two points instead of two separate calls. 
+    // The arithmetic is exactly what evolve_apply does for each on its own, so the answers match bit for bit. 
+    // butcher is the explicit (method_type 0) table, rows x columns, solution weights in the last row. 
+    int number_of_equations = (int)(dydt->dimension);
+    double *work = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, (2*rows + 4)*(size_t)number_of_equations);
+    double (*K_full)[number_of_equations] = (double (*)[number_of_equations]) work;
+    double (*K_half)[number_of_equations] = K_full + rows;
+    double (*y_insert)[number_of_equations] = K_half + rows;
+    double (*dy_out)[number_of_equations] = y_insert + 2;
+    double * lane_y[2] = {y_insert[0], y_insert[1]};
+    double * lane_dydx[2] = {dy_out[0], dy_out[1]};
+    const double scale[2] = {1.0, 0.5};
+
+    double * stage_k[columns];
+    double stage_weight[columns];
+    for (int j = 1; j < rows; j++) {
+        const double *a_row = butcher + (j-1)*columns;
+        double x_insert[2];
+        for (int lane = 0; lane < 2; lane++) {
+            double (*K)[number_of_equations] = (lane == 0) ? K_full : K_half;
+            int terms = 0;
+            for (int n = 1; n < columns && n < j; n++) {
+                if (a_row[n] != 0.0) {
+                    stage_weight[terms] = a_row[n];
+                    stage_k[terms] = K[n];
+                    terms++;
+                }
+            }
+            nrpy_odiegm_stage_combination(s, number_of_equations, y, terms, stage_weight, stage_k, y_insert[lane]);
+            x_insert[lane] = x + a_row[0]*step*scale[lane];
+        }
+
+        if (j == 1 && a_row[0] == 0.0) {
+            // Both lanes start with f(x, y), so there's nothing to batch. 
+            if (*have_f_start == false) {
+                dydt->function(x_insert[0], y_insert[0], f_start, dydt->params);
+                *have_f_start = true;
+            }
+            for (int n = 0; n < number_of_equations; n++) {
+                dy_out[0][n] = f_start[n];
+                dy_out[1][n] = f_start[n];
+            }
+        } else {
+            nrpy_odiegm_evaluate_batch(dydt, 2, x_insert, lane_y, lane_dydx);
+        }
+        for (int n = 0; n < number_of_equations; n++) {
+            K_full[j][n] = step*scale[0]*dy_out[0][n];
+            K_half[j][n] = step*scale[1]*dy_out[1][n];
+        }
+    }
+
+    const double *b_row = butcher + (rows-1)*columns;
+    for (int lane = 0; lane < 2; lane++) {
+        double (*K)[number_of_equations] = (lane == 0) ? K_full : K_half;
+        int terms = 0;
+        for (int j = 1; j < columns; j++) {
+            if (b_row[j] != 0.0) {
+                stage_weight[terms] = b_row[j];
+                stage_k[terms] = K[j];
+                terms++;
+            }
+        }
+        nrpy_odiegm_stage_combination(s, number_of_equations, y, terms, stage_weight, stage_k, (lane == 0) ? y_full : y_half);
+    }
+}
+
+double nrpy_odiegm_initial_step (const nrpy_odiegm_system * dydt, const nrpy_odiegm_control * c,
+                                 nrpy_odiegm_step * s, double t, const double y[]) {
+    // Picks a starting step when the user doesn't hand us one (hstart <= 0).
+    // This is the standard estimate from Hairer, Norsett, and Wanner (Solving ODEs I, section II.4),
+    // also used by Shampine's codes: compare the sizes of y and f(t,y), take one trial Euler step,
+    // and use the change in f to guess how big a step the method's order can handle.
+    // Costs two function evaluations, which is far cheaper than the dozens of steps
+    // the controller otherwise spends growing (or rejecting) a hand-picked step.
+    int number_of_equations = (int)(dydt->dimension);
+    int order = s->type->order;
+    if (s->method_type == 2) {
+        order = s->adams_bashforth_order;
+        // The AB table's "order" is just its size, the real order is set separately.
+    }
+
+    double *work = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, 4*(size_t)number_of_equations);
+    double * restrict y_insert = work;
+    double * restrict f_initial = work + number_of_equations;
+    double * restrict f_trial = work + 2*number_of_equations;
+    double * restrict error_scale = work + 3*number_of_equations;
+    // The user's function is allowed to clamp y (see exception_handler), so never hand it y itself.
+
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n];
+        if (c->abs_lim_vector == NULL) {
+            error_scale[n] = c->abs_lim + c->rel_lim*fabs(y[n]);
+        } else {
+            error_scale[n] = c->abs_lim_vector[n] + c->rel_lim_vector[n]*fabs(y[n]);
+        }
+    }
+    dydt->function(t, y_insert, f_initial, dydt->params);
+
+    // RMS norms of the initial values and initial derivatives, weighted by the tolerances.
+    double d0 = 0.0;
+    double d1 = 0.0;
+    for (int n = 0; n < number_of_equations; n++) {
+        d0 = d0 + (y[n]/error_scale[n])*(y[n]/error_scale[n]);
+        d1 = d1 + (f_initial[n]/error_scale[n])*(f_initial[n]/error_scale[n]);
+    }
+    d0 = sqrt(d0/number_of_equations);
+    d1 = sqrt(d1/number_of_equations);
+
+    double h0 = 1.0e-6;
+    if (d0 >= 1.0e-5 && d1 >= 1.0e-5) {
+        h0 = 0.01*d0/d1;
+    }
+    if (h0 > c->absolute_max_step) {
+        h0 = c->absolute_max_step;
+    }
+
+    // One explicit Euler step, then see how much the derivative changed.
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + h0*f_initial[n];
+    }
+    dydt->function(t + h0, y_insert, f_trial, dydt->params);
+
+    double d2 = 0.0;
+    for (int n = 0; n < number_of_equations; n++) {
+        d2 = d2 + ((f_trial[n] - f_initial[n])/error_scale[n])*((f_trial[n] - f_initial[n])/error_scale[n]);
+    }
+    d2 = sqrt(d2/number_of_equations)/h0;
+
+    double d_max = d1;
+    if (d2 > d_max) {
+        d_max = d2;
+    }
+    double h1;
+    if (d_max <= 1.0e-15) {
+        h1 = h0*1.0e-3;
+        if (h1 < 1.0e-6) {
+            h1 = 1.0e-6;
+        }
+    } else {
+        h1 = pow(0.01/d_max, 1.0/(order+1.0));
+    }
+
+    double step = 100.0*h0;
+    if (h1 < step) {
+        step = h1;
+    }
+
+    // Respect the user's hard limits, same as any other step would.
+    if (step > c->absolute_max_step) {
+        step = c->absolute_max_step;
+    } else if (step < c->absolute_min_step) {
+        step = c->absolute_min_step;
+    }
+
+    return step;
+}
+
+double nrpy_odiegm_error_ratio (const nrpy_odiegm_control * c, int number_of_equations, double step,
+                                const double * restrict yerr, const double * restrict y,
+                                const double * restrict dydx) {
+    // The error kernel: takes the estimated error of every component (yerr) and reduces it to 
+    // a single ratio of estimated error to allowed error. Above 1 means the step was too big.
+    // The allowed error is abs + rel*(ay*|y| + ady*h*|y'|), the same formula GSL uses. 
+    // Each loop below is a straight pass over the components with no branches inside, so the 
+    // compiler is free to vectorize it. That's why the scalar and vector tolerance cases 
+    // (and the two norms) get their own loops rather than an if statement per component. 
+    double ay_error_scaler = c->ay_error_scaler;
+    double ady_error_scaler = c->ady_error_scaler;
+    double ratio_max = 0.0;
+    double ratio_squared_sum = 0.0;
+    double components_counted = 0.0;
+    // Both norms are accumulated in the same pass, it costs next to nothing and keeps the loops simple. 
+
+    // Which components count: all of them in one run, or for gridfunctions only the interior points, 
+    // which come in contiguous runs along the first direction (one per gridfunction, row and plane). 
+    int runs = 1;
+    int run_length = number_of_equations;
+    int interior[3] = {1, 1, 1};
+    if (c->gridfunctions > 0) {
+        for (int d = 0; d < 3; d++) {
+            interior[d] = c->grid_size[d] - 2*c->grid_ghosts[d];
+        }
+        run_length = interior[0];
+        runs = c->gridfunctions*interior[1]*interior[2];
+    }
+
+    for (int r = 0; r < runs; r++) {
+        int start = 0;
+        if (c->gridfunctions > 0) {
+            int i1 = c->grid_ghosts[1] + r % interior[1];
+            int i2 = c->grid_ghosts[2] + (r / interior[1]) % interior[2];
+            int gridfunction = r / (interior[1]*interior[2]);
+            start = c->grid_ghosts[0] + c->grid_size[0]*(i1 + c->grid_size[1]*(i2 + c->grid_size[2]*gridfunction));
+            // IDX4S(gridfunction, NGHOSTS, i1, i2). 
+        }
+        const double * restrict yerr_run = yerr + start;
+        const double * restrict y_run = y + start;
+        const double * restrict dydx_run = dydx + start;
+
+        if (c->abs_lim_vector == NULL) {
+            double absolute_error_limit = c->abs_lim;
+            double relative_error_limit = c->rel_lim;
+            for (int n = 0; n < run_length; n++) {
+                double ratio = yerr_run[n]/(absolute_error_limit + relative_error_limit*(ay_error_scaler*fabs(y_run[n]) + ady_error_scaler*step*fabs(dydx_run[n])));
+                ratio_max = fmax(ratio_max, ratio);
+                ratio_squared_sum = ratio_squared_sum + ratio*ratio;
+            }
+            components_counted = components_counted + run_length;
+        } else {
+            // Per-component tolerances. The mask is stored as a weight of 1 or 0. Excluded 
+            // components are skipped by selection rather than multiplied by 0, since a masked 
+            // component is free to have a zero tolerance or a huge error, and 0*inf or 0/0 
+            // would put a NaN into the RMS sum. 
+            const double * restrict abs_lim_vector = c->abs_lim_vector + start;
+            const double * restrict rel_lim_vector = c->rel_lim_vector + start;
+            const double * restrict error_weight = c->error_weight + start;
+            for (int n = 0; n < run_length; n++) {
+                double ratio = (error_weight[n] > 0.0) ? yerr_run[n]/(abs_lim_vector[n] + rel_lim_vector[n]*(ay_error_scaler*fabs(y_run[n]) + ady_error_scaler*step*fabs(dydx_run[n]))) : 0.0;
+                ratio_max = fmax(ratio_max, ratio);
+                ratio_squared_sum = ratio_squared_sum + ratio*ratio;
+                components_counted = components_counted + error_weight[n];
+            }
+        }
+    }
+
+    double ratio_ED = ratio_max;
+    // Max norm, the original behavior: the worst component decides. 
+    if (c->error_norm == 1 && components_counted > 0.0) {
+        ratio_ED = sqrt(ratio_squared_sum/components_counted);
+        // RMS norm, averaged over only the components that actually count. 
+    }
+    return ratio_ED;
+}
+
+void nrpy_odiegm_step_implicit_workspace (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt) {
+    // Allocates the Jacobian and LU storage the first time an implicit method needs it. 
+    // Dense systems need dimension^2 of each, sparse ones only their nonzeros and a band, 
+    // matrix-free ones no Jacobian at all, just the Krylov vectors. 
+    // The finite difference scratch is here too, so building a Jacobian never allocates. 
+    if (s->dfdx != NULL) {
+        return;
+    }
+    size_t dim = dydt->dimension;
+    s->dfdx = (double *) malloc (dim * sizeof (double));
+    if (s->krylov_dimension > 0) {
+        s->krylov_y = (double *) malloc (dim * sizeof (double));
+        s->krylov_f = (double *) malloc (dim * sizeof (double));
+        s->krylov_basis = (double *) malloc ((s->krylov_dimension + 1) * dim * sizeof (double));
+        s->krylov_work = (double *) malloc (3 * dim * sizeof (double));
+        return;
+    }
+    s->pivots = (int *) malloc (dim * sizeof (int));
+    if (dydt->sparsity != NULL) {
+        const nrpy_odiegm_sparsity *p = dydt->sparsity;
+        size_t band_width = 2*p->lower_bandwidth + p->upper_bandwidth + 1;
+        // Pivoting can push U out by another lower_bandwidth, so the band needs room for that. 
+        s->jacobian = (double *) malloc (p->nonzeros * sizeof (double));
+        s->lu = (double *) malloc (dim * band_width * sizeof (double));
+    } else {
+        s->jacobian = (double *) malloc (dim * dim * sizeof (double));
+        s->lu = (double *) malloc (dim * dim * sizeof (double));
+    }
+    if (dydt->jacobian != NULL) {
+        return;
+    }
+    if (dydt->batch_function != NULL) {
+        // One y and one f per batched point (f itself, every column or color, and the shift in x), 
+        // then the column perturbations and the points' x values. 
+        size_t points = dim + 2;
+        if (dydt->sparsity != NULL) {
+            points = dydt->sparsity->number_of_colors + 2;
+        }
+        s->jacobian_work = (double *) malloc (((2 * points + 1) * dim + points) * sizeof (double));
+        s->jacobian_lanes = (double **) malloc (2 * points * sizeof (double *));
+    } else {
+        s->jacobian_work = (double *) malloc (4 * dim * sizeof (double));
+    }
+}
+
+void nrpy_odiegm_jacobian_eval (const nrpy_odiegm_system * dydt, nrpy_odiegm_step * s,
+                                double x, const double y[]) {
+    // Fills s->jacobian (df/dy) and s->dfdx (df/dx) at (x, y). 
+    // Uses the user's Jacobian if the system has one (dense, or the nonzeros in CSR order if 
+    // the system has a sparsity pattern). Otherwise we fall back on one-sided 
+    // finite differences, which costs dimension+2 function evaluations for a dense Jacobian, 
+    // or number_of_colors+2 if the system has a sparsity pattern. 
+    nrpy_odiegm_step_implicit_workspace(s, dydt);
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict jacobian = s->jacobian;
+    double * restrict dfdx = s->dfdx;
+
+    if (s->krylov_dimension > 0) {
+        // Matrix-free: all we keep is where J lives, J*v is worked out on demand. 
+        double * restrict y_insert = s->krylov_work;
+        s->krylov_x = x;
+        for (int n = 0; n < number_of_equations; n++) {
+            s->krylov_y[n] = y[n];
+            y_insert[n] = y[n];
+        }
+        dydt->function(x, y_insert, s->krylov_f, dydt->params);
+        for (int n = 0; n < number_of_equations; n++) {
+            y_insert[n] = y[n];
+        }
+        double delta = sqrt(DBL_EPSILON*fmax(1.0e-5, fabs(x)));
+        dydt->function(x + delta, y_insert, dfdx, dydt->params);
+        for (int n = 0; n < number_of_equations; n++) {
+            dfdx[n] = (dfdx[n] - s->krylov_f[n])/delta;
+        }
+    } else if (dydt->jacobian != NULL) {
+        dydt->jacobian(x, y, jacobian, dfdx, dydt->params);
+    } else if (dydt->batch_function != NULL) {
+        // The same differences as below, but none of the evaluations depend on each other, 
+        // so they all go to the system in one batch: f itself, one per column (or color), 
+        // and the shift in x. 
+        const nrpy_odiegm_sparsity *p = dydt->sparsity;
+        int perturbations = number_of_equations;
+        if (p != NULL) {
+            perturbations = p->number_of_colors;
+        }
+        int points = perturbations + 2;
+        double *y_batch = s->jacobian_work;
+        double *f_batch = y_batch + points * number_of_equations;
+        double *delta = f_batch + points * number_of_equations;
+        double *lane_x = delta + number_of_equations;
+        double **lane_y = s->jacobian_lanes;
+        double **lane_f = s->jacobian_lanes + points;
+        for (int l = 0; l < points; l++) {
+            lane_y[l] = y_batch + l*number_of_equations;
+            lane_f[l] = f_batch + l*number_of_equations;
+            lane_x[l] = x;
+            for (int n = 0; n < number_of_equations; n++) {
+                lane_y[l][n] = y[n];
+            }
+        }
+        // Lane 0 is f(x, y), lanes 1 to perturbations the columns, the last one x + delta_x. 
+        for (int m = 0; m < number_of_equations; m++) {
+            int lane = m + 1;
+            if (p != NULL) {
+                lane = p->color[m] + 1;
+            }
+            lane_y[lane][m] = y[m] + sqrt(DBL_EPSILON*fmax(1.0e-5, fabs(y[m])));
+            delta[m] = lane_y[lane][m] - y[m];
+        }
+        double delta_x = sqrt(DBL_EPSILON*fmax(1.0e-5, fabs(x)));
+        lane_x[points - 1] = x + delta_x;
+        nrpy_odiegm_evaluate_batch(dydt, points, lane_x, lane_y, lane_f);
+
+        const double * restrict f_initial = lane_f[0];
+        if (p == NULL) {
+            for (int m = 0; m < number_of_equations; m++) {
+                const double * restrict f_shifted = lane_f[m + 1];
+                for (int n = 0; n < number_of_equations; n++) {
+                    jacobian[n*number_of_equations + m] = (f_shifted[n] - f_initial[n])/delta[m];
+                }
+            }
+        } else {
+            for (int m = 0; m < number_of_equations; m++) {
+                const double * restrict f_shifted = lane_f[p->color[m] + 1];
+                for (int k = p->column_start[m]; k < p->column_start[m+1]; k++) {
+                    int n = p->row_index[k];
+                    jacobian[p->csr_position[k]] = (f_shifted[n] - f_initial[n])/delta[m];
+                }
+            }
+        }
+        for (int n = 0; n < number_of_equations; n++) {
+            dfdx[n] = (lane_f[points - 1][n] - f_initial[n])/delta_x;
+        }
+    } else {
+        double *work = s->jacobian_work;
+        double * restrict y_insert = work;
+        double * restrict f_initial = work + number_of_equations;
+        double * restrict f_shifted = work + 2*number_of_equations;
+        double * restrict delta_column = work + 3*number_of_equations;
+        // The user's function is allowed to clamp y, so y_insert is reset before every call. 
+        for (int n = 0; n < number_of_equations; n++) {
+            y_insert[n] = y[n];
+        }
+        dydt->function(x, y_insert, f_initial, dydt->params);
+
+        if (dydt->sparsity == NULL) {
+            for (int m = 0; m < number_of_equations; m++) {
+                for (int n = 0; n < number_of_equations; n++) {
+                    y_insert[n] = y[n];
+                }
+                // The usual sqrt(machine epsilon) perturbation, scaled by the size of the component. 
+                double delta = sqrt(DBL_EPSILON*fmax(1.0e-5, fabs(y[m])));
+                y_insert[m] = y[m] + delta;
+                delta = y_insert[m] - y[m]; // The perturbation we actually got after rounding. 
+                dydt->function(x, y_insert, f_shifted, dydt->params);
+                for (int n = 0; n < number_of_equations; n++) {
+                    jacobian[n*number_of_equations + m] = (f_shifted[n] - f_initial[n])/delta;
+                }
+            }
+        } else {
+            // Colored differences: perturb every column of one color together. 
+            // No two of them touch the same row, so each row's change belongs to exactly one column. 
+            const nrpy_odiegm_sparsity *p = dydt->sparsity;
+            for (int color = 0; color < p->number_of_colors; color++) {
+                for (int n = 0; n < number_of_equations; n++) {
+                    y_insert[n] = y[n];
+                    if (p->color[n] == color) {
+                        y_insert[n] = y[n] + sqrt(DBL_EPSILON*fmax(1.0e-5, fabs(y[n])));
+                        delta_column[n] = y_insert[n] - y[n];
+                    }
+                }
+                dydt->function(x, y_insert, f_shifted, dydt->params);
+                for (int m = 0; m < number_of_equations; m++) {
+                    if (p->color[m] != color) {
+                        continue;
+                    }
+                    for (int k = p->column_start[m]; k < p->column_start[m+1]; k++) {
+                        int n = p->row_index[k];
+                        jacobian[p->csr_position[k]] = (f_shifted[n] - f_initial[n])/delta_column[m];
+                    }
+                }
+            }
+        }
+
+        for (int n = 0; n < number_of_equations; n++) {
+            y_insert[n] = y[n];
+        }
+        double delta = sqrt(DBL_EPSILON*fmax(1.0e-5, fabs(x)));
+        dydt->function(x + delta, y_insert, f_shifted, dydt->params);
+        for (int n = 0; n < number_of_equations; n++) {
+            dfdx[n] = (f_shifted[n] - f_initial[n])/delta;
+        }
+    }
+
+    s->jacobian_count++;
+    s->jacobian_current = true;
+    s->jacobian_refresh = false;
+    s->lu_h_gamma = 0.0; // Any LU decomposition we had was built from the old Jacobian. 
+}
+
+int nrpy_odiegm_lu_decompose (int dimension, double * restrict matrix, int * restrict pivots) {
+    // In-place LU decomposition with partial pivoting of a row-major dimension x dimension matrix. 
+    // L (unit diagonal, not stored) and U end up packed in the matrix, pivots records the row swaps. 
+    // Returns 1 if the matrix is singular, 0 otherwise. 
+    for (int k = 0; k < dimension; k++) {
+        int pivot = k;
+        double biggest = fabs(matrix[k*dimension + k]);
+        for (int m = k+1; m < dimension; m++) {
+            if (fabs(matrix[m*dimension + k]) > biggest) {
+                biggest = fabs(matrix[m*dimension + k]);
+                pivot = m;
+            }
+        }
+        pivots[k] = pivot;
+        if (biggest == 0.0) {
+            return 1;
+        }
+        if (pivot != k) {
+            for (int j = 0; j < dimension; j++) {
+                double swap = matrix[k*dimension + j];
+                matrix[k*dimension + j] = matrix[pivot*dimension + j];
+                matrix[pivot*dimension + j] = swap;
+            }
+        }
+        double inverse_pivot = 1.0/matrix[k*dimension + k];
+        for (int m = k+1; m < dimension; m++) {
+            double factor = matrix[m*dimension + k]*inverse_pivot;
+            matrix[m*dimension + k] = factor;
+            for (int j = k+1; j < dimension; j++) {
+                matrix[m*dimension + j] = matrix[m*dimension + j] - factor*matrix[k*dimension + j];
+            }
+        }
+    }
+    return 0;
+}
+
+void nrpy_odiegm_lu_solve (int dimension, const double * restrict lu, const int * restrict pivots,
+                           double * restrict b) {
+    // Solves A x = b using the output of nrpy_odiegm_lu_decompose. x overwrites b. 
+    for (int k = 0; k < dimension; k++) {
+        if (pivots[k] != k) {
+            double swap = b[k];
+            b[k] = b[pivots[k]];
+            b[pivots[k]] = swap;
+        }
+    }
+    for (int m = 1; m < dimension; m++) {
+        for (int j = 0; j < m; j++) {
+            b[m] = b[m] - lu[m*dimension + j]*b[j];
+        }
+    }
+    for (int m = dimension-1; m >= 0; m--) {
+        for (int j = m+1; j < dimension; j++) {
+            b[m] = b[m] - lu[m*dimension + j]*b[j];
+        }
+        b[m] = b[m]/lu[m*dimension + m];
+    }
+}
+
+int nrpy_odiegm_band_lu_decompose (int dimension, int lower, int upper,
+                                   double * restrict band, int * restrict pivots) {
+    // Same as nrpy_odiegm_lu_decompose, but for a banded matrix in band storage: 
+    // element (i,j) lives at band[i*width + j-i+lower], width = 2*lower+upper+1. 
+    // The extra lower diagonals hold the fill-in that pivoting pushes into U. 
+    // Rows are only swapped from column k on, so L has to be applied with the swaps interleaved, 
+    // which nrpy_odiegm_band_lu_solve does. 
+    int width = 2*lower + upper + 1;
+    for (int k = 0; k < dimension; k++) {
+        int last_row = (k + lower < dimension-1) ? k + lower : dimension-1;
+        int last_column = (k + upper + lower < dimension-1) ? k + upper + lower : dimension-1;
+        int pivot = k;
+        double biggest = fabs(band[k*width + lower]);
+        for (int m = k+1; m <= last_row; m++) {
+            if (fabs(band[m*width + k-m+lower]) > biggest) {
+                biggest = fabs(band[m*width + k-m+lower]);
+                pivot = m;
+            }
+        }
+        pivots[k] = pivot;
+        if (biggest == 0.0) {
+            return 1;
+        }
+        if (pivot != k) {
+            for (int j = k; j <= last_column; j++) {
+                double swap = band[k*width + j-k+lower];
+                band[k*width + j-k+lower] = band[pivot*width + j-pivot+lower];
+                band[pivot*width + j-pivot+lower] = swap;
+            }
+        }
+        double inverse_pivot = 1.0/band[k*width + lower];
+        for (int m = k+1; m <= last_row; m++) {
+            double factor = band[m*width + k-m+lower]*inverse_pivot;
+            band[m*width + k-m+lower] = factor;
+            for (int j = k+1; j <= last_column; j++) {
+                band[m*width + j-m+lower] = band[m*width + j-m+lower] - factor*band[k*width + j-k+lower];
+            }
+        }
+    }
+    return 0;
+}
+
+void nrpy_odiegm_band_lu_solve (int dimension, int lower, int upper, const double * restrict band,
+                                const int * restrict pivots, double * restrict b) {
+    // Solves A x = b using the output of nrpy_odiegm_band_lu_decompose. x overwrites b. 
+    int width = 2*lower + upper + 1;
+    for (int k = 0; k < dimension; k++) {
+        if (pivots[k] != k) {
+            double swap = b[k];
+            b[k] = b[pivots[k]];
+            b[pivots[k]] = swap;
+        }
+        int last_row = (k + lower < dimension-1) ? k + lower : dimension-1;
+        for (int m = k+1; m <= last_row; m++) {
+            b[m] = b[m] - band[m*width + k-m+lower]*b[k];
+        }
+    }
+    for (int m = dimension-1; m >= 0; m--) {
+        int last_column = (m + upper + lower < dimension-1) ? m + upper + lower : dimension-1;
+        for (int j = m+1; j <= last_column; j++) {
+            b[m] = b[m] - band[m*width + j-m+lower]*b[j];
+        }
+        b[m] = b[m]/band[m*width + lower];
+    }
+}
+
+void nrpy_odiegm_jacobian_vector (const nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                  const double v[], double Jv[]) {
+    // J*v at the point stored by nrpy_odiegm_jacobian_eval, without ever forming J: 
+    // a finite difference of the function along v. One function call. 
+    // The perturbation is sqrt(machine epsilon) relative to the size of y, the usual choice for JFNK. 
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict y_insert = s->krylov_work;
+    double y_norm = 0.0;
+    double v_norm = 0.0;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_norm = y_norm + s->krylov_y[n]*s->krylov_y[n];
+        v_norm = v_norm + v[n]*v[n];
+    }
+    if (v_norm == 0.0) {
+        for (int n = 0; n < number_of_equations; n++) {
+            Jv[n] = 0.0;
+        }
+        return;
+    }
+    double delta = sqrt(DBL_EPSILON)*(1.0 + sqrt(y_norm))/sqrt(v_norm);
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = s->krylov_y[n] + delta*v[n];
+    }
+    dydt->function(s->krylov_x, y_insert, Jv, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        Jv[n] = (Jv[n] - s->krylov_f[n])/delta;
+    }
+}
+
+int nrpy_odiegm_gmres_solve (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                             double h_gamma, double * restrict b) {
+    // Solves (I - h_gamma*J) x = b by restarted GMRES, right-preconditioned with the system's 
+    // preconditioner if it has one. x overwrites b. 
+    // Stops once the residual has dropped by krylov_tolerance, returns 1 if it never gets there 
+    // (b then holds the best answer found) or if the preconditioner fails. 
+    int number_of_equations = (int)(dydt->dimension);
+    int m = s->krylov_dimension;
+    double * restrict V = s->krylov_basis; // Vector i is V + i*number_of_equations. 
+    double * restrict z = s->krylov_work + number_of_equations;
+    double * restrict solution = s->krylov_work + 2*number_of_equations;
+    double H[m+1][m]; // The Hessenberg matrix, turned upper triangular by Givens rotations as we go. 
+    double rotation_cos[m];
+    double rotation_sin[m];
+    double g[m+1]; // The residual's coordinates in the Krylov basis. 
+
+    double b_norm = 0.0;
+    for (int n = 0; n < number_of_equations; n++) {
+        solution[n] = 0.0;
+        b_norm = b_norm + b[n]*b[n];
+    }
+    b_norm = sqrt(b_norm);
+    if (b_norm == 0.0) {
+        return 0;
+    }
+    double target = s->krylov_tolerance*b_norm;
+
+    for (int restart = 0; restart <= s->krylov_max_restarts; restart++) {
+        // Residual of the current solution. The first time around it's just b. 
+        double beta = 0.0;
+        if (restart == 0) {
+            for (int n = 0; n < number_of_equations; n++) {
+                V[n] = b[n];
+            }
+        } else {
+            nrpy_odiegm_jacobian_vector(s, dydt, solution, V);
+            for (int n = 0; n < number_of_equations; n++) {
+                V[n] = b[n] - (solution[n] - h_gamma*V[n]);
+            }
+        }
+        for (int n = 0; n < number_of_equations; n++) {
+            beta = beta + V[n]*V[n];
+        }
+        beta = sqrt(beta);
+        if (beta <= target) {
+            break;
+        }
+        for (int n = 0; n < number_of_equations; n++) {
+            V[n] = V[n]/beta;
+        }
+        g[0] = beta;
+
+        int k = 0; // How many basis vectors we end up using. 
+        for (int j = 0; j < m; j++) {
+            double *v_j = V + j*number_of_equations;
+            double *v_next = V + (j+1)*number_of_equations;
+            for (int n = 0; n < number_of_equations; n++) {
+                z[n] = v_j[n];
+            }
+            if (dydt->preconditioner != NULL) {
+                if (dydt->preconditioner(s->krylov_x, s->krylov_y, h_gamma, z, dydt->params) != 0) {
+                    return 1;
+                }
+            }
+            nrpy_odiegm_jacobian_vector(s, dydt, z, v_next);
+            for (int n = 0; n < number_of_equations; n++) {
+                v_next[n] = z[n] - h_gamma*v_next[n];
+            }
+            s->krylov_iterations++;
+
+            // Modified Gram-Schmidt against everything before it. 
+            for (int i = 0; i <= j; i++) {
+                const double *v_i = V + i*number_of_equations;
+                H[i][j] = 0.0;
+                for (int n = 0; n < number_of_equations; n++) {
+                    H[i][j] = H[i][j] + v_next[n]*v_i[n];
+                }
+                for (int n = 0; n < number_of_equations; n++) {
+                    v_next[n] = v_next[n] - H[i][j]*v_i[n];
+                }
+            }
+            double next_norm = 0.0;
+            for (int n = 0; n < number_of_equations; n++) {
+                next_norm = next_norm + v_next[n]*v_next[n];
+            }
+            next_norm = sqrt(next_norm);
+            H[j+1][j] = next_norm;
+            if (next_norm != 0.0) {
+                for (int n = 0; n < number_of_equations; n++) {
+                    v_next[n] = v_next[n]/next_norm;
+                }
+            }
+
+            // Rotate the new column to keep H upper triangular, the residual falls out for free. 
+            for (int i = 0; i < j; i++) {
+                double swap = rotation_cos[i]*H[i][j] + rotation_sin[i]*H[i+1][j];
+                H[i+1][j] = -rotation_sin[i]*H[i][j] + rotation_cos[i]*H[i+1][j];
+                H[i][j] = swap;
+            }
+            double radius = hypot(H[j][j], H[j+1][j]);
+            if (radius == 0.0 || isfinite(radius) == false) {
+                break; // Nothing more to gain from this basis. 
+            }
+            rotation_cos[j] = H[j][j]/radius;
+            rotation_sin[j] = H[j+1][j]/radius;
+            H[j][j] = radius;
+            H[j+1][j] = 0.0;
+            g[j+1] = -rotation_sin[j]*g[j];
+            g[j] = rotation_cos[j]*g[j];
+            k = j+1;
+            if (fabs(g[j+1]) <= target || next_norm == 0.0) {
+                break;
+            }
+        }
+
+        // Back substitution for the coefficients, then add their combination to the solution. 
+        double coefficients[m];
+        for (int i = k-1; i >= 0; i--) {
+            coefficients[i] = g[i];
+            for (int l = i+1; l < k; l++) {
+                coefficients[i] = coefficients[i] - H[i][l]*coefficients[l];
+            }
+            coefficients[i] = coefficients[i]/H[i][i];
+        }
+        for (int n = 0; n < number_of_equations; n++) {
+            z[n] = 0.0;
+            for (int i = 0; i < k; i++) {
+                z[n] = z[n] + coefficients[i]*V[i*number_of_equations + n];
+            }
+        }
+        if (dydt->preconditioner != NULL) {
+            if (dydt->preconditioner(s->krylov_x, s->krylov_y, h_gamma, z, dydt->params) != 0) {
+                return 1;
+            }
+        }
+        for (int n = 0; n < number_of_equations; n++) {
+            solution[n] = solution[n] + z[n];
+        }
+        if (k == 0) {
+            break; // We didn't get anywhere, restarting won't help either. 
+        }
+        if (fabs(g[k]) <= target) {
+            for (int n = 0; n < number_of_equations; n++) {
+                b[n] = solution[n];
+            }
+            return 0;
+        }
+    }
+
+    for (int n = 0; n < number_of_equations; n++) {
+        b[n] = solution[n];
+    }
+    return 1;
+}
+
+int nrpy_odiegm_iteration_matrix (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt, double h_gamma) {
+    // Builds I - h*gamma*J from the stored Jacobian and decomposes it. 
+    // This is the expensive part of an implicit step, so callers only do it when they have to. 
+    // Sparse systems get a band LU sized from the pattern's bandwidth instead of a dense one. 
+    // Matrix-free, there's nothing to build: GMRES just needs to know h*gamma. 
+    // Returns 1 if the matrix is singular. 
+    if (s->krylov_dimension > 0) {
+        s->lu_h_gamma = h_gamma;
+        return 0;
+    }
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict lu = s->lu;
+    const double * restrict jacobian = s->jacobian;
+    int singular;
+    if (dydt->sparsity != NULL) {
+        const nrpy_odiegm_sparsity *p = dydt->sparsity;
+        int width = 2*p->lower_bandwidth + p->upper_bandwidth + 1;
+        for (int n = 0; n < number_of_equations*width; n++) {
+            lu[n] = 0.0;
+        }
+        for (int m = 0; m < number_of_equations; m++) {
+            for (int k = p->row_start[m]; k < p->row_start[m+1]; k++) {
+                lu[m*width + p->column_index[k]-m+p->lower_bandwidth] = -h_gamma*jacobian[k];
+            }
+            lu[m*width + p->lower_bandwidth] = lu[m*width + p->lower_bandwidth] + 1.0;
+        }
+        s->lu_count++;
+        singular = nrpy_odiegm_band_lu_decompose(number_of_equations, p->lower_bandwidth, 
+                                                 p->upper_bandwidth, lu, s->pivots);
+    } else {
+        for (int n = 0; n < number_of_equations*number_of_equations; n++) {
+            lu[n] = -h_gamma*jacobian[n];
+        }
+        for (int n = 0; n < number_of_equations; n++) {
+            lu[n*number_of_equations + n] = lu[n*number_of_equations + n] + 1.0;
+        }
+        s->lu_count++;
+        singular = nrpy_odiegm_lu_decompose(number_of_equations, lu, s->pivots);
+    }
+    if (singular != 0) {
+        s->lu_h_gamma = 0.0;
+        return 1;
+    }
+    s->lu_h_gamma = h_gamma;
+    return 0;
+}
+
+int nrpy_odiegm_iteration_solve (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt, 
+                                 double * restrict b) {
+    // Solves (I - h*gamma*J) x = b with whichever decomposition nrpy_odiegm_iteration_matrix made, 
+    // or with GMRES if we're matrix-free. Returns 1 if GMRES didn't converge. 
+    if (s->krylov_dimension > 0) {
+        return nrpy_odiegm_gmres_solve(s, dydt, s->lu_h_gamma, b);
+    }
+    if (dydt->sparsity != NULL) {
+        nrpy_odiegm_band_lu_solve((int)(dydt->dimension), dydt->sparsity->lower_bandwidth, 
+                                  dydt->sparsity->upper_bandwidth, s->lu, s->pivots, b);
+    } else {
+        nrpy_odiegm_lu_solve((int)(dydt->dimension), s->lu, s->pivots, b);
+    }
+    return 0;
+}
+
+int nrpy_odiegm_rosenbrock_step (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                 double x, double step, const double y[],
+                                 double y_new[], double y_embedded[]) {
+    // One Rosenbrock step from (x, y), see the table layout in nrpy_odiegm.h. 
+    // Linearly implicit: every stage is one linear solve with the same matrix, no Newton iteration. 
+    // The price is that J is part of the method, so it must be evaluated at (x, y) and the 
+    // matrix must be rebuilt whenever the step changes. 
+    // Returns 1 if the step couldn't be taken (singular matrix or a non-finite result). 
+    int number_of_equations = (int)(dydt->dimension);
+    int columns = s->type->columns;
+    int stages = columns - 1;
+    const double *table = (const double *)s->type->butcher;
+    // table[row*columns + column], the same void pointer dance as everywhere else. 
+    double gamma = table[(2*stages+1)*columns];
+
+    if (s->jacobian_current == false) {
+        nrpy_odiegm_jacobian_eval(dydt, s, x, y);
+    }
+    if (s->lu_h_gamma != step*gamma) {
+        if (nrpy_odiegm_iteration_matrix(s, dydt, step*gamma) != 0) {
+            return 1;
+        }
+    }
+
+    double *work = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, (stages + 2)*(size_t)number_of_equations);
+    double (*U)[number_of_equations] = (double (*)[number_of_equations]) work; // The stage values. 
+    double *y_insert = work + stages*number_of_equations;
+    double *dy_out = work + (stages + 1)*number_of_equations;
+    const double * restrict dfdx = s->dfdx;
+
+    for (int j = 0; j < stages; j++) {
+        const double *a_row = table + j*columns;
+        const double *c_row = table + (stages + j)*columns;
+        for (int n = 0; n < number_of_equations; n++) {
+            y_insert[n] = y[n];
+            for (int k = 0; k < j; k++) {
+                y_insert[n] = y_insert[n] + a_row[k+1]*U[k][n];
+            }
+        }
+        dydt->function(x + a_row[0]*step, y_insert, dy_out, dydt->params);
+        for (int n = 0; n < number_of_equations; n++) {
+            double coupling = 0.0;
+            for (int k = 0; k < j; k++) {
+                coupling = coupling + c_row[k+1]*U[k][n];
+            }
+            U[j][n] = step*gamma*(dy_out[n] + coupling/step + step*c_row[0]*dfdx[n]);
+            // Multiplying through by h*gamma turns (I/(h*gamma) - J) into the (I - h*gamma*J) we store. 
+        }
+        if (nrpy_odiegm_iteration_solve(s, dydt, U[j]) != 0) {
+            return 1; // Only happens matrix-free. An inaccurate stage would spoil the whole step. 
+        }
+    }
+
+    const double *solution_row = table + 2*stages*columns;
+    const double *error_row = table + (2*stages + 1)*columns;
+    bool finite = true;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n];
+        y_embedded[n] = 0.0;
+        for (int j = 0; j < stages; j++) {
+            y_new[n] = y_new[n] + solution_row[j+1]*U[j][n];
+            y_embedded[n] = y_embedded[n] + error_row[j+1]*U[j][n];
+        }
+        y_embedded[n] = y_new[n] - y_embedded[n];
+        finite = finite && isfinite(y_new[n]);
+    }
+    if (finite == false) {
+        return 1;
+    }
+    return 0;
+}
+
+int nrpy_odiegm_esdirk_step (nrpy_odiegm_step * s, const nrpy_odiegm_control * c,
+                             const nrpy_odiegm_system * dydt,
+                             double x, double step, const double y[],
+                             double y_new[], double y_embedded[]) {
+    // One ESDIRK step from (x, y). The first stage is explicit, every other stage is solved 
+    // with a simplified Newton iteration that uses the iteration matrix I - h*gamma*J. 
+    // Since J only steers the Newton iteration (it isn't part of the answer), it can be old, 
+    // and the LU decomposition can be reused as long as h*gamma hasn't changed much. 
+    // A fresh Jacobian is only evaluated when Newton struggles. 
+    // Returns 1 if Newton couldn't converge even with a fresh Jacobian. 
+    int number_of_equations = (int)(dydt->dimension);
+    int columns = s->type->columns;
+    int stages = columns - 1;
+    const double *table = (const double *)s->type->butcher;
+    double gamma = table[columns + 2]; // The diagonal, read off the second stage. 
+    double h_gamma = step*gamma;
+
+    int max_newton_iterations = 10;
+    double newton_tolerance = 0.03;
+    // Newton stops once the remaining correction is a few percent of the allowed error. 
+    double lu_reuse_tolerance = 0.2;
+    // An LU built for an h*gamma within 20% of the current one is still good enough for Newton. 
+
+    if (s->jacobian_count == 0 || (s->jacobian_refresh == true && s->jacobian_current == false)) {
+        // Either we've never had a Jacobian, or the last step's Newton iterations 
+        // converged slowly enough that the old one is probably going stale. 
+        nrpy_odiegm_jacobian_eval(dydt, s, x, y);
+    }
+    if (s->lu_h_gamma == 0.0 || fabs(h_gamma/s->lu_h_gamma - 1.0) > lu_reuse_tolerance) {
+        if (nrpy_odiegm_iteration_matrix(s, dydt, h_gamma) != 0) {
+            return 1;
+        }
+    }
+
+    double *work = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, (stages + 5)*(size_t)number_of_equations);
+    // On the heap like the Krylov basis, so matrix-free mode really is O(dimension*krylov_dimension). 
+    double (*F)[number_of_equations] = (double (*)[number_of_equations]) work; // The derivative at every stage. 
+    double *z = work + stages*number_of_equations; // The explicit part of the stage equation. 
+    double *Y = work + (stages + 1)*number_of_equations; // The stage value Newton is solving for. 
+    double *delta = work + (stages + 2)*number_of_equations;
+    double *y_insert = work + (stages + 3)*number_of_equations;
+    double *dy_out = work + (stages + 4)*number_of_equations;
+
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n];
+    }
+    dydt->function(x, y_insert, F[0], dydt->params);
+
+    for (int j = 1; j < stages; j++) {
+        const double *row = table + j*columns;
+        double x_stage = x + row[0]*step;
+        for (int n = 0; n < number_of_equations; n++) {
+            z[n] = y[n];
+            for (int k = 0; k < j; k++) {
+                z[n] = z[n] + step*row[k+1]*F[k][n];
+            }
+            Y[n] = z[n] + h_gamma*F[j-1][n]; // Starting guess. 
+        }
+
+        bool converged = false;
+        double previous_norm = 0.0;
+        for (int iteration = 0; iteration < max_newton_iterations; iteration++) {
+            for (int n = 0; n < number_of_equations; n++) {
+                y_insert[n] = Y[n];
+            }
+            dydt->function(x_stage, y_insert, dy_out, dydt->params);
+            for (int n = 0; n < number_of_equations; n++) {
+                delta[n] = z[n] + h_gamma*dy_out[n] - Y[n];
+            }
+            nrpy_odiegm_iteration_solve(s, dydt, delta);
+            // If GMRES fell short we still use what it found (inexact Newton), 
+            // the convergence test below decides whether it was good enough. 
+
+            double norm = 0.0;
+            for (int n = 0; n < number_of_equations; n++) {
+                Y[n] = Y[n] + delta[n];
+                double error_scale = c->abs_lim + c->rel_lim*fabs(y[n]);
+                if (c->abs_lim_vector != NULL) {
+                    error_scale = c->abs_lim_vector[n] + c->rel_lim_vector[n]*fabs(y[n]);
+                }
+                // Scaled by where the step started, not by the iterate: an iterate that has 
+                // run off to infinity would otherwise declare its own corrections small. 
+                norm = norm + (delta[n]/error_scale)*(delta[n]/error_scale);
+            }
+            norm = sqrt(norm/number_of_equations);
+
+            if (isfinite(norm) == false) {
+                break;
+            }
+            if (norm <= newton_tolerance) {
+                converged = true;
+                break;
+            }
+            if (iteration > 0) {
+                double rate = norm/previous_norm;
+                if (rate >= 1.0) {
+                    break; // Diverging, no point continuing. 
+                }
+                if (rate > 0.5) {
+                    s->jacobian_refresh = true; // Still converging, but slowly. Refresh next step. 
+                }
+                if (rate/(1.0 - rate)*norm <= newton_tolerance) {
+                    converged = true;
+                    break;
+                    // The standard estimate of how far the iteration still is from the answer. 
+                }
+            }
+            previous_norm = norm;
+        }
+
+        if (converged == false) {
+            if (s->jacobian_current == false) {
+                // Maybe it's just an old Jacobian. Get a fresh one and redo this stage. 
+                nrpy_odiegm_jacobian_eval(dydt, s, x, y);
+                if (nrpy_odiegm_iteration_matrix(s, dydt, h_gamma) != 0) {
+                    return 1;
+                }
+                j--;
+                continue;
+            }
+            return 1;
+            // Even a fresh Jacobian didn't help, the step is too big. 
+        }
+
+        for (int n = 0; n < number_of_equations; n++) {
+            F[j][n] = (Y[n] - z[n])/h_gamma;
+            // Read the derivative off the stage equation instead of calling the function again. 
+            // This is also more robust for stiff components. 
+        }
+    }
+
+    const double *solution_row = table + stages*columns;
+    const double *embedded_row = table + (stages + 1)*columns;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n];
+        y_embedded[n] = y[n];
+        for (int j = 0; j < stages; j++) {
+            y_new[n] = y_new[n] + step*solution_row[j+1]*F[j][n];
+            y_embedded[n] = y_embedded[n] + step*embedded_row[j+1]*F[j][n];
+        }
+    }
+    return 0;
+}
+
+int nrpy_odiegm_extrapolation_step (nrpy_odiegm_step * s, const nrpy_odiegm_control * c,
+                                    const nrpy_odiegm_system * dydt,
+                                    double x, double step, const double y[],
+                                    double y_new[], double y_embedded[]) {
+    // One Gragg-Bulirsch-Stoer step from (x, y). Every column j takes the step with the 
+    // modified midpoint method in n_j substeps, whose error is a series in even powers of 
+    // the substep, so extrapolating the columns to zero substep (Aitken-Neville) gains 
+    // two orders per column. y_new is the fully extrapolated answer from the last column, 
+    // y_embedded the one from a column fewer, like an embedded pair. 
+    // Afterwards the number of columns for the next step is picked the way Hairer and Wanner's 
+    // ODEX does: whichever column would have reached the tolerance with the least work per unit step. 
+    int number_of_equations = (int)(dydt->dimension);
+    int max_columns = s->type->columns;
+    const double *sequence = (const double *)s->type->butcher;
+
+    if (s->extrapolation_table == NULL) {
+        s->extrapolation_table = (double *) malloc (max_columns * number_of_equations * sizeof (double));
+        s->extrapolation_work = (double *) malloc ((4*max_columns + 1) * number_of_equations * sizeof (double));
+    }
+    if (s->extrapolation_columns == 0) {
+        // Starting guess from the tolerance, also ODEX's: roughly one column per 1.7 digits. 
+        double tolerance = c->rel_lim;
+        if (tolerance <= 0.0) {
+            tolerance = c->abs_lim;
+        }
+        s->extrapolation_columns = (int)(-log10(tolerance + 1.0e-40)*0.6 + 1.5);
+    }
+    if (s->extrapolation_columns > max_columns) {
+        s->extrapolation_columns = max_columns;
+    }
+    if (s->extrapolation_columns < 2) {
+        s->extrapolation_columns = 2;
+    }
+    int columns = s->extrapolation_columns;
+    s->extrapolation_columns_used = columns;
+
+    double * restrict table = s->extrapolation_table;
+    double * restrict f_start = s->extrapolation_work;
+    // Every sequence starts with the same derivative, so it's only evaluated once. 
+    double *scratch = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, 2*(size_t)number_of_equations);
+    double * restrict y_insert = scratch;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n];
+    }
+    dydt->function(x, y_insert, f_start, dydt->params);
+
+    // The midpoint sequences don't depend on each other at all. 
+    // A system that takes several points at once gets them in lockstep: substep m of every 
+    // sequence that's long enough is one batched call. 
+    if (dydt->batch_function != NULL) {
+        double *lane_z[columns];
+        double *lane_f[columns];
+        double lane_x[columns];
+        for (int j = 0; j < columns; j++) {
+            double * restrict z_previous = s->extrapolation_work + (4*j + 1)*number_of_equations;
+            double * restrict z = z_previous + number_of_equations;
+            double substep = step/(int)sequence[j];
+            for (int n = 0; n < number_of_equations; n++) {
+                z_previous[n] = y[n];
+                z[n] = y[n] + substep*f_start[n];
+            }
+        }
+        int longest = (int)sequence[columns - 1];
+        for (int m = 1; m < longest; m++) {
+            int lanes = 0;
+            for (int j = 0; j < columns; j++) {
+                int substeps = (int)sequence[j];
+                if (m >= substeps) {
+                    continue;
+                }
+                double * restrict z = s->extrapolation_work + (4*j + 2)*number_of_equations;
+                double * restrict z_insert = z + number_of_equations;
+                for (int n = 0; n < number_of_equations; n++) {
+                    z_insert[n] = z[n];
+                }
+                lane_x[lanes] = x + m*(step/substeps);
+                lane_z[lanes] = z_insert;
+                lane_f[lanes] = z_insert + number_of_equations;
+                lanes++;
+            }
+            nrpy_odiegm_evaluate_batch(dydt, lanes, lane_x, lane_z, lane_f);
+            for (int j = 0; j < columns; j++) {
+                int substeps = (int)sequence[j];
+                if (m >= substeps) {
+                    continue;
+                }
+                double * restrict z_previous = s->extrapolation_work + (4*j + 1)*number_of_equations;
+                double * restrict z = z_previous + number_of_equations;
+                const double * restrict f = z + 2*number_of_equations;
+                double substep = step/substeps;
+                for (int n = 0; n < number_of_equations; n++) {
+                    double z_next = z_previous[n] + 2.0*substep*f[n];
+                    z_previous[n] = z[n];
+                    z[n] = z_next;
+                }
+            }
+        }
+    } else {
+        // Otherwise each sequence is one loop. The longest ones go first 
+        // so the threads finish at about the same time. 
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic,1) num_threads(s->extrapolation_threads) if(s->extrapolation_threads > 1)
+#endif
+        for (int j = columns - 1; j >= 0; j--) {
+            double * restrict z_previous = s->extrapolation_work + (4*j + 1)*number_of_equations;
+            double * restrict z = z_previous + number_of_equations;
+            double * restrict z_insert = z + number_of_equations;
+            double * restrict f = z_insert + number_of_equations;
+            int substeps = (int)sequence[j];
+            double substep = step/substeps;
+
+            for (int n = 0; n < number_of_equations; n++) {
+                z_previous[n] = y[n];
+                z[n] = y[n] + substep*f_start[n];
+            }
+            for (int m = 1; m < substeps; m++) {
+                for (int n = 0; n < number_of_equations; n++) {
+                    z_insert[n] = z[n];
+                }
+                dydt->function(x + m*substep, z_insert, f, dydt->params);
+                for (int n = 0; n < number_of_equations; n++) {
+                    double z_next = z_previous[n] + 2.0*substep*f[n];
+                    z_previous[n] = z[n];
+                    z[n] = z_next;
+                }
+            }
+            // No smoothing step: with an even number of substeps the expansion is already in h^2. 
+        }
+    }
+
+    // Now extrapolate, one column at a time so we can see how the error falls with every column. 
+    // After adding column j, table row l holds the answer extrapolated j-l times, 
+    // so row 0 is the best we have and row 1 the one before it. 
+    double column_ratio[columns];
+    double column_work[columns];
+    double * restrict yerr = scratch + number_of_equations;
+    double work = 2.0; // f(x,y) above and the error limiter evolve_apply evaluates. 
+    for (int j = 0; j < columns; j++) {
+        const double *z = s->extrapolation_work + (4*j + 2)*number_of_equations;
+        for (int n = 0; n < number_of_equations; n++) {
+            table[j*number_of_equations + n] = z[n];
+        }
+        for (int l = j; l > 0; l--) {
+            double ratio = sequence[j]/sequence[l-1];
+            double factor = 1.0/(ratio*ratio - 1.0);
+            for (int n = 0; n < number_of_equations; n++) {
+                double newer = table[l*number_of_equations + n];
+                table[(l-1)*number_of_equations + n] = newer + (newer - table[(l-1)*number_of_equations + n])*factor;
+            }
+        }
+        work = work + sequence[j] - 1.0;
+        column_ratio[j] = 0.0;
+        column_work[j] = 0.0;
+        if (j > 0) {
+            for (int n = 0; n < number_of_equations; n++) {
+                yerr[n] = fabs(table[n] - table[number_of_equations + n])*c->error_safety;
+            }
+            column_ratio[j] = nrpy_odiegm_error_ratio(c, number_of_equations, step, yerr, table, f_start);
+            // The step this column would have needed to just meet the tolerance. 
+            // Only growth is limited (the same way evolve_apply limits it): a column that's 
+            // far off should look as expensive as it really is. 
+            double step_factor = c->max_step_adjustment;
+            if (column_ratio[j] > 0.0) {
+                step_factor = c->scale_factor*pow(column_ratio[j], -1.0/(2.0*j + 1.0));
+            }
+            if (step_factor > c->max_step_adjustment) {
+                step_factor = c->max_step_adjustment;
+            }
+            column_work[j] = work/step_factor;
+        }
+    }
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = table[n];
+        y_embedded[n] = table[number_of_equations + n];
+    }
+
+    // Pick the columns for next time. Fewer if a lower column was cheaper, 
+    // one more if the last column was clearly the cheapest (it might keep getting better). 
+    // There's nothing to compare the first column's error against, so it never counts. 
+    int best = columns - 1;
+    for (int j = columns - 2; j >= 1; j--) {
+        if (column_work[j] < column_work[best]) {
+            best = j;
+        }
+    }
+    if (best == columns - 1 && (columns == 2 || column_work[columns - 1] < 0.9*column_work[columns - 2])) {
+        s->extrapolation_columns = columns + 1;
+    } else {
+        s->extrapolation_columns = best + 1;
+    }
+    if (s->extrapolation_columns > max_columns) {
+        s->extrapolation_columns = max_columns;
+    }
+    if (s->extrapolation_columns < 2) {
+        s->extrapolation_columns = 2;
+    }
+    return 0;
+}
+
+int nrpy_odiegm_nystrom_first_order (double x, double y[], double dydx[], void *params) {
+    // A second order system written as a first order one, y' = v and v' = f(x, y), 
+    // for the few things that need one (the first step estimate). params is the nrpy_odiegm_system_nystrom. 
+    const nrpy_odiegm_system_nystrom *dydt = (const nrpy_odiegm_system_nystrom *)params;
+    int dimension = (int)(dydt->dimension);
+    for (int n = 0; n < dimension; n++) {
+        dydx[n] = y[dimension + n];
+    }
+    return dydt->function(x, y, dydx + dimension, dydt->params);
+}
+
+int nrpy_odiegm_nystrom_step (nrpy_odiegm_step * s, const nrpy_odiegm_system_nystrom * dydt,
+                              double x, double step, const double y[],
+                              double y_new[], double y_embedded[], double f_last[]) {
+    // A single Runge-Kutta-Nystrom step. y, y_new and y_embedded hold y followed by y'. 
+    // The stages only ever build y, y' just shows up in the final sums, so every stage 
+    // moves half the data the same method would on the doubled first order system. 
+    // y_embedded is filled in if it isn't NULL and the method has an embedded solution. 
+    // Returns 1 if the last stage was f at the new point, which is then left in f_last, 0 if not. 
+    int dimension = (int)(dydt->dimension);
+    int rows = s->type->rows;
+    int columns = s->type->columns;
+    int stages = columns - 1;
+    const double *butcher = (const double *)s->type->butcher;
+    // butcher[row*columns + column], see the bottom of nrpy_odiegm.h for the layout. 
+    const double * restrict position = y;
+    const double * restrict velocity = y + dimension;
+    double *work = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, (stages + 1)*(size_t)dimension);
+    double (*k)[dimension] = (double (*)[dimension]) work;
+    double *y_stage = work + stages*dimension;
+
+    // If the last step ended with f at exactly this point, that's our first stage. 
+    // (Checked, since the user is free to change y between steps.)
+    bool reuse = (s->fsal_valid == true && s->fsal_x == x && butcher[0] == 0.0);
+    for (int n = 0; n < dimension && reuse == true; n++) {
+        if (s->fsal_y[n] != position[n]) {
+            reuse = false;
+        }
+    }
+    if (reuse == true) {
+        for (int n = 0; n < dimension; n++) {
+            k[0][n] = s->fsal_f[n];
+        }
+    } else {
+        for (int n = 0; n < dimension; n++) {
+            y_stage[n] = position[n] + butcher[0]*step*velocity[n];
+        }
+        dydt->function(x + butcher[0]*step, y_stage, k[0], dydt->params);
+    }
+
+    for (int i = 1; i < stages; i++) {
+        const double *a = butcher + i*columns;
+        for (int n = 0; n < dimension; n++) {
+            double sum = 0.0;
+            for (int j = 0; j < i; j++) {
+                sum = sum + a[j+1]*k[j][n];
+            }
+            y_stage[n] = position[n] + a[0]*step*velocity[n] + step*step*sum;
+        }
+        dydt->function(x + a[0]*step, y_stage, k[i], dydt->params);
+    }
+
+    // The solution, and the embedded one if we want it. 
+    int solutions = 1;
+    if (y_embedded != NULL && rows >= stages + 4) {
+        solutions = 2;
+    }
+    for (int m = 0; m < solutions; m++) {
+        const double *position_weight = butcher + (stages + 2*m)*columns + 1;
+        const double *velocity_weight = butcher + (stages + 2*m + 1)*columns + 1;
+        double * restrict y_out = y_new;
+        if (m == 1) {
+            y_out = y_embedded;
+        }
+        for (int n = 0; n < dimension; n++) {
+            double position_sum = 0.0;
+            double velocity_sum = 0.0;
+            for (int j = 0; j < stages; j++) {
+                position_sum = position_sum + position_weight[j]*k[j][n];
+                velocity_sum = velocity_sum + velocity_weight[j]*k[j][n];
+            }
+            y_out[n] = position[n] + step*velocity[n] + step*step*position_sum;
+            y_out[dimension + n] = velocity[n] + step*velocity_sum;
+        }
+    }
+
+    // Was the last stage f at the new point? It is if it sits at c = 1 with the solution's weights. 
+    const double *last = butcher + (stages - 1)*columns;
+    const double *position_weight = butcher + stages*columns + 1;
+    if (last[0] != 1.0 || position_weight[stages - 1] != 0.0) {
+        return 0;
+    }
+    for (int j = 0; j < stages - 1; j++) {
+        if (last[j+1] != position_weight[j]) {
+            return 0;
+        }
+    }
+    for (int n = 0; n < dimension; n++) {
+        f_last[n] = k[stages - 1][n];
+    }
+    return 1;
+}
+
+int nrpy_odiegm_split_step (nrpy_odiegm_step * s, const nrpy_odiegm_system_split * dydt,
+                            double x, double step, double y[]) {
+    // A single step of a symplectic splitting method, in place. y is q followed by p. 
+    // Drifts move q using dq/dx at the current p, kicks move p using dp/dx at the current q. 
+    int dimension = (int)(dydt->dimension);
+    int columns = s->type->columns;
+    const double *butcher = (const double *)s->type->butcher;
+    const double *drift = butcher; // Row 0. 
+    const double *kick = butcher + columns; // Row 1. 
+    double * restrict q = y;
+    double * restrict p = y + dimension;
+    double *work = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, 3*(size_t)dimension);
+    double *dqdx = work;
+    double *dpdx = work + dimension;
+    double *y_insert = work + 2*dimension;
+    // The user's functions get a copy, same as everywhere else, in case they clamp their input. 
+
+    // Every method here ends on a drift, and the next step starts with one at the same p, 
+    // so dq/dx carries over. (Checked, since the user is free to change y between steps.) 
+    bool reuse = (s->fsal_valid == true && s->fsal_x == x);
+    for (int n = 0; n < dimension && reuse == true; n++) {
+        if (s->fsal_y[n] != p[n]) {
+            reuse = false;
+        }
+    }
+    bool dqdx_current = false;
+    if (reuse == true) {
+        for (int n = 0; n < dimension; n++) {
+            dqdx[n] = s->fsal_f[n];
+        }
+        dqdx_current = true;
+    }
+
+    double position = x;
+    for (int i = 0; i < columns; i++) {
+        if (drift[i] != 0.0) {
+            if (dqdx_current == false) {
+                for (int n = 0; n < dimension; n++) {
+                    y_insert[n] = p[n];
+                }
+                dydt->position_derivative(position, y_insert, dqdx, dydt->params);
+                dqdx_current = true;
+            }
+            for (int n = 0; n < dimension; n++) {
+                q[n] = q[n] + drift[i]*step*dqdx[n];
+            }
+            position = position + drift[i]*step;
+        }
+        if (kick[i] != 0.0) {
+            for (int n = 0; n < dimension; n++) {
+                y_insert[n] = q[n];
+            }
+            dydt->momentum_derivative(position, y_insert, dpdx, dydt->params);
+            for (int n = 0; n < dimension; n++) {
+                p[n] = p[n] + kick[i]*step*dpdx[n];
+            }
+            dqdx_current = false;
+        }
+    }
+
+    s->fsal_valid = dqdx_current;
+    s->fsal_x = x + step;
+    for (int n = 0; n < dimension && dqdx_current == true; n++) {
+        s->fsal_y[n] = p[n];
+        s->fsal_f[n] = dqdx[n];
+    }
+    return 0;
+}
+
+double nrpy_odiegm_spectral_radius (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt) {
+    // Estimates the biggest eigenvalue (in magnitude) of the stored Jacobian with a few rounds of 
+    // power iteration. It doesn't need to be accurate, it only has to tell stiff from not stiff. 
+    // Matrix-free, each round costs a function call instead. 
+    int number_of_equations = (int)(dydt->dimension);
+    const double * restrict jacobian = s->jacobian;
+    const nrpy_odiegm_sparsity *p = dydt->sparsity;
+    double *v = nrpy_odiegm_step_work(&s->method_work, &s->method_work_size, 2*(size_t)number_of_equations);
+    double *w = v + number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        v[n] = 1.0/sqrt((double)number_of_equations);
+    }
+    double radius = 0.0;
+    for (int iteration = 0; iteration < 10; iteration++) {
+        if (s->krylov_dimension > 0) {
+            nrpy_odiegm_jacobian_vector(s, dydt, v, w);
+        } else {
+            for (int m = 0; m < number_of_equations; m++) {
+                w[m] = 0.0;
+                if (p != NULL) {
+                    for (int k = p->row_start[m]; k < p->row_start[m+1]; k++) {
+                        w[m] = w[m] + jacobian[k]*v[p->column_index[k]];
+                    }
+                } else {
+                    for (int n = 0; n < number_of_equations; n++) {
+                        w[m] = w[m] + jacobian[m*number_of_equations + n]*v[n];
+                    }
+                }
+            }
+        }
+        double norm = 0.0;
+        for (int m = 0; m < number_of_equations; m++) {
+            norm = norm + w[m]*w[m];
+        }
+        norm = sqrt(norm);
+        if (norm == 0.0 || isfinite(norm) == false) {
+            return radius;
+        }
+        radius = norm; // v always has length 1, so this is |Jv|/|v|. 
+        for (int n = 0; n < number_of_equations; n++) {
+            v[n] = w[n]/norm;
+        }
+    }
+    return radius;
+}
+
+void nrpy_odiegm_step_switch_type (nrpy_odiegm_step * s, const nrpy_odiegm_step_type * T) {
+    // Swaps the method a step "object" uses, mid-run. Works out the method type the same way 
+    // nrpy_odiegm_step_alloc does. Adams-Bashforth methods can't be switched to this way. 
+    s->type = T;
+    s->rows = T->rows;
+    s->columns = T->columns;
+    s->method_type = 1;
+    if (T->rows == T->columns) {
+        s->method_type = 0;
+    }
+    if (T->method_type != 0) {
+        s->method_type = T->method_type;
+    }
+    s->stiff_count = 0;
+    s->nonstiff_count = 0;
+    s->switch_count++;
+}
+
+void nrpy_odiegm_stiffness_check (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                  double x, const double y[], double h_lambda) {
+    // Called after every accepted step when stiffness switching is on. 
+    // h_lambda estimates how far out the step pushed the stiffest mode, if it's past the edge 
+    // of the explicit method's stability region, the explicit method is wasting its steps. 
+    // Same rules as Hairer's DOPRI5: 15 stiff-looking steps in a row means the problem is stiff, 
+    // 6 non-stiff steps in a row clear the count. We switch to the implicit method on the first, 
+    // and back to the explicit method on the second if we're currently implicit. 
+    // A negative h_lambda means there was no estimate this step. 
+    if (s->stiff_type == NULL || h_lambda < 0.0) {
+        return;
+    }
+    if (h_lambda > s->stiffness_threshold) {
+        s->stiff_count++;
+        s->nonstiff_count = 0;
+    } else {
+        s->nonstiff_count++;
+        if (s->nonstiff_count >= 6) {
+            s->stiff_count = 0;
+        }
+    }
+
+    if (s->method_type < 3 && s->stiff_count >= 15) {
+        nrpy_odiegm_step_switch_type(s, s->stiff_type);
+        nrpy_odiegm_jacobian_eval(dydt, s, x, y);
+        // Start the implicit method off with a Jacobian from right here, 
+        // not one left over from the last time things were stiff. 
+    } else if ((s->method_type == 3 || s->method_type == 4) && s->nonstiff_count >= 6) {
+        nrpy_odiegm_step_switch_type(s, s->nonstiff_type);
+    }
+}
 
-// The actual stepping functions follow. 
+int nrpy_odiegm_low_storage_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
+                                   nrpy_odiegm_step * s,
+                                   const nrpy_odiegm_system * dydt, double *t,
+                                   double t1, double *h, double y[]) {
+    // nrpy_odiegm_evolve_apply for the low-storage methods, which it hands them to straight away, 
+    // before it sets up any of its own (stage-sized) arrays. These take the step they're given. 
+    // y is updated in place, and the only other state-sized arrays touched are the running stage 
+    // combination dq (the step "object"'s register) and f, which lives in fsal_f. 
+    // The function is handed y itself rather than a copy, to save one more. 
+    // e->y0 isn't filled in, copying the answer there would cost as much bandwidth as a stage. 
+    int number_of_equations = (int)(dydt->dimension);
+    int columns = s->type->columns;
+    int stages = columns - 1;
+    const double *butcher = (const double *)s->type->butcher;
+    const double *A = butcher;
+    const double *B = butcher + columns;
+    const double *stage_position = butcher + 2*columns;
+
+    if (s->low_storage_registers == NULL) {
+        s->low_storage_registers = (double *) malloc (number_of_equations * sizeof (double));
+    }
+    double * restrict dq = s->low_storage_registers;
+    double * restrict f = s->fsal_f;
 
-// The goal is for these functions to be completely agnostic to whatever the user is doing, 
-// they should always work regardless of the form of the system passed, the method passed, and even
-// if the user does something dumb it shouldn't crash. It will spit out nonsense in those cases, though. 
+    if (*h <= 0.0) {
+        *h = nrpy_odiegm_initial_step(dydt, c, s, *t, y);
+    }
+    if (*t + *h > t1) {
+        *h = t1 - *t;
+        e->last_step = 1.0;
+    }
+    double current_position = *t;
+    e->current_position = current_position;
+    if (e->count == 0) {
+        e->bound = current_position;
+    }
+    double step = *h;
+
+    for (int i = 0; i < stages; i++) {
+        dydt->function(current_position + stage_position[i]*step, y, f, dydt->params);
+        double A_i = A[i];
+        double B_i = B[i];
+        if (i == 0) {
+            for (int n = 0; n < number_of_equations; n++) {
+                dq[n] = step*f[n];
+                y[n] = y[n] + B_i*dq[n];
+            }
+        } else {
+            for (int n = 0; n < number_of_equations; n++) {
+                dq[n] = A_i*dq[n] + step*f[n];
+                y[n] = y[n] + B_i*dq[n];
+            }
+        }
+    }
+    s->fsal_valid = false; // f is the last stage's, not f at the new point. 
+
+    current_position = current_position + step;
+    *t = current_position;
+    e->current_position = current_position;
+    e->count = e->count + 1;
+    return 0;
+}
 
 int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                              nrpy_odiegm_step * s,
@@ -145,7 +2184,22 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                              double t1, double *h, double y[]) {
     // This is the big one, the function that ACTUALLY performs the step.
 
-    // First off, check if we're at the desired edge or not. 
+    if (s->method_type == 8) {
+        return nrpy_odiegm_low_storage_apply(e, c, s, dydt, t, t1, h, y);
+        // The low-storage methods are for systems too big for anything below. 
+    }
+
+    // If we were never given a real step (hstart <= 0), estimate one before anything uses it.
+    bool check_first_step = false;
+    if (*h <= 0.0) {
+        *h = nrpy_odiegm_initial_step(dydt, c, s, *t, y);
+        check_first_step = true;
+        // The first step is normally taken on faith, since the user picked it for a reason. 
+        // An estimated step has no such excuse (and can be far too big on a stiff problem), 
+        // so it goes through error control like any other. 
+    }
+
+    // First off, check if we're at the desired edge or not.
     if (*t + *h > t1) {
         *h = t1 - *t;
         // If we're going past an endpoint we want, reduce the step size. 
@@ -176,12 +2230,7 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
     int columns = s->type->columns;
     int adams_bashforth_order = s->adams_bashforth_order;
 
-    double absolute_error_limit = c->abs_lim;
-    double relative_error_limit = c->rel_lim;
     double scale_factor = c->scale_factor;
-    double error_safety = c->error_safety;
-    double ay_error_scaler = c->ay_error_scaler;
-    double ady_error_scaler = c->ady_error_scaler;
     double max_step_adjustment = c-> max_step_adjustment;
     double min_step_adjustment = c->min_step_adjustment;
     double absolute_max_step = c->absolute_max_step;
@@ -189,30 +2238,23 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
     double error_upper_tolerance = c->error_upper_tolerance;
     double error_lower_tolerance = c->error_lower_tolerance;
 
-    double y_values[number_of_equations][adams_bashforth_order];
+    double (*y_values)[(adams_bashforth_order > 0) ? adams_bashforth_order : 1] = s->y_values;
+    // The AB method's past values, y_values[n][m] is equation n, m steps ago. 
+    // Worked on in place, it's number_of_equations*adams_bashforth_order long, too much for the stack. 
+
+    double stiffness_h_lambda = -1.0; // Stiffness estimate for automatic switching, -1 if there isn't one. 
 
     int counter = 0; // This counter is reused time and time again for sifting through memory
     // Allow me to express my dislike of void pointers. 
 
     // The following section only runs if we're using an AB method, otherwise it jumps over. 
-    if (adams_bashforth_order != 0) {
-        if (i == 0) {
-            // First time initialization of the y_values array for AB methods. 
-            for (int n = 0; n< number_of_equations; n++) {
-                y_values[n][0] = y[n];
-                for (int m = 1; m < adams_bashforth_order; m++) {
-                    y_values[n][m] = 0; // These values shouldn't be used, but zero them anyway. 
-                } 
-            }
-        } else {
-            // Load values from known y_values if not first step for AB method. 
-            for (int n = 0; n< number_of_equations; n++) {
-                for (int m = 0; m < adams_bashforth_order; m++) {
-                    y_values[n][m] = *((double *)(*s).y_values+counter); // Gotta fill in an array... joy...
-                    counter++;
-                    // This has to be done this way due to the array being passed as a void pointer. 
-                } 
-            }
+    if (adams_bashforth_order != 0 && i == 0) {
+        // First time initialization of the y_values array for AB methods. 
+        for (int n = 0; n< number_of_equations; n++) {
+            y_values[n][0] = y[n];
+            for (int m = 1; m < adams_bashforth_order; m++) {
+                y_values[n][m] = 0; // These values shouldn't be used, but zero them anyway. 
+            } 
         }
     }
 
@@ -250,17 +2292,19 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
     }
 
     if (method_type != 2) {
+        int stage_rows = (rows > columns) ? rows : columns;
+        double *work = nrpy_odiegm_step_work(&s->stage_work, &s->stage_work_size, (8 + stage_rows)*(size_t)number_of_equations);
+        // Everything below that's as long as the state, carved out of the step's scratch space. 
+        // The K-values take the last stage_rows*number_of_equations of it. 
+
         // To use adaptive time-step, we need to store data at different step values:
-        double y_big_step[number_of_equations];
-        double y_smol_steps[number_of_equations];
+        double *y_big_step = work;
+        double *y_smol_steps = work + number_of_equations;
 
         // One could argue that since the small steps will become our result 
         // we shouldn't declare it, however we are actually
         // NOT going to assign the results to the actual answer y until we compare and run the adaptive
         // time-step algorithm. We might throw out all the data and need to run it again! 
-        double error_estimate[number_of_equations];
-        // even if we aren't limiting the constants, we can still report their error. 
-        
         double original_step = step;
         // We need to be able to refer to the original step so we can 
         // see if we're adjusting it too much at once. 
@@ -283,11 +2327,111 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
         }
         // This constant removes certain components from consideraiton. 
 
+        double method_order = s->type->order;
+        if (method_type < 3) {
+            method_order = butcher[rows-1-method_type*quick_patch][0];
+        }
+        // The order used when adjusting the step. Explicit tables store it in the table itself,
+        // implicit tables are laid out differently so we use the step type's order instead. 
+
+        bool implicit_step_failed = false;
+        // Implicit methods can fail outright (Newton doesn't converge), which isn't the same as
+        // having too much error: there's no answer to check at all. 
+
+        bool check_stiffness = false;
+        if (s->stiff_type != NULL && method_type < 2 && rows-3-method_type >= 0) {
+            if (butcher[rows-2-method_type][0] == butcher[rows-3-method_type][0]) {
+                check_stiffness = true;
+            }
+        }
+        double *y_stiffness_check = work + 2*number_of_equations;
+        // If the last two stages are evaluated at the same point (DP5's are both at x+h), 
+        // the difference in their derivatives over the difference in their inputs estimates 
+        // the stiffest eigenvalue for free. This is Hairer's test from DOPRI5. 
+        // Only the first iteration is used: for step doubling that's the full step, 
+        // which is the one that runs into the stability limit first. 
+
+        bool batch_doubling = false;
+        if (dydt->batch_function != NULL && method_type == 0 && adams_bashforth_order == 0 && check_stiffness == false) {
+            batch_doubling = true;
+        }
+        // Step doubling's first two iterations both start from y, so a system that can take 
+        // several points at once gets them side by side, see nrpy_odiegm_doubling_stages. 
+        // (Not with the stiffness check, it wants the full step's last two stage inputs.) 
+
         bool floored = false;
         // This is for a check hard-coded in for if we hit the *absolute minimum* step size. 
         // We have to make sure to run the loop one more time, so rather than exiting the loop
         // we set this to true and run once more. 
 
+        double *f_start = work + 3*number_of_equations;
+        bool have_f_start = false;
+        // f at the start of the step. Every attempt at the step (and both the full step and 
+        // the first half step of step doubling) begins with it, so it's only evaluated once. 
+        // If the last step was taken by a "first same as last" method it's already known. 
+        if (s->fsal_valid == true && s->fsal_x == current_position && method_type < 3) {
+            have_f_start = true;
+            for (int n = 0; n < number_of_equations; n++) {
+                if (s->fsal_y[n] != y[n]) {
+                    have_f_start = false;
+                }
+            }
+            if (have_f_start == true) {
+                for (int n = 0; n < number_of_equations; n++) {
+                    f_start[n] = s->fsal_f[n];
+                }
+            }
+        }
+        s->fsal_valid = false;
+
+        bool first_same_as_last = false;
+        if (method_type == 1 && butcher[columns-2][0] == 1.0) {
+            first_same_as_last = true;
+            for (int n = 1; n < columns; n++) {
+                if (butcher[columns-2][n] != butcher[columns-1][n]) {
+                    first_same_as_last = false;
+                }
+            }
+        }
+        // The last stage is evaluated at x+h with exactly the weights of the solution, 
+        // so its derivative is f at the start of the next step. 
+        double *f_last = work + 4*number_of_equations;
+        double x_last = current_position;
+
+        bool keep_dense = false;
+        if (method_type == 1 && step_type->interpolant != NULL) {
+            keep_dense = true;
+            if (s->dense_k == NULL || s->dense_stages < columns) {
+                free(s->dense_y);
+                free(s->dense_k);
+                s->dense_y = (double *) malloc (number_of_equations * sizeof (double));
+                s->dense_k = (double *) malloc (columns * number_of_equations * sizeof (double));
+                s->dense_stages = columns;
+            }
+        }
+        s->dense_valid = false;
+        // Methods with an interpolant keep the accepted step's stages around for dense output. 
+
+        nrpy_odiegm_kernel kernel = step_type->kernel;
+        if (kernel == NULL) {
+            kernel = nrpy_odiegm_builtin_kernel(step_type);
+        }
+        bool use_kernel = false;
+        if (method_type == 1 && kernel != NULL && check_stiffness == false) {
+            use_kernel = true;
+        }
+        double *kernel_k = work + 8*number_of_equations;
+        // Tables with a generated kernel (see nrpy_odiegm_codegen.py) take the whole step in one call 
+        // instead of the loop over the table below. Same answer, but every stage is written out. 
+        // (Not with the stiffness check, which wants the last two stage inputs.) 
+        // The K-values go straight into the dense output if there is one. 
+
+        double *y_insert = work + 5*number_of_equations;
+        //  We also need an array for the inserted y-values for each equation. 
+
+        double *dy_out = work + 6*number_of_equations;
+        //  GSL demands that we use two separate arrays for y and y', so here's y'. 
+
         while (error_satisfactory == false) {
             
             // All of the bellow values start off thinking they are the values from the 
@@ -297,7 +2441,25 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                 y_big_step[n] = y[n];
                 y_smol_steps[n] = y[n];
             } 
-            for (int iteration = 1; iteration < 4; iteration++) {
+
+            int first_iteration = 1;
+            if (method_type >= 3) {
+                // Implicit and extrapolation methods do the whole step in one go, handing back the solution in 
+                // y_big_step and the embedded solution in y_smol_steps like an adaptive method. 
+                // The explicit loop below is skipped entirely. 
+                if (method_type == 3) {
+                    implicit_step_failed = nrpy_odiegm_rosenbrock_step(s, dydt, current_position, step, y, y_big_step, y_smol_steps);
+                } else if (method_type == 4) {
+                    implicit_step_failed = nrpy_odiegm_esdirk_step(s, c, dydt, current_position, step, y, y_big_step, y_smol_steps);
+                } else {
+                    nrpy_odiegm_extrapolation_step(s, c, dydt, current_position, step, y, y_big_step, y_smol_steps);
+                    method_order = 2*s->extrapolation_columns_used - 1;
+                    // Extrapolation changes order from step to step. The error estimate 
+                    // (a column against the one before) goes like h^(2*columns-1). 
+                }
+                first_iteration = 4;
+            }
+            for (int iteration = first_iteration; iteration < 4; iteration++) {
                 // So, we want to use Adaptive Timestep methodology. 
                 // This will involve evaluating each step three times, 
                 // In order to compare the evolution of two different 
@@ -315,7 +2477,7 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                 
                 // For AB method we only go through once, but do so with some additional operations. 
 
-                if (i == 0 && iteration == 1 && method_type == 0 && adams_bashforth_order == 0) {
+                if (i == 0 && iteration == 1 && method_type == 0 && adams_bashforth_order == 0 && check_first_step == false) {
                     // Don't take unecessary steps, if we are on the first step 
                     // and have no need for the large step, ignore it.
                     // Since we always want the first step to go through 
@@ -325,6 +2487,35 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                     // since we cheat and do it in one iteration. 
                 }
 
+                if (iteration == 1 && use_kernel == true) {
+                    // The answer lands in y_big_step and the embedded solution in y_smol_steps, 
+                    // just as if the loop below had run. 
+                    if (have_f_start == false) {
+                        for (int n = 0; n < number_of_equations; n++) {
+                            y_insert[n] = y[n];
+                        }
+                        dydt->function(current_position, y_insert, f_start, dydt->params);
+                        have_f_start = true;
+                    }
+                    double * K_kernel = kernel_k;
+                    if (keep_dense == true) {
+                        K_kernel = s->dense_k;
+                    }
+                    kernel(dydt, current_position, step, y, f_start, K_kernel, y_insert, y_big_step, y_smol_steps, f_last);
+                    x_last = current_position + butcher[columns-2][0]*step;
+                    iteration = 4;
+                    continue;
+                }
+
+                if (iteration == 1 && batch_doubling == true) {
+                    // Step doubling with a batched system: the full step and the first half step 
+                    // go together, then iteration 3 takes the second half step as usual. 
+                    nrpy_odiegm_doubling_stages(s, dydt, rows, columns, &butcher[0][0], current_position, step, y, 
+                                                f_start, &have_f_start, y_big_step, y_smol_steps);
+                    iteration = 2;
+                    continue;
+                }
+
                 double scale = 1.0;
                 // This is the number we use to scale. It's either 1 or 1/2, 
                 // Depending on what size step we want. 
@@ -342,27 +2533,16 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                 }
                 // Every time it's needed, we multiply the step by the scale. 
 
-                double K[rows-method_type*quick_patch][number_of_equations];
+                double (*K)[number_of_equations] = (double (*)[number_of_equations]) (work + 8*number_of_equations);
                 // These are the K-values that are required to evaluate RK-like methods. 
                 // They will be determined based on the provided butcher table.
                 // This is a 2D matrix since each diffyQ has its own set of K-values. 
                 // Note that we subtract the method type from the row: 
                 // adaptive RK butcher tables are larger. 
 
-                // Since we'll be calling K while it's empty, 
-                // even though there should be no errors due
-                // to the way it's set up, let's go ahead and fill it with zeroes.
-                for (int j = 0; j<rows-method_type*quick_patch; j++) {
-                    for (int n = 0; n<number_of_equations; n++) {
-                        K[j][n]=0.0;
-                    }
-                } 
-
-                double y_insert[number_of_equations];
-                //  We also need an array for the inserted y-values for each equation. 
-
-                double dy_out[number_of_equations];
-                //  GSL demands that we use two separate arrays for y and y', so here's y'. 
+                double * stage_k[columns];
+                double stage_weight[columns];
+                // The K-values (and their weights) that go into each stage, see below. 
 
                 for (int j = 1; j < rows-method_type*quick_patch; j++) {
                     // Due to the way the butcher table is formatted, 
@@ -373,46 +2553,82 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                     // just adjust the "step correction" term.
                     // x_Insert is the same for every equation, too.
 
-                    for (int n = 0; n < number_of_equations; n++) {
-                        y_insert[n] = y_smol_steps[n];
-                    } 
-                    // Note that we are setting our buffer value, y_insert, to y_smol_steps. 
-                    // This is because y_smol_steps is y at first, but we will need to evolve it
+                    // y_insert starts at y_smol_steps, which is y at first, but we will need to evolve it
                     // forward two steps, so on the second small step this will be different. 
                     // (If using a method that requires that step, otherwise this is just a formality.)
-
-                    for (int n = 1; n < columns; n++) {
+                    // Then every K-value this stage depends on is added in. Only the ones we already have 
+                    // (the table is explicit), and only those with a nonzero weight, 
+                    // all in one pass (see nrpy_odiegm_stage_combination). 
+                    int terms = 0;
+                    for (int n = 1; n < columns && n < j; n++) {
                         // Once again, start at index of 1 rather than 0.
-                        for (int q = 0; q < number_of_equations; q++) {
-                            y_insert[q] = y_insert[q] + butcher[j-1][n]*K[n][q];
+                        if (butcher[j-1][n] != 0.0) {
+                            stage_weight[terms] = butcher[j-1][n];
+                            stage_k[terms] = K[n];
+                            terms++;
                         }
-                        // Each individual y_insert portion is dependent on one of the K values.
-                        // K values are initially set to zero even though technically whenever 
-                        // we would use an undeclared K-value the butcher table would have a zero.
-                        // You know, just in case something goes wrong. 
                     }
+                    nrpy_odiegm_stage_combination(s, number_of_equations, y_smol_steps, terms, stage_weight, stage_k, y_insert);
 
                     // Now we actually evaluate the differential equations.
-                    dydt->function(x_Insert, y_insert, dy_out, dydt->params);
-                    // y_insert goes in, dy_out comes out.
+                    if (j == 1 && shift == 0 && have_f_start == true && butcher[0][0] == 0.0) {
+                        for (int n = 0; n < number_of_equations; n++) {
+                            dy_out[n] = f_start[n];
+                        }
+                        // Unless we already know the answer, see f_start above. 
+                    } else {
+                        dydt->function(x_Insert, y_insert, dy_out, dydt->params);
+                        // y_insert goes in, dy_out comes out.
+                        if (j == 1 && shift == 0 && butcher[0][0] == 0.0) {
+                            for (int n = 0; n < number_of_equations; n++) {
+                                f_start[n] = dy_out[n];
+                            }
+                            have_f_start = true;
+                        }
+                    }
 
                     for (int n = 0; n < number_of_equations; n++) {
                         K[j][n] = step*scale*dy_out[n];
                         // Fill in the K-values we just calculated. 
                     } 
+
+                    if (first_same_as_last == true && j == columns-1 && iteration == 1) {
+                        for (int n = 0; n < number_of_equations; n++) {
+                            f_last[n] = dy_out[n];
+                        }
+                        x_last = x_Insert;
+                    }
+
+                    if (check_stiffness == true && j == rows-2-method_type*quick_patch && iteration == 1) {
+                        for (int n = 0; n < number_of_equations; n++) {
+                            y_stiffness_check[n] = y_insert[n];
+                        }
+                    } else if (check_stiffness == true && j == rows-1-method_type*quick_patch && iteration == 1) {
+                        double numerator = 0.0;
+                        double denominator = 0.0;
+                        for (int n = 0; n < number_of_equations; n++) {
+                            numerator = numerator + (K[j][n] - K[j-1][n])*(K[j][n] - K[j-1][n]);
+                            denominator = denominator + (y_insert[n] - y_stiffness_check[n])*(y_insert[n] - y_stiffness_check[n]);
+                        }
+                        if (denominator > 0.0) {
+                            stiffness_h_lambda = sqrt(numerator/denominator);
+                            // The K-values already carry the step, so this is h*lambda. 
+                        }
+                    }
                 }
 
                 // Now that we have all the K-values set, we need to find 
                 // the actual result in one final loop.
-                for (int n = 0; n< number_of_equations; n++) {
-                    K[0][n] = y_smol_steps[n]; // The 0th spot in the K-values is reserved for 
-                    // holding the final value while it's being calculated. 
-                    for (int j = 1; j < columns; j++) {
-                        K[0][n] = K[0][n] + butcher[rows-1-method_type*quick_patch][j]*K[j][n]; 
-                        // This is where the actual approximation is finally performed. 
+                // This is where the actual approximation is finally performed, in place. 
+                int terms = 0;
+                for (int j = 1; j < columns; j++) {
+                    if (butcher[rows-1-method_type*quick_patch][j] != 0.0) {
+                        stage_weight[terms] = butcher[rows-1-method_type*quick_patch][j];
+                        stage_k[terms] = K[j];
+                        terms++;
                     }
-                    y_smol_steps[n] = K[0][n]; // Set ySmol to the new estimated value. 
                 }
+                nrpy_odiegm_stage_combination(s, number_of_equations, y_smol_steps, terms, stage_weight, stage_k, y_smol_steps);
                 // Note that we specifically set ySmol to the value, not anything else. 
                 // This is because we wish to avoid abusing if statements.
 
@@ -428,21 +2644,29 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                 // setting the big step to the right value
                 // and resetting the small steps for when we actually use it. 
                 // This odd structure exists purely for efficiency. 
+
+                if (keep_dense == true && iteration == 1) {
+                    for (int j = 1; j < columns; j++) {
+                        for (int n = 0; n < number_of_equations; n++) {
+                            s->dense_k[j*number_of_equations + n] = K[j][n];
+                        }
+                    }
+                }
                 
                 // If we are in an adaptive method situation, 
                 // use that method and exit the iterations loop.
                 if (method_type == 1) {
-                    for (int n = 0; n< number_of_equations; n++) {
-                        K[0][n] = y_smol_steps[n]; // The 0th spot in the K-values is reserved 
-                        // for holding the final value while it's being calculated. 
-                        for (int j = 1; j < columns; j++) {
-                            K[0][n] = K[0][n] + butcher[rows-1][j]*K[j][n]; 
-                            // This is where the actual approximation is finally performed. 
-                            // This time we use the bottom row, not the second to bottom row 
-                            // (for adaptive methods)
+                    // This time we use the bottom row, not the second to bottom row 
+                    // (for adaptive methods)
+                    terms = 0;
+                    for (int j = 1; j < columns; j++) {
+                        if (butcher[rows-1][j] != 0.0) {
+                            stage_weight[terms] = butcher[rows-1][j];
+                            stage_k[terms] = K[j];
+                            terms++;
                         }
-                        y_smol_steps[n] = K[0][n]; // Set ySmol to the new estimated value. 
                     }
+                    nrpy_odiegm_stage_combination(s, number_of_equations, y_smol_steps, terms, stage_weight, stage_k, y_smol_steps);
 
                         iteration = 4; // Break out after we get to the end, 
                         // we don't need to go any further. 
@@ -456,45 +2680,48 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                     }
                 }
             }
+            if (implicit_step_failed == true && no_adaptive_step == false && floored == false) {
+                // Nothing to estimate the error of. Cut the step as hard as we're allowed to 
+                // and try again. This counts as a fresh start for the step limits below, 
+                // otherwise they would push the step right back up. 
+                step = step * min_step_adjustment;
+                if (step < absolute_min_step) {
+                    step = absolute_min_step;
+                    floored = true;
+                }
+                original_step = step;
+                previous_step = step;
+                continue;
+            }
+
             // Now that the step and double step have been taken 
             // (or whatever alternative method is being used),
             // time to calculate some errors and see if we move on to the next step. 
             // First, from our parameters declared at the beginning, determine what our error limit is. 
             // Using GSL's version we frist estimate our error based on what we know.
-            if (i != 0 && adams_bashforth_order == 0) {
+            if ((i != 0 || check_first_step == true) && adams_bashforth_order == 0) {
                 // Literally none of this is used for the AB method. 
+                double error_safety = c->error_safety;
+                double * restrict yerr = e->yerr;
                 for (int n = 0; n<number_of_equations; n++) {
-                    error_estimate[n] = sqrt((y_big_step[n] - y_smol_steps[n])*(y_big_step[n] - y_smol_steps[n]))* error_safety;
+                    yerr[n] = fabs(y_big_step[n] - y_smol_steps[n])*error_safety;
                     // The 4/15 for error_safety is taken from GSL's solver, a 'saftey factor' 
                     // with unknown reasoning. 
                 }
 
-                double error_limiter[number_of_equations];
+                double *error_limiter = work + 7*number_of_equations;
                 // Since the definition of the error limiter uses a derivative, 
                 // we cannot use it to limit the constant's error. 
                 // We originally had the error limiter set its own values. 
                 // GSL's formatting requries us to change this. 
 
-                    dydt->function(current_position+step,y_smol_steps, error_limiter, dydt->params);
-
-                // Now SmolSteps is used to set the error_limiter. 
-                for (int n = 0; n<number_of_equations; n++) {
-                    error_limiter[n] = absolute_error_limit + relative_error_limit*(ay_error_scaler*sqrt(y_smol_steps[n]*y_smol_steps[n]) + ady_error_scaler*step*sqrt(error_limiter[n]*error_limiter[n]));
-                }
-                // The error limiter is set for every equation. Now we need to perform checks.
-
+                // Now SmolSteps and its derivative (sitting in error_limiter) go to the error kernel,
+                // which boils every component's error down to a single ratio of error to desired error. 
+                // Fixed steps never look at the ratio, so they skip it (and the function call it costs). 
                 double ratio_ED = 0.0;
-                for (int n = 0; n<number_of_equations; n++) { 
-                    if (ratio_ED < error_estimate[n]/error_limiter[n]) {
-                        ratio_ED = error_estimate[n]/error_limiter[n];
-                        // pick out the largest of these ratios for use, every time. 
-                    }
-                }
-
-                counter = 0;
-                for (int n = 0; n< number_of_equations; n++) {
-                    *((double *)(*e).yerr+counter) = error_estimate[n]; // Gotta fill in an array... joy...
-                    counter++;
+                if (no_adaptive_step == false) {
+                    dydt->function(current_position+step,y_smol_steps, error_limiter, dydt->params);
+                    ratio_ED = nrpy_odiegm_error_ratio(c, number_of_equations, step, yerr, y_smol_steps, error_limiter);
                 }
 
                 under_error = false;
@@ -526,10 +2753,10 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
 
                     // These if statements perform step adjustment if needed. Based on GSL's algorithm. 
                     else if (over_error == true) {
-                        step = step * scale_factor * pow(ratio_ED,-1.0/butcher[rows-1-method_type*quick_patch][0]);
+                        step = step * scale_factor * pow(ratio_ED,-1.0/method_order);
                     } else { // If under_error is true and over_error is false 
                         //is the only way to get here. The true-true situation is skipped.
-                        step = step * scale_factor * pow(ratio_ED,-1.0/(butcher[rows-1-method_type*quick_patch][0]+1));
+                        step = step * scale_factor * pow(ratio_ED,-1.0/(method_order+1));
                         error_satisfactory = true;
                     }
 
@@ -578,9 +2805,19 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
             }
         }
         
+        if (keep_dense == true) {
+            for (int n = 0; n < number_of_equations; n++) {
+                s->dense_y[n] = y[n];
+            }
+            s->dense_x = current_position;
+            s->dense_type = step_type;
+            s->dense_valid = true;
+            // dense_h is set below, once we know which step we actually took. 
+        }
+
         // Finally, we actually update the real answer. 
         for (int n = 0; n<number_of_equations; n++) {
-            if (method_type == 1) {
+            if (method_type == 1 || method_type >= 3) {
                 y[n]=y_big_step[n];
             } else {
                 y[n]=y_smol_steps[n];
@@ -589,6 +2826,30 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
             // There may be a more efficient way to do this. 
         }
 
+        if ((method_type == 3 || method_type == 4) && s->stiff_type != NULL) {
+            // Implicit methods have no stages to compare, but they do have the Jacobian. 
+            double step_taken = step;
+            if (under_error == true) {
+                step_taken = previous_step;
+            }
+            stiffness_h_lambda = step_taken*nrpy_odiegm_spectral_radius(s, dydt);
+        }
+
+        if (keep_dense == true) {
+            s->dense_h = step;
+            if (under_error == true) {
+                s->dense_h = previous_step;
+            }
+        }
+        if (first_same_as_last == true) {
+            for (int n = 0; n < number_of_equations; n++) {
+                s->fsal_y[n] = y[n];
+                s->fsal_f[n] = f_last[n];
+            }
+            s->fsal_x = x_last;
+            s->fsal_valid = true;
+        }
+
         if (under_error == true) {
             current_position = current_position + previous_step;
             // If we had an under_error and increased the step size, 
@@ -631,10 +2892,11 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
         // This is normally where we would calulate the K values, 
         // but they are entirely unecessary here.
 
-        double y_insert[number_of_equations];
+        double *work = nrpy_odiegm_step_work(&s->stage_work, &s->stage_work_size, 2*(size_t)number_of_equations);
+        double *y_insert = work;
         // We also need an array for the inserted y-values for each equation. 
 
-        double dy_out[number_of_equations];
+        double *dy_out = work + number_of_equations;
         // GSL demands that we use two separate arrays for y and y', so here's y'. 
 
         double x_Insert; // This is generally going to be rather simple. 
@@ -694,31 +2956,293 @@ int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
     *t = current_position;
     e->current_position = current_position;
     e->count = i+1;
+    s->jacobian_current = false; // We've moved, so any stored Jacobian is now an old one. 
 
-    // Update y_values, very important. We spent all that time shifting everything, 
-    // we need to be able to access it next time this function is called! 
-    counter = 0;
-
-    if (adams_bashforth_order != 0) {
-        // Put the new y_values back into the stored array. 
-        for (int n = 0; n< number_of_equations; n++) {
-            for (int m = 0; m < adams_bashforth_order; m++) {
-                *((double *)(*s).y_values+counter) = y_values[n][m]; // Gotta fill in an array... joy...
-                counter++;
-            } 
-        }
+    if (s->stiff_type != NULL) {
+        nrpy_odiegm_stiffness_check(s, dydt, current_position, y, stiffness_h_lambda);
+        // This may change the method for the next step. 
     }
 
     // In case the user needs it for some reason we also save the result to the evolve object.
+    // (Unless there's nowhere to put it, see nrpy_odiegm_driver_alloc_gridfunctions.)
     counter = 0;
-    for (int n = 0; n< number_of_equations; n++) {
-        *((double *)(*e).y0+counter) = y[n]; // Gotta fill in an array... joy...
-        counter++;
+    if (e->y0 != NULL) {
+        for (int n = 0; n< number_of_equations; n++) {
+            *((double *)(*e).y0+counter) = y[n]; // Gotta fill in an array... joy...
+            counter++;
+        }
     }
 
     return 0;                      
 }
 
+int nrpy_odiegm_evolve_dense_output (const nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                     double x, double y_out[]) {
+    // Fills y_out with the solution at x, anywhere inside the last accepted step, 
+    // from that step's stages and the method's interpolant. No function evaluations. 
+    // Much cheaper than cutting the step short to land on x, and doesn't disturb the step size. 
+    // Returns 1 if there's nothing to interpolate (no step yet, or a method without an interpolant). 
+    if (s->dense_valid == false || s->dense_type->interpolant == NULL) {
+        return 1;
+    }
+    int number_of_equations = (int)(dydt->dimension);
+    int columns = s->dense_type->columns;
+    int interpolant_rows = s->dense_type->interpolant_rows;
+    const double *interpolant = (const double *)s->dense_type->interpolant;
+    // interpolant[row*columns + column], same layout as the butcher tables. 
+    double theta = (x - s->dense_x)/s->dense_h;
+
+    double weight[columns];
+    for (int j = 1; j < columns; j++) {
+        weight[j] = 0.0;
+        for (int row = 0; row < interpolant_rows; row++) {
+            weight[j] = weight[j] + interpolant[row*columns + j]*pow(theta, interpolant[row*columns]);
+        }
+    }
+    for (int n = 0; n < number_of_equations; n++) {
+        y_out[n] = s->dense_y[n];
+        for (int j = 1; j < columns; j++) {
+            y_out[n] = y_out[n] + weight[j]*s->dense_k[j*number_of_equations + n];
+        }
+    }
+    return 0;
+}
+
+int nrpy_odiegm_evolve_apply_nystrom (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
+                                      nrpy_odiegm_step * s,
+                                      const nrpy_odiegm_system_nystrom * dydt, double *t,
+                                      double t1, double *h, double y[]) {
+    // nrpy_odiegm_evolve_apply for second order systems, with the Runge-Kutta-Nystrom methods. 
+    // y is y followed by y'. The step control follows nrpy_odiegm_evolve_apply's: 
+    // the same error kernel over the whole state, the same limits on how fast the step may change. 
+    int dimension = (int)(dydt->dimension);
+    int number_of_equations = 2*dimension;
+    nrpy_odiegm_system first_order = {nrpy_odiegm_nystrom_first_order, NULL, number_of_equations, (void *)dydt, NULL, NULL, NULL, NULL};
+
+    bool check_first_step = false;
+    if (*h <= 0.0) {
+        *h = nrpy_odiegm_initial_step(&first_order, c, s, *t, y);
+        check_first_step = true;
+    }
+    if (*t + *h > t1) {
+        *h = t1 - *t;
+        e->last_step = 1.0;
+    }
+
+    double current_position = *t;
+    e->current_position = current_position;
+    if (e->count == 0) {
+        e->bound = current_position;
+    }
+    double step = *h;
+    double original_step = step;
+    double next_step = step;
+    int method_order = s->type->order;
+
+    // Methods without an embedded solution (Nystrom4) always take the step they're given. 
+    // As with nrpy_odiegm_evolve_apply, so is the very first step, if the user picked it. 
+    bool adaptive = (e->no_adaptive_step == false && s->type->rows >= s->type->columns + 3);
+    bool check_error = (adaptive == true && (e->count != 0 || check_first_step == true));
+
+    double *work = nrpy_odiegm_step_work(&s->stage_work, &s->stage_work_size, 3*(size_t)number_of_equations + 2*(size_t)dimension);
+    double *y_new = work;
+    double *y_embedded = work + number_of_equations;
+    double *dydx_new = work + 2*number_of_equations;
+    double *f_last = work + 3*number_of_equations;
+    double *y_insert = f_last + dimension;
+    double * restrict yerr = e->yerr;
+    bool f_last_known = false;
+    bool floored = false;
+
+    while (true) {
+        int fsal = nrpy_odiegm_nystrom_step(s, dydt, current_position, step, y, y_new, 
+                                            (check_error == true) ? y_embedded : NULL, f_last);
+        f_last_known = (fsal == 1);
+        if (check_error == false) {
+            break;
+        }
+
+        for (int n = 0; n < number_of_equations; n++) {
+            yerr[n] = fabs(y_new[n] - y_embedded[n])*c->error_safety;
+        }
+        // The error kernel wants the derivative of the new state, which is y' and f. 
+        // The "first same as last" methods already have f, the rest pay for it here, 
+        // but either way it's the next step's first stage. 
+        if (f_last_known == false) {
+            for (int n = 0; n < dimension; n++) {
+                y_insert[n] = y_new[n];
+            }
+            dydt->function(current_position + step, y_insert, f_last, dydt->params);
+            f_last_known = true;
+        }
+        for (int n = 0; n < dimension; n++) {
+            dydx_new[n] = y_new[dimension + n];
+            dydx_new[dimension + n] = f_last[n];
+        }
+        double ratio_ED = nrpy_odiegm_error_ratio(c, number_of_equations, step, yerr, y_new, dydx_new);
+
+        if (ratio_ED > c->error_upper_tolerance && floored == false) {
+            // Too big, shrink it and try again. If we've hit the limits on how far 
+            // it may shrink, the next try is accepted no matter what. 
+            step = step * c->scale_factor * pow(ratio_ED,-1.0/method_order);
+            if (step < c->min_step_adjustment * original_step) {
+                step = c->min_step_adjustment * original_step;
+                floored = true;
+            }
+            if (step < c->absolute_min_step) {
+                step = c->absolute_min_step;
+                floored = true;
+            }
+            continue;
+        }
+        if (ratio_ED <= c->error_lower_tolerance) {
+            // Comfortably under, take this step and a bigger one next time. 
+            next_step = step * c->scale_factor * pow(ratio_ED,-1.0/(method_order+1));
+            if (next_step > c->max_step_adjustment * original_step) {
+                next_step = c->max_step_adjustment * original_step;
+            }
+        } else {
+            next_step = step;
+        }
+        if (next_step > c->absolute_max_step) {
+            next_step = c->absolute_max_step;
+        }
+        break;
+    }
+
+    for (int n = 0; n < number_of_equations; n++) {
+        y[n] = y_new[n];
+    }
+    if (e->y0 != NULL) {
+        for (int n = 0; n < number_of_equations; n++) {
+            e->y0[n] = y[n];
+        }
+    }
+    current_position = current_position + step;
+    if (f_last_known == true) {
+        s->fsal_valid = true;
+        s->fsal_x = current_position;
+        for (int n = 0; n < dimension; n++) {
+            s->fsal_y[n] = y[n];
+            s->fsal_f[n] = f_last[n];
+        }
+    }
+
+    *h = next_step;
+    *t = current_position;
+    e->current_position = current_position;
+    e->count = e->count + 1;
+    return 0;
+}
+
+int nrpy_odiegm_evolve_apply_split (nrpy_odiegm_evolve * e, nrpy_odiegm_step * s,
+                                    const nrpy_odiegm_system_split * dydt, double *t,
+                                    double t1, double *h, double y[]) {
+    // nrpy_odiegm_evolve_apply for separable Hamiltonian systems, with the symplectic methods. 
+    // y is q followed by p. Always a fixed step: changing the step from one step to the next 
+    // would throw away the bounded energy error that's the whole point of these methods. 
+    // The step is only cut short to land on t1. 
+    int number_of_equations = 2*(int)(dydt->dimension);
+    double step = *h;
+    if (*t + step > t1) {
+        step = t1 - *t;
+        e->last_step = 1.0;
+    }
+    if (e->count == 0) {
+        e->bound = *t;
+    }
+
+    nrpy_odiegm_split_step(s, dydt, *t, step, y);
+
+    if (e->y0 != NULL) {
+        for (int n = 0; n < number_of_equations; n++) {
+            e->y0[n] = y[n];
+        }
+    }
+    *t = *t + step;
+    e->current_position = *t;
+    e->count = e->count + 1;
+    return 0;
+}
+
+int nrpy_odiegm_transformed_function (double s, double y[], double dyds[], void *params) {
+    // dy/ds = f(x(s), y) dx/ds. params is the nrpy_odiegm_transform. 
+    const nrpy_odiegm_transform *T = (const nrpy_odiegm_transform *)params;
+    int status = T->sys->function(T->to_x(s, T->params), y, dyds, T->sys->params);
+    double dx_ds = T->dx_ds(s, T->params);
+    int number_of_equations = (int)(T->sys->dimension);
+    for (int n = 0; n < number_of_equations; n++) {
+        dyds[n] = dyds[n]*dx_ds;
+    }
+    return status;
+}
+
+int nrpy_odiegm_transformed_batch (int points, const double s[], double *y[], double *dyds[], void *params) {
+    // The same at several points, through the system's own batch_function. 
+    const nrpy_odiegm_transform *T = (const nrpy_odiegm_transform *)params;
+    if (points <= 0) {
+        return 0;
+    }
+    double x[points];
+    for (int p = 0; p < points; p++) {
+        x[p] = T->to_x(s[p], T->params);
+    }
+    int status = nrpy_odiegm_evaluate_batch(T->sys, points, x, y, dyds);
+    int number_of_equations = (int)(T->sys->dimension);
+    for (int p = 0; p < points; p++) {
+        double dx_ds = T->dx_ds(s[p], T->params);
+        for (int n = 0; n < number_of_equations; n++) {
+            dyds[p][n] = dyds[p][n]*dx_ds;
+        }
+    }
+    return status;
+}
+
+double nrpy_odiegm_log_to_s (double x, void *params) {
+    (void)params; // No parameters, the map is fixed. 
+    return log(x);
+}
+
+double nrpy_odiegm_log_to_x (double s, void *params) {
+    (void)params;
+    return exp(s);
+}
+
+double nrpy_odiegm_log_dx_ds (double s, void *params) {
+    (void)params;
+    return exp(s); // dx/ds = x. 
+}
+
+int nrpy_odiegm_evolve_apply_transformed (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
+                                          nrpy_odiegm_step * s, nrpy_odiegm_transform * T,
+                                          double *t, double t1, double *h, double y[]) {
+    // nrpy_odiegm_evolve_apply in s = phi(x) instead of x. *t and t1 are in x, *h is in s, 
+    // and so is everything in c (absolute_max_step and the rest), since evolve_apply only ever sees s. 
+    // Any method works. The Jacobian of the system in s is built with finite differences, 
+    // the system's own jacobian (being in x) isn't used. 
+    nrpy_odiegm_system in_s = {nrpy_odiegm_transformed_function, NULL, T->sys->dimension, (void *)T, NULL, NULL, NULL, NULL};
+    if (T->sys->batch_function != NULL) {
+        in_s.batch_function = nrpy_odiegm_transformed_batch;
+    }
+    in_s.sparsity = T->sys->sparsity; // A change of x doesn't change which y's depend on which. 
+
+    double position = T->to_s(*t, T->params);
+    if (T->have_last == true && T->last_x == *t) {
+        position = T->last_s;
+    }
+    double end = T->to_s(t1, T->params);
+    int status = nrpy_odiegm_evolve_apply(e, c, s, &in_s, &position, end, h, y);
+
+    *t = T->to_x(position, T->params);
+    if (position == end) {
+        *t = t1; // Land on t1 exactly, not wherever phi^-1(phi(t1)) is. 
+    }
+    T->have_last = true;
+    T->last_x = *t;
+    T->last_s = position;
+    return status;
+}
+
 int nrpy_odiegm_evolve_apply_fixed_step (nrpy_odiegm_evolve * e,
                                         nrpy_odiegm_control * con,
                                         nrpy_odiegm_step * step,
@@ -750,4 +3274,116 @@ int nrpy_odiegm_driver_apply_fixed_step (nrpy_odiegm_driver * d, double *t,
     nrpy_odiegm_driver_apply(d, t, h*(double)n, y);
 
     return 0;
-}
\ No newline at end of file
+}
+
+void nrpy_odiegm_parareal_coarse (nrpy_odiegm_parareal * p, double x, double slice_length, double y[]){
+    // One slice with the coarse method, in place. Fixed steps count from where the evolve "object" 
+    // started (see the end of nrpy_odiegm_evolve_apply), so it starts over at every slice, 
+    // and the slice is split into equal steps so the last one never has to be cut short. 
+    int steps = 1;
+    if (p->coarse_step > 0.0) {
+        steps = (int)ceil(slice_length/p->coarse_step - 1.0e-9);
+        if (steps < 1) {
+            steps = 1;
+        }
+    }
+    double h = slice_length/steps;
+    p->coarse_e->count = 0;
+    for (int m = 0; m < steps; m++) {
+        nrpy_odiegm_evolve_apply(p->coarse_e, p->c, p->coarse_s, p->sys, &x, x + 1.5*h, &h, y);
+    }
+}
+
+int nrpy_odiegm_parareal_apply (nrpy_odiegm_parareal * p, double *t, const double t1, double y[]){
+    // Solves from *t to t1 with Parareal, handing back the answer in y (and t1 in *t). 
+    // The solution at every slice boundary is left in p->u. 
+    // Returns 0 if the iteration converged, 1 if it ran out of iterations first. 
+    const nrpy_odiegm_system *dydt = p->sys;
+    int number_of_equations = (int)(dydt->dimension);
+    int slices = p->slices;
+    double t0 = *t;
+    double slice_length = (t1 - t0)/slices;
+
+    // Iteration 0: the coarse method alone. 
+    for (int n = 0; n < number_of_equations; n++) {
+        p->u[n] = y[n];
+    }
+    for (int j = 0; j < slices; j++) {
+        double * restrict u_end = p->u + (j + 1)*number_of_equations;
+        for (int n = 0; n < number_of_equations; n++) {
+            u_end[n] = p->u[j*number_of_equations + n];
+        }
+        nrpy_odiegm_parareal_coarse(p, t0 + j*slice_length, slice_length, u_end);
+        for (int n = 0; n < number_of_equations; n++) {
+            p->coarse[j*number_of_equations + n] = u_end[n];
+        }
+    }
+
+    p->iterations = 0;
+    p->correction = 0.0;
+    int status = 1;
+    int max_iterations = p->max_iterations;
+    if (max_iterations > slices) {
+        max_iterations = slices;
+    }
+    double delta[number_of_equations];
+    double no_derivative[number_of_equations];
+    for (int n = 0; n < number_of_equations; n++) {
+        no_derivative[n] = 0.0;
+    }
+    // The corrections are measured with the same error kernel as a step, 
+    // just with no derivative term (there's no step to scale it by). 
+
+    for (int k = 1; k <= max_iterations; k++) {
+        // The fine sweep. After k-1 iterations the first k-1 boundaries can't change any more, 
+        // so neither can the fine solves starting from them. 
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic,1) num_threads(p->threads) if(p->threads > 1)
+#endif
+        for (int j = k - 1; j < slices; j++) {
+            double * restrict f_end = p->fine + j*number_of_equations;
+            double x = t0 + j*slice_length;
+            double x_end = t0 + (j + 1)*slice_length;
+            for (int n = 0; n < number_of_equations; n++) {
+                f_end[n] = p->u[j*number_of_equations + n];
+            }
+            while (x < x_end) {
+                nrpy_odiegm_evolve_apply(p->fine_e[j], p->c, p->fine_s[j], dydt, &x, x_end, &(p->fine_h[j]), f_end);
+            }
+        }
+
+        // The coarse sweep, which has to be serial: every slice starts where the last one's 
+        // corrected answer ended. New boundary = new coarse + (fine - old coarse). 
+        p->correction = 0.0;
+        for (int j = k - 1; j < slices; j++) {
+            double * restrict u_end = p->u + (j + 1)*number_of_equations;
+            double coarse_end[number_of_equations];
+            for (int n = 0; n < number_of_equations; n++) {
+                coarse_end[n] = p->u[j*number_of_equations + n];
+            }
+            nrpy_odiegm_parareal_coarse(p, t0 + j*slice_length, slice_length, coarse_end);
+            for (int n = 0; n < number_of_equations; n++) {
+                double corrected = coarse_end[n] + p->fine[j*number_of_equations + n] - p->coarse[j*number_of_equations + n];
+                delta[n] = fabs(corrected - u_end[n]);
+                u_end[n] = corrected;
+                p->coarse[j*number_of_equations + n] = coarse_end[n];
+            }
+            double ratio = nrpy_odiegm_error_ratio(p->c, number_of_equations, 0.0, delta, u_end, no_derivative);
+            if (ratio > p->correction) {
+                p->correction = ratio;
+            }
+        }
+        p->iterations = k;
+        if (p->correction <= p->tolerance) {
+            status = 0;
+            break;
+        }
+    }
+
+    for (int n = 0; n < number_of_equations; n++) {
+        y[n] = p->u[slices*number_of_equations + n];
+    }
+    *t = t1;
+    return status;
+}
+
@@ -3,6 +3,8 @@
 
 #include <string.h>
 // This #include is not usually part of Odie, it's here to process ETK inputs. 
+#include "tov_trajectory.h"
+// Neither is this, it's how the solution gets to tov_interp.c. 
 
 // This file is technically not part of Odie, it is just an example implementation.
 // However, it is exceptionally versatile, and can be used to run virtually 
@@ -15,11 +17,87 @@
 double EOS_table_values_nabber(double T_initial, double **logrho, double **logpres, double **logeps, int *array_size);
 // fancy C++ prototype for interfacing with EOS_Omni
 
+TOVOdieGM_trajectory TOVOdieGM_solution = {0, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+
+void TOVOdieGM_trajectory_reserve(TOVOdieGM_trajectory *t, int capacity)
+{
+    if (capacity <= t->capacity) {
+        return;
+    }
+    double **columns[7] = {&t->r_Schw, &t->rho, &t->rho_baryon, &t->P, &t->M, &t->nu, &t->rbar};
+    for (int n = 0; n < 7; n++) {
+        double *grown = (double *)realloc(*columns[n], sizeof(double)*capacity);
+        if (grown == NULL) {
+            CCTK_VWarn(CCTK_WARN_ABORT, __LINE__, __FILE__, CCTK_THORNSTRING,
+                       "Could not allocate room for %d points of the TOV solution.", capacity);
+        }
+        *columns[n] = grown;
+    }
+    t->capacity = capacity;
+}
+
+void TOVOdieGM_trajectory_append(TOVOdieGM_trajectory *t, double r_Schw, double rho, double rho_baryon,
+                                 double P, double M, double nu, double rbar)
+{
+    if (t->length == t->capacity) {
+        // Out of room, so double it. The number of steps is only known once we're done. 
+        TOVOdieGM_trajectory_reserve(t, (t->capacity == 0) ? 1024 : 2*t->capacity);
+    }
+    t->r_Schw[t->length] = r_Schw;
+    t->rho[t->length] = rho;
+    t->rho_baryon[t->length] = rho_baryon;
+    t->P[t->length] = P;
+    t->M[t->length] = M;
+    t->nu[t->length] = nu;
+    t->rbar[t->length] = rbar;
+    t->length++;
+}
+
+int TOVOdieGM_trajectory_write_binary(const char *filename, const TOVOdieGM_trajectory *t)
+{
+    // The binary profile format, see tov_trajectory.h: the header, then each quantity in turn. 
+    FILE *fp = fopen(filename,"wb");
+    if (fp == NULL) {
+        return 1;
+    }
+    int64_t header[2] = {t->length, 7};
+    const double *columns[7] = {t->r_Schw, t->rho, t->rho_baryon, t->P, t->M, t->nu, t->rbar};
+    size_t written = fwrite(TOVODIEGM_BINARY_MAGIC, 1, 8, fp);
+    written += fwrite(header, sizeof(int64_t), 2, fp);
+    for (int n = 0; n < 7; n++) {
+        written += fwrite(columns[n], sizeof(double), t->length, fp);
+    }
+    fclose(fp);
+    return (written == 10 + 7*(size_t)t->length) ? 0 : 1;
+}
+
+static void save_line(FILE *fp2, double r, double rho, double rho_baryon, const double y[], const double yerr[])
+{
+    // One point of the solution: into memory for interp_main, and into the data file if there is one. 
+    // The order of y is pressure, nu, mass, rbar. 
+    TOVOdieGM_trajectory_append(&TOVOdieGM_solution, r, rho, rho_baryon, y[0], y[2], y[1], y[3]);
+    if (fp2 != NULL) {
+        fprintf(fp2,"%15.14e %15.14e %15.14e %15.14e %15.14e %15.14e %15.14e ", r, rho, rho_baryon, 
+        			y[0], y[2], y[1], y[3]);
+        if (yerr != NULL) {
+            fprintf(fp2, "%15.14e %15.14e %15.14e %15.14e ",yerr[0],yerr[1],yerr[2],yerr[3]); 
+        }
+        fprintf(fp2,"\n");
+    }
+}
+
 void nrpy_odiegm_main(CCTK_ARGUMENTS)
 {
     // declare values needed by ETK. 
     DECLARE_CCTK_PARAMETERS
     printf("Beginning ODE Solver \"Odie\" V10...\n");
+
+    if (strlen(TOVOdieGM_profile_file) > 0) {
+        // interp_main reads the solution from there, there's nothing to solve. 
+        printf("Using the TOV solution in '%s' instead.\n",TOVOdieGM_profile_file);
+        printf("ODE Solver \"Odie\" V10 Shutting Down...\n");
+        return;
+    }
     
     // Before anything, get the tables read. 
     // They are declared in the user_method.c file so they can be used there. 
@@ -40,6 +118,7 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
     // in nrpy_odiegm_user_methods.c
 
     double step = TOVOdieGM_step; // the "step" value. Initial step if using an adaptive method.
+    // Set it to zero (or anything negative) and Odie will estimate a good initial step itself. 
     double current_position = 0.0; // where the boundary/initial condition is. 
     // Same for every equation in the system.
     int number_of_equations = 4; // How many equations are in our system?
@@ -52,6 +131,9 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
     // If we are not using the AB method this is set to 0 later automatically. 4 by default. 
     bool no_adaptive_step = TOVOdieGM_no_adaptive_step; // Sometimes we just want to step forward uniformly 
     // without using GSL's awkward setup. False by default. 
+    bool enthalpy_formulation = TOVOdieGM_enthalpy_formulation; // Do the star in pseudo-enthalpy instead of radius? 
+    double enthalpy_step = TOVOdieGM_enthalpy_step; // The step for that, if the method doesn't adapt it. 
+    bool logarithmic_position = TOVOdieGM_log_radius; // Step in ln(r) instead of r? 
 
     // bool report_error_actual = TOVOdieGM_report_error_actual; // not possible in this implementation. 
     bool report_error_estimates = TOVOdieGM_report_error_estimates;
@@ -66,13 +148,18 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
     // Note: there are a lot more error control numbers that can be set inside the 
     // control "object" (struct) d->c.
     
+    // The solution is kept in memory for interp_main, the data file is only for people to look at. 
     //Since C doesn't have strings we have to work around this. 
     //We do this by opening the file early, but doing it directly. 
-    FILE *fp2;
-    fp2 = fopen(TOVOdieGM_file_name,"w");
-    printf("Printing to file '%s'.\n",TOVOdieGM_file_name);
-
-    // Open the file we'll be writing data to. 
+    FILE *fp2 = NULL;
+    bool write_binary = (TOVOdieGM_write_file == true && strcmp(TOVOdieGM_file_format,"binary") == 0);
+    if (TOVOdieGM_write_file == true && write_binary == false) {
+        fp2 = fopen(TOVOdieGM_file_name,"w");
+        printf("Printing to file '%s'.\n",TOVOdieGM_file_name);
+    }
+    // A binary file is written in one go at the end, from memory. 
+    TOVOdieGM_solution.length = 0;
+    // Start over, in case we're solving again (e.g. once per refinement level). The room stays. 
 
     // Now we set up the method. 
     
@@ -115,6 +202,8 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
 	    step_type = nrpy_odiegm_step_DP6;
 	} else if (strcmp("L6",TOVOdieGM_step_type) == 0) {
 	    step_type = nrpy_odiegm_step_L6;
+	} else if (strcmp("Vern6",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_Vern6;
 	} else if (strcmp("DP8",TOVOdieGM_step_type) == 0) {
 	    step_type = nrpy_odiegm_step_DP8;
 	} else if (strcmp("AHE",TOVOdieGM_step_type) == 0) {
@@ -129,6 +218,20 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
 	    step_type = nrpy_odiegm_step_ADP5;
 	} else if (strcmp("ADP8",TOVOdieGM_step_type) == 0) {
 	    step_type = nrpy_odiegm_step_ADP8;
+	} else if (strcmp("Tsit5",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_Tsit5;
+	} else if (strcmp("Vern7",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_Vern7;
+	} else if (strcmp("Vern9",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_Vern9;
+	} else if (strcmp("GBS",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_GBS;
+	} else if (strcmp("ROS3P",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_ROS3P;
+	} else if (strcmp("RODAS4",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_RODAS4;
+	} else if (strcmp("ESDIRK3",TOVOdieGM_step_type) == 0) {
+	    step_type = nrpy_odiegm_step_ESDIRK3;
 	} else if (strcmp("AB",TOVOdieGM_step_type) == 0) {
 	    step_type = nrpy_odiegm_step_AB;
 		if (strcmp("Euler",TOVOdieGM_step_type_2) == 0) {
@@ -159,6 +262,8 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
 		    step_type_2 = nrpy_odiegm_step_DP6;
 		} else if (strcmp("L6",TOVOdieGM_step_type_2) == 0) {
 		    step_type_2 = nrpy_odiegm_step_L6;
+		} else if (strcmp("Vern6",TOVOdieGM_step_type_2) == 0) {
+		    step_type_2 = nrpy_odiegm_step_Vern6;
 		} else if (strcmp("DP8",TOVOdieGM_step_type_2) == 0) {
 		    step_type_2 = nrpy_odiegm_step_DP8;
 		} else if (strcmp("AHE",TOVOdieGM_step_type_2) == 0) {
@@ -173,6 +278,12 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
 		    step_type_2 = nrpy_odiegm_step_ADP5;
 		} else if (strcmp("ADP8",TOVOdieGM_step_type_2) == 0) {
 		    step_type_2 = nrpy_odiegm_step_ADP8;
+		} else if (strcmp("Tsit5",TOVOdieGM_step_type_2) == 0) {
+		    step_type_2 = nrpy_odiegm_step_Tsit5;
+		} else if (strcmp("Vern7",TOVOdieGM_step_type_2) == 0) {
+		    step_type_2 = nrpy_odiegm_step_Vern7;
+		} else if (strcmp("Vern9",TOVOdieGM_step_type_2) == 0) {
+		    step_type_2 = nrpy_odiegm_step_Vern9;
 		} else if (strcmp("AB",TOVOdieGM_step_type_2) == 0) {
 		    step_type_2 = nrpy_odiegm_step_AB;
 		}
@@ -200,10 +311,15 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
     // nrpy_odiegm_user_methods.c manually.
     // The methods that make use of it it need to be declared as well, if they are used.
 
-    nrpy_odiegm_system system = {diffy_Q_eval,known_Q_eval,number_of_equations,&cp};
+    nrpy_odiegm_system system = {diffy_Q_eval,known_Q_eval,number_of_equations,&cp,NULL,NULL,NULL,NULL};
     // This is the system of equations we solve.
     // The second slot was originally the Jacobian in GSL, but we use it to pass a 
     // true answer function that may or may not be used.
+#ifdef TOV_RHS_SIMD
+    system.batch_function = diffy_Q_eval_batch;
+    // Only there when nrpy_odiegm_TOV_rhs.c was generated with --simd, 
+    // then several stage points get evaluated per call, SIMD_width at a time. 
+#endif
 
     nrpy_odiegm_driver *d;
     d = nrpy_odiegm_driver_alloc_y_new(&system, step_type, step, absolute_error_limit, relative_error_limit); 
@@ -226,6 +342,54 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
     d->c->error_upper_tolerance = error_upper_tolerance;
     d->c->error_lower_tolerance = error_lower_tolerance;
 
+    if (strcmp("RMS",TOVOdieGM_error_norm) == 0) {
+        d->c->error_norm = 1;
+    }
+    // Per-component error control. The components are pressure, nu, mass, and rbar, in that order. 
+    // Negative limits fall back on the scalar ones, and only if something is actually set 
+    // do we bother switching the controller over to per-component limits. 
+    // The enthalpy formulation has one more, r^2, which just gets the scalar limits. 
+    double absolute_error_limits[number_of_equations+1];
+    double relative_error_limits[number_of_equations+1];
+    bool error_mask[number_of_equations+1];
+    bool use_component_limits = false;
+    absolute_error_limits[number_of_equations] = absolute_error_limit;
+    relative_error_limits[number_of_equations] = relative_error_limit;
+    error_mask[number_of_equations] = true;
+    for (int n = 0; n < number_of_equations; n++) {
+        absolute_error_limits[n] = absolute_error_limit;
+        relative_error_limits[n] = relative_error_limit;
+        error_mask[n] = TOVOdieGM_component_error_control[n];
+        if (TOVOdieGM_component_absolute_error_limit[n] >= 0.0) {
+            absolute_error_limits[n] = TOVOdieGM_component_absolute_error_limit[n];
+            use_component_limits = true;
+        }
+        if (TOVOdieGM_component_relative_error_limit[n] >= 0.0) {
+            relative_error_limits[n] = TOVOdieGM_component_relative_error_limit[n];
+            use_component_limits = true;
+        }
+        if (error_mask[n] == false) {
+            use_component_limits = true;
+        }
+    }
+    if (use_component_limits == true) {
+        nrpy_odiegm_control_set_tolerances(d->c, number_of_equations, absolute_error_limits, relative_error_limits, error_mask);
+    }
+
+    // Stiffness switching, off unless an implicit method is named. 
+    const nrpy_odiegm_step_type * stiff_step_type = NULL;
+    if (strcmp("ROS3P",TOVOdieGM_stiff_step_type) == 0) {
+        stiff_step_type = nrpy_odiegm_step_ROS3P;
+    } else if (strcmp("RODAS4",TOVOdieGM_stiff_step_type) == 0) {
+        stiff_step_type = nrpy_odiegm_step_RODAS4;
+    } else if (strcmp("ESDIRK3",TOVOdieGM_stiff_step_type) == 0) {
+        stiff_step_type = nrpy_odiegm_step_ESDIRK3;
+    }
+    if (stiff_step_type != NULL) {
+        nrpy_odiegm_step_set_stiff_switching(d->s, stiff_step_type);
+    }
+    d->s->stiffness_threshold = TOVOdieGM_stiffness_threshold;
+
     int method_type = 1;
     if (step_type->rows == step_type->columns) {
         method_type = 0; // AKA, normal RK-type method. 
@@ -269,14 +433,131 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
     printf("Data given as radius, energy density, baryon density, pressure, mass, 2ln(lapse), polytropic radius, {estimated errors: pressure, 2ln(lapse), mass, polytropic radius}\n");
     printf("INITIAL: %15.14e %15.14e %15.14e %15.14e %15.14e %15.14e %15.14e ", current_position, c[0], TOVOdieGM_central_baryon_density, 
     			y[0], y[2], y[1], y[3]);
-    fprintf(fp2,"%15.14e %15.14e %15.14e %15.14e %15.14e %15.14e %15.14e ", current_position, c[0], TOVOdieGM_central_baryon_density, 
-    			y[0], y[2], y[1], y[3]);
+    double no_errors[4] = {0.0, 0.0, 0.0, 0.0};
     if (report_error_estimates == true) {
         printf("%15.14e %15.14e %15.14e %15.14e ",0.0,0.0,0.0,0.0);
-        fprintf(fp2, "%15.14e %15.14e %15.14e %15.14e ",0.0,0.0,0.0,0.0); 
     }
     printf("\n");
-    fprintf(fp2,"\n");
+    save_line(fp2, current_position, c[0], TOVOdieGM_central_baryon_density, y, (report_error_estimates == true) ? no_errors : NULL);
+    
+    // The TOV equations are 0/0 at the center, so series_start moves us a short way out first 
+    // with the Taylor expansion there, good to the error limit. The center stays the first line of 
+    // the file, tov_interp relies on it. 
+    double x_center = 0.0;
+    if (enthalpy_formulation == true) {
+        x_center = -enthalpy_of_pressure(y[0]); // Where the center is in pseudo-enthalpy, see below. 
+    }
+    double series_position = series_start(current_position, y, &cp, relative_error_limit);
+    bool series_started = (series_position != current_position);
+    if (series_started == true) {
+        current_position = series_position;
+        assign_constants(c,&cp);
+        save_line(fp2, current_position, c[0], pow(y[0]/TOVOdieGM_K,1.0/TOVOdieGM_Gamma), y, (report_error_estimates == true) ? no_errors : NULL);
+        printf("Series start to %15.14e.\n",current_position);
+    }
+
+    if (enthalpy_formulation == true) {
+        // The star in pseudo-enthalpy h instead of radius (Lindblom 1992). h runs from its central 
+        // value down to exactly 0 at the surface, so the surface is the end of a fixed interval instead 
+        // of somewhere the pressure crosses 0, and there's nothing for exception_handler to clamp. 
+        // Odie only steps forward, so the independent variable is x = -h, from -h_c up to 0. 
+        // The variables are (P, nu, m/r^3, rbar/r, r^2), see radius_to_enthalpy, 
+        // but the file gets the usual ones. Outside the star we carry on in radius below. 
+        nrpy_odiegm_system system_enthalpy = {diffy_Q_eval_enthalpy,known_Q_eval,number_of_equations+1,&cp,NULL,NULL,NULL,NULL};
+        nrpy_odiegm_driver *d_enthalpy;
+        d_enthalpy = nrpy_odiegm_driver_alloc_y_new(&system_enthalpy, step_type, enthalpy_step, absolute_error_limit, relative_error_limit);
+        d_enthalpy->c->scale_factor = scale_factor;
+        d_enthalpy->c->error_safety = error_safety;
+        d_enthalpy->c->ay_error_scaler = ay_error_scaler;
+        d_enthalpy->c->ady_error_scaler = ady_error_scaler;
+        d_enthalpy->c->max_step_adjustment = max_step_adjustment;
+        d_enthalpy->c->min_step_adjustment = min_step_adjustment;
+        d_enthalpy->c->absolute_max_step = absolute_max_step;
+        d_enthalpy->c->absolute_min_step = absolute_min_step;
+        d_enthalpy->c->error_upper_tolerance = error_upper_tolerance;
+        d_enthalpy->c->error_lower_tolerance = error_lower_tolerance;
+        d_enthalpy->c->error_norm = d->c->error_norm;
+        if (use_component_limits == true) {
+            nrpy_odiegm_control_set_tolerances(d_enthalpy->c, number_of_equations+1, absolute_error_limits, relative_error_limits, error_mask);
+        }
+        if (stiff_step_type != NULL) {
+            nrpy_odiegm_step_set_stiff_switching(d_enthalpy->s, stiff_step_type);
+        }
+        d_enthalpy->s->stiffness_threshold = TOVOdieGM_stiffness_threshold;
+        d_enthalpy->s->adams_bashforth_order = adams_bashforth_order;
+        d_enthalpy->e->no_adaptive_step = no_adaptive_step;
+
+        double y_enthalpy[number_of_equations+1];
+        double x = radius_to_enthalpy(current_position, y, y_enthalpy);
+        bool fixed_steps = (method_type == 0 || method_type == 2 || no_adaptive_step == true);
+        if (enthalpy_step <= 0.0 || fixed_steps == false) {
+            enthalpy_step = nrpy_odiegm_initial_step(&system_enthalpy, d_enthalpy->c, d_enthalpy->s, x, y_enthalpy);
+        }
+        if (fixed_steps == false && enthalpy_step > x - x_center) {
+            // Near the center the equations have terms like (4 pi rho - 3m/r^3)/r^2, which are fine 
+            // along the solution but punish any step that's large next to r^2, and the estimate above 
+            // can't see that. So an adaptive method starts no further than the series already took us. 
+            enthalpy_step = x - x_center;
+        }
+        if (fixed_steps == true) {
+            // Fixed steps get evened out so they land on the surface, rather than finishing with a stub. 
+            enthalpy_step = -x/ceil(-x/enthalpy_step);
+        }
+
+        int i = 0;
+        while (x < 0.0 && i < size) {
+            // The same hybrid footwork as the main loop below. 
+            if (method_type == 2 && i == 0 && step_type_2 != nrpy_odiegm_step_AB) {
+                d_enthalpy->s->type = step_type_2;
+                d_enthalpy->s->rows = step_type_2->rows;
+                d_enthalpy->s->columns = step_type_2->columns;
+                d_enthalpy->s->method_type = 0;
+                d_enthalpy->s->adams_bashforth_order = adams_bashforth_order;
+                d_enthalpy->e->no_adaptive_step = true;
+            } else if (step_type != step_type_2 && method_type == 2 && i == adams_bashforth_order) {
+                d_enthalpy->s->type = step_type;
+                d_enthalpy->s->rows = step_type->rows;
+                d_enthalpy->s->columns = step_type->columns;
+                d_enthalpy->s->method_type = 2;
+                d_enthalpy->s->adams_bashforth_order = adams_bashforth_order;
+                d_enthalpy->e->no_adaptive_step = true;
+            }
+
+            nrpy_odiegm_evolve_apply(d_enthalpy->e, d_enthalpy->c, d_enthalpy->s, &system_enthalpy, &x, 0.0, &enthalpy_step, y_enthalpy);
+            // t1 = 0 is the surface, evolve_apply cuts the last step short to land on it exactly. 
+            i++;
+
+            current_position = enthalpy_to_radius(x, y_enthalpy, y, &cp);
+            assign_constants(c,&cp);
+            save_line(fp2, current_position, c[0], pow(y[0]/TOVOdieGM_K,1.0/TOVOdieGM_Gamma), y, (report_error_estimates == true) ? d_enthalpy->e->yerr : NULL);
+            // The errors are for P, nu, m/r^3 and rbar/r. 
+        }
+
+        // current_position and y are back in radius for the exterior. 
+        printf("Surface at %15.14e after %i steps in enthalpy.\n",current_position,i);
+        if (d_enthalpy->s->stiff_type != NULL) {
+            printf("Stiffness switches inside the star: %lu.\n",d_enthalpy->s->switch_count);
+        }
+        nrpy_odiegm_driver_free(d_enthalpy);
+    }
+
+    nrpy_odiegm_transform log_position = {&system, nrpy_odiegm_log_to_s, nrpy_odiegm_log_to_x, nrpy_odiegm_log_dx_ds, NULL, false, 0.0, 0.0};
+    // s = ln(x), for logarithmic_position. 
+
+    if (step <= 0.0 || ((series_started == true || enthalpy_formulation == true) && method_type != 2 && no_adaptive_step == false)) {
+        // No initial step was given, so estimate one from the initial conditions. 
+        // Same if we just jumped off the center: TOVOdieGM_step is sized for creeping out of it, 
+        // an adaptive method can start with one sized for where it actually is. 
+        // And the same again at the surface if the star itself was done in enthalpy. 
+        if (logarithmic_position == true) {
+            nrpy_odiegm_system system_log = {nrpy_odiegm_transformed_function, NULL, number_of_equations, &log_position, NULL, NULL, NULL, NULL};
+            step = nrpy_odiegm_initial_step(&system_log, d->c, d->s, log(current_position), y);
+        } else {
+            step = nrpy_odiegm_initial_step(&system, d->c, d->s, current_position, y);
+        }
+        d->h = step;
+        printf("Estimated initial step: %15.14e.\n",step);
+    }
     
     // What follows is the original printing routine, we replaced this for ETK interface purposes. 
     /* // First, print the location we are at. 
@@ -337,7 +618,12 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
             d->e->no_adaptive_step = true;
         }
 
-        nrpy_odiegm_evolve_apply(d->e, d->c, d->s, &system, &current_position, current_position+step, &step, y);
+        if (logarithmic_position == true) {
+            nrpy_odiegm_evolve_apply_transformed(d->e, d->c, d->s, &log_position, &current_position, HUGE_VAL, &step, y);
+            // The same step in ln(x). There's no end point to land on, do_we_terminate decides when to stop. 
+        } else {
+            nrpy_odiegm_evolve_apply(d->e, d->c, d->s, &system, &current_position, current_position+step, &step, y);
+        }
         // This is the line that actually performs the step.
 
         exception_handler(current_position,y);
@@ -349,14 +635,7 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
         // Printing section. Altered for ETK use. 
 	    /* printf("%15.14e %15.14e %15.14e %15.14e %15.14e %15.14e %15.14e ", current_position, c[0], pow(y[0]/TOVOdieGM_K,1.0/TOVOdieGM_Gamma), 
 	    			y[0], y[2], y[1], y[3]);  */
-	    fprintf(fp2,"%15.14e %15.14e %15.14e %15.14e %15.14e %15.14e %15.14e ", current_position, c[0], pow(y[0]/TOVOdieGM_K,1.0/TOVOdieGM_Gamma), 
-	    			y[0], y[2], y[1], y[3]);
-	    if (report_error_estimates == true) {
-	    	// printf("%15.14e %15.14e %15.14e %15.14e ",(d->e->yerr[0]),(d->e->yerr[1]),(d->e->yerr[2]),(d->e->yerr[3])); 
-                fprintf(fp2, "%15.14e %15.14e %15.14e %15.14e ",(d->e->yerr[0]),(d->e->yerr[1]),(d->e->yerr[2]),(d->e->yerr[3])); 
-	    }
-	    // printf("\n");
-	    fprintf(fp2,"\n");
+	    save_line(fp2, current_position, c[0], pow(y[0]/TOVOdieGM_K,1.0/TOVOdieGM_Gamma), y, (report_error_estimates == true) ? d->e->yerr : NULL);
 		
         
         
@@ -422,7 +701,20 @@ void nrpy_odiegm_main(CCTK_ARGUMENTS)
     // Anything advanced will need to be done in a data analysis program. 
     // We like to use matplotlib for python.
 
-    fclose(fp2);
+    if (fp2 != NULL) {
+        fclose(fp2);
+    }
+    if (write_binary == true) {
+        printf("Writing %i points to file '%s'.\n",TOVOdieGM_solution.length,TOVOdieGM_file_name);
+        if (TOVOdieGM_trajectory_write_binary(TOVOdieGM_file_name, &TOVOdieGM_solution) != 0) {
+            CCTK_VWarn(CCTK_WARN_ALERT, __LINE__, __FILE__, CCTK_THORNSTRING,
+                       "Could not write the TOV solution to '%s'.", TOVOdieGM_file_name);
+        }
+    }
+
+    if (d->s->stiff_type != NULL) {
+        printf("Stiffness switches: %lu.\n",d->s->switch_count);
+    }
 
     nrpy_odiegm_driver_free(d);
     // MEMORY SHENANIGANS
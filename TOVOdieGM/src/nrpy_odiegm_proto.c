@@ -13,11 +13,45 @@ nrpy_odiegm_driver * nrpy_odiegm_driver_alloc_y_new (const nrpy_odiegm_system *
                                const double hstart,
                                const double epsabs, const double epsrel);
 
+// Per-component error control, optional. 
+void nrpy_odiegm_control_set_tolerances (nrpy_odiegm_control * c, size_t dim,
+                                         const double abs_lim_vector[], const double rel_lim_vector[],
+                                         const bool error_mask[]);
+
+// Integrating NRPy+ gridfunctions in place, optional. 
+void nrpy_odiegm_control_set_gridfunctions (nrpy_odiegm_control * c, int gridfunctions,
+                                            int Nxx_plus_2NGHOSTS0, int Nxx_plus_2NGHOSTS1,
+                                            int Nxx_plus_2NGHOSTS2, int NGHOSTS);
+nrpy_odiegm_driver * nrpy_odiegm_driver_alloc_gridfunctions (const nrpy_odiegm_system * sys,
+                                                             const nrpy_odiegm_step_type * T,
+                                                             const double hstart,
+                                                             const double epsabs, const double epsrel,
+                                                             int gridfunctions,
+                                                             int Nxx_plus_2NGHOSTS0, int Nxx_plus_2NGHOSTS1,
+                                                             int Nxx_plus_2NGHOSTS2, int NGHOSTS);
+
+// Automatic switching to an implicit method when the system turns stiff, optional. 
+void nrpy_odiegm_step_set_stiff_switching (nrpy_odiegm_step * s, 
+                                           const nrpy_odiegm_step_type * stiff_type);
+
+// Jacobian-free Newton-Krylov for the implicit methods, optional. 
+void nrpy_odiegm_step_set_matrix_free (nrpy_odiegm_step * s, int krylov_dimension);
+
+// Running the extrapolation (GBS) methods' midpoint sequences on several threads, optional. 
+void nrpy_odiegm_step_set_extrapolation_threads (nrpy_odiegm_step * s, int threads);
+
+// Sparse Jacobians for the implicit methods, optional. Hand the result to nrpy_odiegm_system.sparsity. 
+nrpy_odiegm_sparsity * nrpy_odiegm_sparsity_alloc (size_t dim, size_t nonzeros,
+                                                   const int row_start[], const int column_index[]);
+nrpy_odiegm_sparsity * nrpy_odiegm_sparsity_banded_alloc (size_t dim, int lower, int upper);
+
 // Memory freeing methods
 void nrpy_odiegm_control_free (nrpy_odiegm_control * c);
 void nrpy_odiegm_evolve_free (nrpy_odiegm_evolve * e);
 void nrpy_odiegm_step_free (nrpy_odiegm_step * s);
 void nrpy_odiegm_driver_free (nrpy_odiegm_driver * state);
+void nrpy_odiegm_sparsity_free (nrpy_odiegm_sparsity * p);
+void nrpy_odiegm_parareal_free (nrpy_odiegm_parareal * p);
 
 // The actual stepping functions are below.
 
@@ -25,12 +59,110 @@ void nrpy_odiegm_driver_free (nrpy_odiegm_driver * state);
 // they should always work regardless of the form of the system passed, the method passed, and even
 // if the user does something dumb it shouldn't crash. It will spit out nonsense in those cases, though. 
 
+// y_out = y + sum of weight[t]*k[t], the inner loop of every explicit method. 
+void nrpy_odiegm_stage_combination (const nrpy_odiegm_step * s, int number_of_equations, const double y[],
+                                    int terms, const double weight[], double * const k[], double y_out[]);
+
+// dydx[p] = f(x[p], y[p]) for several independent points, through the system's batch_function if it has one. 
+int nrpy_odiegm_evaluate_batch (const nrpy_odiegm_system * dydt, int points, const double x[],
+                                double *y[], double *dydx[]);
+// Grows one of the step's scratch buffers (stage_work, method_work) to at least size doubles. 
+double * nrpy_odiegm_step_work (double **work, size_t *work_size, size_t size);
+// The full step and first half step of step doubling, side by side so their stages can be batched. 
+void nrpy_odiegm_doubling_stages (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt, int rows, int columns,
+                                  const double * restrict butcher, double x, double step, const double y[],
+                                  double f_start[], bool *have_f_start, double y_full[], double y_half[]);
+
+// Estimates a good first step, used whenever the step handed to Odie is zero or negative. 
+double nrpy_odiegm_initial_step (const nrpy_odiegm_system * dydt, const nrpy_odiegm_control * c,
+                                 nrpy_odiegm_step * s, double t, const double y[]);
+
+// The error kernel used by nrpy_odiegm_evolve_apply to decide whether a step is acceptable. 
+double nrpy_odiegm_error_ratio (const nrpy_odiegm_control * c, int number_of_equations, double step,
+                                const double * restrict yerr, const double * restrict y,
+                                const double * restrict dydx);
+
+// The implicit (stiff) methods and the linear algebra they need. 
+// Called from nrpy_odiegm_evolve_apply, but usable on their own. 
+void nrpy_odiegm_step_implicit_workspace (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt);
+void nrpy_odiegm_jacobian_eval (const nrpy_odiegm_system * dydt, nrpy_odiegm_step * s,
+                                double x, const double y[]);
+int nrpy_odiegm_lu_decompose (int dimension, double * restrict matrix, int * restrict pivots);
+void nrpy_odiegm_lu_solve (int dimension, const double * restrict lu, const int * restrict pivots,
+                           double * restrict b);
+int nrpy_odiegm_band_lu_decompose (int dimension, int lower, int upper,
+                                   double * restrict band, int * restrict pivots);
+void nrpy_odiegm_band_lu_solve (int dimension, int lower, int upper, const double * restrict band,
+                                const int * restrict pivots, double * restrict b);
+void nrpy_odiegm_jacobian_vector (const nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                  const double v[], double Jv[]);
+int nrpy_odiegm_gmres_solve (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                             double h_gamma, double * restrict b);
+int nrpy_odiegm_iteration_matrix (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt, double h_gamma);
+int nrpy_odiegm_iteration_solve (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt, 
+                                 double * restrict b);
+int nrpy_odiegm_rosenbrock_step (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                 double x, double step, const double y[],
+                                 double y_new[], double y_embedded[]);
+int nrpy_odiegm_esdirk_step (nrpy_odiegm_step * s, const nrpy_odiegm_control * c,
+                             const nrpy_odiegm_system * dydt,
+                             double x, double step, const double y[],
+                             double y_new[], double y_embedded[]);
+int nrpy_odiegm_extrapolation_step (nrpy_odiegm_step * s, const nrpy_odiegm_control * c,
+                                    const nrpy_odiegm_system * dydt,
+                                    double x, double step, const double y[],
+                                    double y_new[], double y_embedded[]);
+int nrpy_odiegm_nystrom_first_order (double x, double y[], double dydx[], void *params);
+int nrpy_odiegm_nystrom_step (nrpy_odiegm_step * s, const nrpy_odiegm_system_nystrom * dydt,
+                              double x, double step, const double y[],
+                              double y_new[], double y_embedded[], double f_last[]);
+int nrpy_odiegm_split_step (nrpy_odiegm_step * s, const nrpy_odiegm_system_split * dydt,
+                            double x, double step, double y[]);
+
+// Stiffness detection and method switching, used by nrpy_odiegm_evolve_apply. 
+double nrpy_odiegm_spectral_radius (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt);
+void nrpy_odiegm_step_switch_type (nrpy_odiegm_step * s, const nrpy_odiegm_step_type * T);
+void nrpy_odiegm_stiffness_check (nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                  double x, const double y[], double h_lambda);
+
+// The low-storage methods' version of nrpy_odiegm_evolve_apply, which calls it for them. 
+int nrpy_odiegm_low_storage_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
+                                   nrpy_odiegm_step * s,
+                                   const nrpy_odiegm_system * dydt, double *t,
+                                   double t1, double *h, double y[]);
+
 // This is the main function, it does most of the actual work. 
 int nrpy_odiegm_evolve_apply (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
                              nrpy_odiegm_step * s,
                              const nrpy_odiegm_system * dydt, double *t,
                              double t1, double *h, double y[]);
 
+// The solution anywhere inside the last step, for methods with an interpolant (Tsit5). 
+int nrpy_odiegm_evolve_dense_output (const nrpy_odiegm_step * s, const nrpy_odiegm_system * dydt,
+                                     double x, double y_out[]);
+
+// The same for second order systems, with the Runge-Kutta-Nystrom methods. 
+int nrpy_odiegm_evolve_apply_nystrom (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
+                                      nrpy_odiegm_step * s,
+                                      const nrpy_odiegm_system_nystrom * dydt, double *t,
+                                      double t1, double *h, double y[]);
+// And for separable Hamiltonian systems, with the symplectic methods. Fixed steps only. 
+int nrpy_odiegm_evolve_apply_split (nrpy_odiegm_evolve * e, nrpy_odiegm_step * s,
+                                    const nrpy_odiegm_system_split * dydt, double *t,
+                                    double t1, double *h, double y[]);
+
+// And with a change of independent variable, see nrpy_odiegm_transform. x in and out, h in s. 
+int nrpy_odiegm_evolve_apply_transformed (nrpy_odiegm_evolve * e, nrpy_odiegm_control * c,
+                                          nrpy_odiegm_step * s, nrpy_odiegm_transform * T,
+                                          double *t, double t1, double *h, double y[]);
+// The system in s, which that steps with. Hand it to nrpy_odiegm_initial_step for a first step in s. 
+int nrpy_odiegm_transformed_function (double s, double y[], double dyds[], void *params);
+int nrpy_odiegm_transformed_batch (int points, const double s[], double *y[], double *dyds[], void *params);
+// s = ln(x), the usual change for something spread over many decades of x > 0. 
+double nrpy_odiegm_log_to_s (double x, void *params);
+double nrpy_odiegm_log_to_x (double s, void *params);
+double nrpy_odiegm_log_dx_ds (double s, void *params);
+
 // The rest of these are just modifications on the above, 
 // in fact all of them call nrpy_odiegm_evolve_apply when run. 
 int nrpy_odiegm_evolve_apply_fixed_step (nrpy_odiegm_evolve * e,
@@ -44,4 +176,14 @@ int nrpy_odiegm_driver_apply (nrpy_odiegm_driver * d, double *t,
 int nrpy_odiegm_driver_apply_fixed_step (nrpy_odiegm_driver * d, double *t,
                                         const double h,
                                         const unsigned long int n,
-                                        double y[]);
\ No newline at end of file
+                                        double y[]);
+
+// Parareal, for long integrations that can't be parallelized any other way. 
+nrpy_odiegm_parareal * nrpy_odiegm_parareal_alloc (const nrpy_odiegm_system * sys,
+                                                   const nrpy_odiegm_step_type * coarse_type,
+                                                   const double coarse_step,
+                                                   const nrpy_odiegm_step_type * fine_type,
+                                                   const double epsabs, const double epsrel,
+                                                   const int slices);
+void nrpy_odiegm_parareal_coarse (nrpy_odiegm_parareal * p, double x, double slice_length, double y[]);
+int nrpy_odiegm_parareal_apply (nrpy_odiegm_parareal * p, double *t, const double t1, double y[]);
\ No newline at end of file
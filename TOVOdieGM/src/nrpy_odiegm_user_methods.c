@@ -44,6 +44,18 @@ int known_Q_eval (double x, double y[]);
 // If an exact solution is known, it goes here, otherwise leave empty. 
 void get_initial_condition (double y[]);
 // Initial conditions for the system of differential equations. 
+double series_start (double x, double y[], struct constant_parameters *params, double error_limit);
+// Moves the initial condition off a singular starting point with a series expansion. 
+double enthalpy_of_pressure (double P);
+// The pseudo-enthalpy at a given pressure, for integrating in enthalpy instead of radius. 
+void enthalpy_const_eval (double h, double y[], struct constant_parameters *params);
+// The EOS as a function of the pseudo-enthalpy: puts the pressure in y[0] and the rest in params. 
+int diffy_Q_eval_enthalpy (double x, double y[], double dydx[], void *params);
+// The same system with x = -h as the independent variable, in variables that are smooth in h. 
+double radius_to_enthalpy (double x, const double y[], double y_enthalpy[]);
+// Changes variables from the radius formulation to the enthalpy one, returns the new x. 
+double enthalpy_to_radius (double x, const double y_enthalpy[], double y[], struct constant_parameters *params);
+// And back again, returns the radius. 
 void assign_constants (double c[], struct constant_parameters *params);
 // Used to read values from constant_parameters into an array so they can be reported in sequence. 
 
@@ -53,6 +65,8 @@ void assign_constants (double c[], struct constant_parameters *params);
 // NOTE: the given nrpy_odiegm_main.c file will only work with the same names as listed here,
 // only change names if creating a new custom main function. 
 
+#include "nrpy_odiegm_TOV_rhs.c" // The TOV equations themselves, written by nrpy_odiegm_TOV_rhs.py.
+
 void exception_handler (double x, double y[])
 {
     // This funciton might be empty. It's only used if the user wants to hard code some limitations 
@@ -149,29 +163,10 @@ int diffy_Q_eval (double x, double y[], double dydx[], void *params)
     // https://stackoverflow.com/questions/51052314/access-variables-in-struct-from-void-pointer
     // Make sure to dereference every parameter within the struct so it can be used below. 
 
-    // This if statement is an example of a special condition, 
-    // in this case at x=0 we have a divide by zero problem. 
-    // Fortunately, we manually know what the derivatives should be.
-    // Alternatively, we could define piecewise equations this way. 
-    if(x == 0) {
-        dydx[0] = 0; 
-        dydx[1] = 0;
-        dydx[2] = 0;
-        dydx[3] = 1;
-    }
-    else {
-        dydx[0] = -((rho+y[0])*( (2.0*y[2])/(x) + 8.0*3.1415926535897931160*x*x*y[0] ))/(x*2.0*(1.0 - (2.0*y[2])/(x)));
-        dydx[1] =  ((2.0*y[2])/(x) + 8.0*3.1415926535897931160*x*x*y[0])/(x*(1.0 - (2.0*y[2])/(x)));
-        dydx[2] = 4*3.1415926535897931160*x*x*rho;
-        dydx[3] = (y[3])/(x*sqrt(1.0-(2.0*y[2])/x));
-        // Visual Studio likes to complain that M_PI is not defined, even though it is. 
-        // So we used 3.1415926535897931160. which is just M_PI printed out to extra digits.
-        // There was no observed change in the final product. 
-    }
-    // This funciton is not guaranteed to work in all cases. For instance, we have manually 
-    // made an exception for x=0, since evaluating at 0 produces infinities and NaNs. 
-    // Be sure to declare any exceptions before runnpresing, both here and in exception_handler, 
-    // depending on the kind of exception desired.  
+    // The equations are generated from their symbolic form, so 2m/r and the like 
+    // only get computed once. See nrpy_odiegm_TOV_rhs.py for what they are. 
+    // They're 0/0 at x=0, but we never go there: series_start starts us a little way out. 
+    TOV_rhs(x,y,rho,dydx);
 
     return 0;
     // GSL_SUCCESS is 0. We do not support fancy error codes like GSL. 
@@ -237,6 +232,146 @@ void get_initial_condition (double y[])
     y[3] = 0.0; // r-bar
 }
 
+double series_start (double x, double y[], struct constant_parameters *params, double error_limit)
+{
+    // This function might be empty (just return x). It's only used if the equations can't be 
+    // evaluated where they start. 
+    // Today they can't: the TOV equations are 0/0 at the center. Starting there would need 
+    // hand-made derivatives at x=0 and then a long crawl of tiny steps, so instead we take the 
+    // Taylor expansion about the center (see nrpy_odiegm_TOV_rhs.py) straight out to the radius 
+    // where it's still good to error_limit, and return that radius. 
+    const_eval(x,y,params);
+    double P_c = y[0];
+    double rho_c = params->rho;
+    // The only other thing the expansion needs from the EOS is drho/dP at the center. 
+    double dP = 1e-6*P_c;
+    double y_nearby[4] = {P_c + dP, y[1], y[2], y[3]};
+    const_eval(x,y_nearby,params);
+    double rho_above = params->rho;
+    y_nearby[0] = P_c - dP;
+    const_eval(x,y_nearby,params);
+    double drho_dP_c = (rho_above - params->rho)/(2.0*dP);
+
+    x = TOV_center_series(P_c,rho_c,drho_dP_c,error_limit,y);
+    const_eval(x,y,params);
+    return x;
+}
+
+// The pseudo-enthalpy h = ln((rho + P)/rho_b) at one line of the table. 
+static double table_enthalpy (int i)
+{
+    return log(1.0 + exp(logeps[i]) + exp(logpres[i] - logrho[i]));
+}
+
+double enthalpy_of_pressure (double P)
+{
+    DECLARE_CCTK_PARAMETERS
+    // This function is only needed for TOVOdieGM_enthalpy_formulation. 
+    // The pseudo-enthalpy is h = integral of dP/(rho+P) from the surface in, which is ln((rho+P)/rho_b). 
+    if (P <= 0.0) {
+        return 0.0;
+    }
+    if (TOVOdieGM_use_EOS_table == false) {
+        double baryon_density = pow(P / TOVOdieGM_K , 1.0 / TOVOdieGM_Gamma);
+        return log1p(TOVOdieGM_Gamma / (TOVOdieGM_Gamma - 1.0) * P / baryon_density);
+    }
+    // With a table, interpolate h in log(P) between the two lines around it. 
+    double log_pres_checker = log(P);
+    for (int i = 0; i < array_size-1; i++) {
+        if ((logpres[i] - log_pres_checker)*(logpres[i+1] - log_pres_checker) <= 0.0) {
+            double linear_interp_scale = (log_pres_checker - logpres[i])/(logpres[i+1] - logpres[i]);
+            return table_enthalpy(i) + linear_interp_scale*(table_enthalpy(i+1) - table_enthalpy(i));
+        }
+    }
+    printf("WARNING: You are outside the bounds of the table (pressure)! Using an edge value but no promises it'll be any good!\n");
+    if (fabs(log_pres_checker - logpres[0]) < fabs(log_pres_checker - logpres[array_size-1])) {
+        return table_enthalpy(0);
+    }
+    return table_enthalpy(array_size-1);
+}
+
+void enthalpy_const_eval (double h, double y[], struct constant_parameters *params)
+{
+    DECLARE_CCTK_PARAMETERS
+    // const_eval turned around: in the enthalpy formulation P isn't integrated, it's the EOS at h. 
+    // Both P and rho are exactly 0 at the surface, h = 0. 
+    if (h <= 0.0) {
+        y[0] = 0.0;
+        params->rho = 0.0;
+    } else if (TOVOdieGM_use_EOS_table == false) {
+        // Inverting h = ln(1 + Gamma/(Gamma-1) K rho_b^(Gamma-1)). 
+        double baryon_density = pow(expm1(h) * (TOVOdieGM_Gamma - 1.0) / (TOVOdieGM_Gamma * TOVOdieGM_K), 1.0 / (TOVOdieGM_Gamma - 1.0));
+        y[0] = TOVOdieGM_K * pow(baryon_density, TOVOdieGM_Gamma);
+        params->rho = baryon_density + y[0] / (TOVOdieGM_Gamma - 1.0);
+    } else {
+        // Find the two lines of the table around h and interpolate the logs between them, like const_eval. 
+        int enthalpyIndex = -1;
+        for (int i = 0; i < array_size-1; i++) {
+            if ((table_enthalpy(i) - h)*(table_enthalpy(i+1) - h) <= 0.0) {
+                enthalpyIndex = i;
+                break;
+            }
+        }
+        if (enthalpyIndex == -1) {
+            int edge = 0;
+            if (table_enthalpy(array_size-1) < table_enthalpy(0)) {
+                edge = array_size-1;
+            }
+            if (h < table_enthalpy(edge)) {
+                // Below the bottom of the table, but still inside the star: 
+                // take P and rho down to 0 at the surface in proportion to h. 
+                y[0] = exp(logpres[edge]) * h / table_enthalpy(edge);
+                params->rho = exp(logrho[edge]) * (exp(logeps[edge]) + 1.0) * h / table_enthalpy(edge);
+                return;
+            }
+            printf("WARNING: You are outside the bounds of the table (enthalpy)! Using an edge value but no promises it'll be any good!\n");
+            edge = array_size-1 - edge;
+            y[0] = exp(logpres[edge]);
+            params->rho = exp(logrho[edge]) * (exp(logeps[edge]) + 1.0);
+            return;
+        }
+        double linear_interp_scale = (h - table_enthalpy(enthalpyIndex))/(table_enthalpy(enthalpyIndex+1) - table_enthalpy(enthalpyIndex));
+        double new_pres = logpres[enthalpyIndex] + linear_interp_scale*(logpres[enthalpyIndex+1] - logpres[enthalpyIndex]);
+        double new_rho = logrho[enthalpyIndex] + linear_interp_scale*(logrho[enthalpyIndex+1] - logrho[enthalpyIndex]);
+        double new_eps = logeps[enthalpyIndex] + linear_interp_scale*(logeps[enthalpyIndex+1] - logeps[enthalpyIndex]);
+        y[0] = exp(new_pres);
+        params->rho = exp(new_rho) * (exp(new_eps) + 1.0);
+    }
+}
+
+int diffy_Q_eval_enthalpy (double x, double y[], double dydx[], void *params)
+{
+    // Same as diffy_Q_eval, but the independent variable is minus the pseudo-enthalpy, 
+    // x = -h, which runs up to exactly 0 at the surface. P follows from h, so nothing 
+    // needs clamping. r, m and rbar all go like a root of h_c - h near the center, so 
+    // the variables are y = (P, nu, m/r^3, rbar/r, r^2) instead, which are smooth. 
+    enthalpy_const_eval(-x,y,params);
+    double rho = (*(struct constant_parameters*)params).rho;
+    TOV_rhs_enthalpy(y,rho,dydx);
+
+    return 0;
+}
+
+double radius_to_enthalpy (double x, const double y[], double y_enthalpy[])
+{
+    y_enthalpy[0] = y[0]; // Pressure
+    y_enthalpy[1] = y[1]; // nu
+    y_enthalpy[2] = y[2]/(x*x*x); // m/r^3
+    y_enthalpy[3] = y[3]/x; // rbar/r
+    y_enthalpy[4] = x*x; // r^2
+    return -enthalpy_of_pressure(y[0]);
+}
+
+double enthalpy_to_radius (double x, const double y_enthalpy[], double y[], struct constant_parameters *params)
+{
+    double r = sqrt(y_enthalpy[4]);
+    y[1] = y_enthalpy[1];
+    y[2] = y_enthalpy[2]*r*r*r;
+    y[3] = y_enthalpy[3]*r;
+    enthalpy_const_eval(-x,y,params); // The pressure comes from the EOS, exactly 0 at the surface. 
+    return r;
+}
+
 void assign_constants (double c[], struct constant_parameters *params)
 {
     // Reading parameters from the constant_parameters struct is rather difficult, since it exists
@@ -1,4 +1,4 @@
-// This C header file reads a TOV solution from data file and performs
+// This C header file takes the TOV solution from nrpy_odiegm_main and performs
 //    1D interpolation of the solution to a desired radius.
 
 // Author: Zachariah B. Etienne
@@ -10,11 +10,18 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <cctk.h>
 #include <cctk_Arguments.h>
 #include <cctk_Parameters.h>
 
+#include "tov_trajectory.h"
+
 #define REAL double
 
 #define velx (&vel[0*cctk_lsh[0]*cctk_lsh[1]*cctk_lsh[2]])
@@ -54,51 +61,176 @@
 
 //#define STANDALONE_UNIT_TEST
 
-int count_num_lines_in_file(FILE *in1Dpolytrope) {
-  int numlines_in_file = 0;
-  char * line = NULL;
+// Reading a TOV solution back from a file, for TOVOdieGM_profile_file. (Gabriel M Steward) 
+// The file is mapped into memory and gone through once, growing the arrays as needed, 
+// instead of counting the lines first and then tokenizing each one. 
+
+// The powers of ten that are exact as doubles. 
+static const double exact_powers_of_ten[23] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Reads one number starting at text (and no further than end) into *value, and returns where it stopped, 
+// or NULL if there isn't a number there. A number with at most 19 digits whose digits fit in a double 
+// exactly, times a power of ten that's also exact, is one correctly rounded multiplication or division 
+// (Clinger's fast path). That's every number TOVOdieGM writes apart from the very small and very large. 
+// The rest go to strtod, so the result is always correctly rounded. 
+static const char *parse_number(const char *text, const char *end, double *value) {
+  const char *p = text;
+  int negative = 0;
+  if(p < end && (*p == '-' || *p == '+')) { negative = (*p == '-'); p++; }
+  uint64_t digits = 0;
+  int number_of_digits = 0; // Not counting leading zeros. 
+  int exponent = 0;
+  int seen_digit = 0;
+  int fast = 1;
+  while(p < end && *p >= '0' && *p <= '9') {
+    if(number_of_digits == 19) fast = 0; // Doesn't fit, strtod will have to do it. 
+    digits = 10*digits + (uint64_t)(*p - '0');
+    if(digits > 0) number_of_digits++;
+    seen_digit = 1;
+    p++;
+  }
+  if(p < end && *p == '.') {
+    p++;
+    while(p < end && *p >= '0' && *p <= '9') {
+      if(number_of_digits == 19) fast = 0;
+      digits = 10*digits + (uint64_t)(*p - '0');
+      if(digits > 0) number_of_digits++;
+      exponent--;
+      seen_digit = 1;
+      p++;
+    }
+  }
+  if(seen_digit == 0) fast = 0;
+  if(fast && p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    int exponent_negative = 0;
+    if(p < end && (*p == '-' || *p == '+')) { exponent_negative = (*p == '-'); p++; }
+    if(p == end || *p < '0' || *p > '9') fast = 0;
+    int written_exponent = 0;
+    while(p < end && *p >= '0' && *p <= '9') {
+      if(written_exponent < 100000) written_exponent = 10*written_exponent + (*p - '0');
+      p++;
+    }
+    exponent += exponent_negative ? -written_exponent : written_exponent;
+  }
+  if(p < end && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') fast = 0;
+  if(fast && digits <= (UINT64_C(1) << 53) && exponent >= -22 && exponent <= 22) {
+    double result = (double)digits;
+    if(exponent < 0) result /= exact_powers_of_ten[-exponent];
+    else result *= exact_powers_of_ten[exponent];
+    *value = negative ? -result : result;
+    return p;
+  }
+  // Too many digits, an exponent out of range, or something else entirely (inf, nan, a typo): strtod decides. 
+  // The mapped file isn't null terminated, so the number is copied out first. 
+  char buffer[128];
+  const char *q = text;
+  while(q < end && q - text < 127 && *q != ' ' && *q != '\t' && *q != '\n' && *q != '\r') q++;
+  if(q - text == 127) return NULL; // No number is that long. 
+  memcpy(buffer, text, q - text);
+  buffer[q - text] = '\0';
+  char *stopped;
+  *value = strtod(buffer, &stopped);
+  if(stopped == buffer || *stopped != '\0') return NULL;
+  return q;
+}
+
+// The text format, as written by nrpy_odiegm_main: r_Schw, rho, rho_baryon, P, M, nu, rbar 
+// on each line, perhaps followed by error estimates, which are skipped. 
+static int load_text_profile(const char *data, const char *end, TOVOdieGM_trajectory *solution) {
+  const char *p = data;
+  int line = 0;
+  while(p < end) {
+    line++;
+    double values[7];
+    int n = 0;
+    while(p < end && *p != '\n') {
+      if(*p == ' ' || *p == '\t' || *p == '\r') { p++; continue; }
+      if(n == 7) { // The error estimates, or whatever else there is. 
+        while(p < end && *p != '\n') p++;
+        break;
+      }
+      p = parse_number(p, end, &values[n]);
+      if(p == NULL) { fprintf(stderr,"ERROR: could not read number %d on line %d\n",n+1,line); return 1; }
+      n++;
+    }
+    p++; // Past the newline. 
+    if(n == 0) continue; // Blank lines are fine. 
+    if(n < 7) { fprintf(stderr,"ERROR: only %d numbers on line %d, expected 7\n",n,line); return 1; }
+    TOVOdieGM_trajectory_append(solution, values[0], values[1], values[2], values[3], values[4], values[5], values[6]);
+  }
+  return 0;
+}
+
+// The binary format, see tov_trajectory.h. 
+static int load_binary_profile(const char *data, size_t size, TOVOdieGM_trajectory *solution) {
+  int64_t header[2];
+  if(size < 8 + sizeof(header)) { fprintf(stderr,"ERROR: binary profile is too short\n"); return 1; }
+  memcpy(header, data + 8, sizeof(header));
+  if(header[1] != 7 || header[0] < 0 || header[0] > INT32_MAX
+     || size != 8 + sizeof(header) + 7*sizeof(double)*(size_t)header[0]) {
+    fprintf(stderr,"ERROR: binary profile should hold 7 quantities with %lld points each, it doesn't\n",(long long)header[0]);
+    return 1;
+  }
+  int length = (int)header[0];
+  TOVOdieGM_trajectory_reserve(solution, length);
+  double *columns[7] = {solution->r_Schw, solution->rho, solution->rho_baryon, solution->P, solution->M, solution->nu, solution->rbar};
+  const char *column = data + 8 + sizeof(header);
+  for(int n = 0; n < 7; n++) {
+    memcpy(columns[n], column, sizeof(double)*length);
+    column += sizeof(double)*length;
+  }
+  solution->length = length;
+  return 0;
+}
 
-  size_t len = 0;
-  ssize_t read;
-  while ((read = getline(&line, &len, in1Dpolytrope)) != -1) {
-    numlines_in_file++;
+int TOVOdieGM_trajectory_load(const char *filename, TOVOdieGM_trajectory *solution) {
+  int fd = open(filename, O_RDONLY);
+  if(fd < 0) {
+    fprintf(stderr,"ERROR: could not open file %s\n",filename);
+    return 1;
+  }
+  struct stat file_status;
+  if(fstat(fd, &file_status) != 0 || file_status.st_size == 0) {
+    fprintf(stderr,"ERROR: file %s is empty\n",filename);
+    close(fd);
+    return 1;
   }
-  rewind(in1Dpolytrope);
+  size_t size = (size_t)file_status.st_size;
+  const char *data = (const char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED) {
+    fprintf(stderr,"ERROR: could not map file %s\n",filename);
+    return 1;
+  }
+  madvise((void *)data, size, MADV_SEQUENTIAL);
 
-  free(line);
-  return numlines_in_file;
+  solution->length = 0;
+  int status;
+  if(size >= 8 && memcmp(data, TOVODIEGM_BINARY_MAGIC, 8) == 0) {
+    status = load_binary_profile(data, size, solution);
+  } else {
+    status = load_text_profile(data, data + size, solution);
+  }
+  munmap((void *)data, size);
+  return status;
 }
 
-int read_datafile__set_arrays(FILE *in1Dpolytrope, REAL *restrict r_Schw_arr,REAL *restrict rho_arr,REAL *restrict rho_baryon_arr,REAL *restrict P_arr,
-                              REAL *restrict M_arr,REAL *restrict expnu_arr,REAL *restrict exp4phi_arr,REAL *restrict rbar_arr) {
+// The solution comes from nrpy_odiegm_main through TOVOdieGM_solution (see tov_trajectory.h) 
+// rather than a data file. (Gabriel M Steward) 
+int set_arrays_from_solution(const TOVOdieGM_trajectory *solution, REAL *restrict expnu_arr, REAL *restrict exp4phi_arr, REAL *restrict rbar_arr) {
   DECLARE_CCTK_PARAMETERS
-  
-  char * line = NULL;
-
-  size_t len = 0;
-  ssize_t read;
-
-  int which_line = 0;
-  while ((read = getline(&line, &len, in1Dpolytrope)) != -1) {
-    // Define the line delimiters (i.e., the stuff that goes between the data on a given
-    //     line of data.  Here, we define both spaces " " and tabs "\t" as data delimiters.
-    const char delimiters[] = " \t";
-
-    //Now we define "token", a pointer to the first column of data
-    char *token;
-
-    //Each successive time we call strtok(NULL,blah), we read in a new column of data from
-    //     the originally defined character array, as pointed to by token.
-    token=strtok(line, delimiters); if(token==NULL) { printf("BADDDD\n"); return 1; }
-    r_Schw_arr[which_line]     = strtod(token, NULL); token = strtok( NULL, delimiters );
-    rho_arr[which_line]        = strtod(token, NULL); token = strtok( NULL, delimiters );
-    rho_baryon_arr[which_line] = strtod(token, NULL); token = strtok( NULL, delimiters );
-    P_arr[which_line]          = strtod(token, NULL); token = strtok( NULL, delimiters );
-    M_arr[which_line]          = strtod(token, NULL); token = strtok( NULL, delimiters );
-    expnu_arr[which_line]      = strtod(token, NULL); token = strtok( NULL, delimiters );
-    rbar_arr[which_line]       = strtod(token, NULL);	
-    which_line++;
-  }
+
+  const int which_line = solution->length;
+  const REAL *restrict r_Schw_arr = solution->r_Schw;
+  const REAL *restrict rho_arr = solution->rho;
+  const REAL *restrict M_arr = solution->M;
+  if(which_line < 2) { fprintf(stderr,"Error: the TOV solution has %d lines, too few to interpolate.\n",which_line); return 1; }
+  // nu and rbar get normalized below. They're copies, so the solution itself stays as it is. 
+  memcpy(expnu_arr, solution->nu, sizeof(REAL)*which_line);
+  memcpy(rbar_arr, solution->rbar, sizeof(REAL)*which_line);
   
   // In our case, the rbar read in is not normalized. Let's normalize it! (Also the lapse and the conformal factor need adjusting) 
   // (Gabriel M Steward) 
@@ -109,13 +241,21 @@ int read_datafile__set_arrays(FILE *in1Dpolytrope, REAL *restrict r_Schw_arr,REA
   for(int i=1;i<which_line;i++) {
     if(rho_arr[i-1]>0 && rho_arr[i]==0) { R_Schw = r_Schw_arr[i-1]; Rbar_idx = i-1; }
   }
+  if(TOVOdieGM_enthalpy_formulation && Rbar_idx >= 0) {
+    // Integrated in pseudo-enthalpy, the first line without any density is exactly on the surface
+    // rather than somewhere past it, so that's the edge of the star. 
+    Rbar_idx++; R_Schw = r_Schw_arr[Rbar_idx];
+  }
+  if(Rbar_idx < 0) { fprintf(stderr,"Error: could not find r=R in the TOV solution.\n"); return 1; }
   
-  FILE *fp3;
-  fp3 = fopen(TOVOdieGM_file_name_adjusted,"w"); 
-  printf("Printing adjusted data to file '%s'.\n",TOVOdieGM_file_name_adjusted);
+  FILE *fp3 = NULL;
+  if(TOVOdieGM_write_file_adjusted) {
+    fp3 = fopen(TOVOdieGM_file_name_adjusted,"w"); 
+    printf("Printing adjusted data to file '%s'.\n",TOVOdieGM_file_name_adjusted);
+  }
   // The values produced by Odie are not normalized, but people
   // might still need the normalized values and not want to 
-  // manage them manually. Thus we print the values we adjusted. 
+  // manage them manually. Thus we print the values we adjusted, if asked to. 
   
   double M_Total = M_arr[Rbar_idx];
   double Rbar_Edge = rbar_arr[Rbar_idx];
@@ -130,57 +270,121 @@ int read_datafile__set_arrays(FILE *in1Dpolytrope, REAL *restrict r_Schw_arr,REA
   	exp4phi_arr[0] = exp4phi_arr[1];
 	// Assume conformal factor is constant near core of star, to avoid divide by zero error. 
 	// Placed here since it relies on values calculated in iteration 1. 
-	fprintf(fp3, "%15.14e %15.14e %15.14e %15.14e\n",rbar_arr[0]*sqrt(exp4phi_arr[0]),rbar_arr[0],expnu_arr[0],exp4phi_arr[0]);
-	fprintf(fp3, "%15.14e %15.14e %15.14e %15.14e\n",rbar_arr[1]*sqrt(exp4phi_arr[1]),rbar_arr[1],expnu_arr[1],exp4phi_arr[1]);
   for (int i = 2; i < which_line; i++) { // Set zero values separately. 
   	rbar_arr[i] = rbar_arr[i] * normalizer;
   	expnu_arr[i] = exp(expnu_arr[i] - NU_Edge + log(1 -2.0*M_Total/R_Schw));
   	exp4phi_arr[i] = (r_Schw_arr[i]/rbar_arr[i])*(r_Schw_arr[i]/rbar_arr[i]);
-  	fprintf(fp3, "%15.14e %15.14e %15.14e %15.14e\n",rbar_arr[i]*sqrt(exp4phi_arr[i]),rbar_arr[i],expnu_arr[i],exp4phi_arr[i]);
   }
-  printf("Post processing data reported as radius, normalized isotropic radius, scaled square lapse, scaled conformal factor^4\n");  
-  
-  fclose(fp3);
+  if(fp3 != NULL) {
+    for (int i = 0; i < which_line; i++) {
+      fprintf(fp3, "%15.14e %15.14e %15.14e %15.14e\n",rbar_arr[i]*sqrt(exp4phi_arr[i]),rbar_arr[i],expnu_arr[i],exp4phi_arr[i]);
+    }
+    printf("Post processing data reported as radius, normalized isotropic radius, scaled square lapse, scaled conformal factor^4\n");  
+    fclose(fp3);
+  }
   
-  free(line);
   return 0;
 }
 
-// Find interpolation index using Bisection root-finding algorithm:
-static inline int bisection_idx_finder(const REAL rrbar, const int numlines_in_file, const REAL *restrict rbar_arr) {
-  int x1 = 0;
-  int x2 = numlines_in_file-2;
-  REAL y1 = rrbar-rbar_arr[x1];
-  REAL y2 = rrbar-rbar_arr[x2];
-	if (rrbar == 0) {
-		return 0; // Look, why would you want to interpolate to the center? It's the center! But if you want it you can have it, it's the 0 index. 
-	}
-  if(y1*y2 >= 0) {
-    fprintf(stderr,"INTERPOLATION BRACKETING ERROR %e | %e %e\n",rrbar,y1,y2);
-    exit(1);
+// Everything TOV_interpolate_1D needs to know about rbar_arr that doesn't depend on the point, 
+// worked out once per star instead of once per grid point. (Gabriel M Steward) 
+typedef struct {
+  int interp_stencil_size;
+  int number_of_buckets;
+  int bucket_shift; // How many bits of rbar to drop, see TOV_interp_bucket. 
+  uint64_t first_bucket; // The bucket of rbar_arr[1]. 
+  int *bucket_start; // For each bucket, a point at or before every rbar in it, see below. 
+  int search_step; // The first step of the search from there, a power of 2 (or 0). 
+  REAL *weights; // The barycentric weights of the stencil starting at each point. 
+} TOV_interp_table;
+
+// Which bucket rrbar falls in. The buckets are (close to) uniform in log(rbar), 
+// since the points are spread over many decades: densely inside the star, sparsely outside. 
+// For a positive double, the bits read as an integer are the exponent followed by the mantissa, 
+// so the top bits are a piecewise linear log2 that only ever goes up with rbar. Keeping 
+// 52 - bucket_shift bits of the mantissa makes 2^(52 - bucket_shift) buckets per factor of 2. 
+// Anything below rbar_arr[1] (the center included) is in the first bucket. 
+static inline int TOV_interp_bucket(const REAL rrbar, const TOV_interp_table *restrict table) {
+  uint64_t bits;
+  memcpy(&bits, &rrbar, sizeof(bits));
+  const int64_t bucket = (int64_t)(bits >> table->bucket_shift) - (int64_t)table->first_bucket;
+  const int64_t last_bucket = table->number_of_buckets - 1;
+  return (int)((bucket < 0) ? 0 : (bucket > last_bucket) ? last_bucket : bucket);
+}
+
+void TOV_interp_table_setup(TOV_interp_table *table, const int interp_stencil_size,
+                            const int numlines_in_file, const REAL *restrict rbar_arr) {
+  table->interp_stencil_size = interp_stencil_size;
+  // About 4 buckets per point on average. 
+  const REAL octaves = log2(rbar_arr[numlines_in_file-2]/rbar_arr[1]) + 1.0;
+  int mantissa_bits = (int)ceil(log2(4.0*numlines_in_file/octaves));
+  mantissa_bits = (mantissa_bits < 0) ? 0 : (mantissa_bits > 30) ? 30 : mantissa_bits;
+  table->bucket_shift = 52 - mantissa_bits;
+  uint64_t bits_start, bits_end;
+  memcpy(&bits_start, &rbar_arr[1], sizeof(bits_start));
+  memcpy(&bits_end, &rbar_arr[numlines_in_file-2], sizeof(bits_end));
+  table->first_bucket = bits_start >> table->bucket_shift;
+  table->number_of_buckets = (int)((bits_end >> table->bucket_shift) - table->first_bucket) + 1;
+  table->bucket_start = (int *)malloc(sizeof(int)*table->number_of_buckets);
+  // bucket_start is the last point in an earlier bucket (or the center, for the first bucket). 
+  // Since the buckets go up with rbar, that point is at or below anything in this bucket, so the 
+  // search can start from it. It ends at most at the last point in this bucket, and never past 
+  // numlines_in_file-3 since interp_main keeps rrbar below rbar_arr[numlines_in_file-2]. 
+  // search_step is big enough to get from the one to the other in any bucket. 
+  int i = 0;
+  int last = 0;
+  int span = 0;
+  for(int bucket=0;bucket<table->number_of_buckets;bucket++) {
+    while(i+1 < numlines_in_file-1 && TOV_interp_bucket(rbar_arr[i+1], table) < bucket) i++;
+    while(last+1 < numlines_in_file-2 && TOV_interp_bucket(rbar_arr[last+1], table) <= bucket) last++;
+    table->bucket_start[bucket] = i;
+    if(last - i > span) span = last - i;
   }
-  for(int i=0;i<numlines_in_file;i++) {
-    int x_midpoint = (x1+x2)/2;
-    REAL y_midpoint = rrbar-rbar_arr[x_midpoint];
-    if(y_midpoint*y1 < 0) {
-      x2 = x_midpoint;
-      y2 = y_midpoint;
-    } else {
-      x1 = x_midpoint;
-      y1 = y_midpoint;
-    }
-    if( abs(x2-x1) == 1 ) {
-      // If rbar_arr[x1] is closer to rrbar than rbar_arr[x2] then return x1:
-      if(fabs(rrbar-rbar_arr[x1]) < fabs(rrbar-rbar_arr[x2])) return x1;
-      // Otherwise return x2:
-      return x2;
+  table->search_step = 0;
+  if(span > 0) table->search_step = 1 << (int)floor(log2(span));
+  // Barycentric weights: 1/prod_(j != i) (rbar_i - rbar_j), for every stencil. With those, 
+  // a Lagrange coefficient is a weight times the product of (rrbar - rbar_j) over the rest 
+  // of the stencil, so working them out at a point is linear in the stencil size. 
+  const int number_of_stencils = numlines_in_file - interp_stencil_size + 1;
+  table->weights = (REAL *)malloc(sizeof(REAL)*number_of_stencils*interp_stencil_size);
+  for(int idxmin=0;idxmin<number_of_stencils;idxmin++) {
+    const REAL *restrict rbar_sample = &rbar_arr[idxmin];
+    for(int i=0;i<interp_stencil_size;i++) {
+      REAL denom = 1.0;
+      for(int j=0;j<i;j++) {
+        denom *= rbar_sample[i] - rbar_sample[j];
+      }
+      for(int j=i+1;j<interp_stencil_size;j++) {
+        denom *= rbar_sample[i] - rbar_sample[j];
+      }
+      table->weights[idxmin*interp_stencil_size + i] = 1.0/denom;
     }
   }
-  fprintf(stderr,"INTERPOLATION BRACKETING ERROR: DID NOT CONVERGE.\n");
-  exit(1);
 }
 
-void TOV_interpolate_1D(REAL rrbar,const REAL Rbar,const int Rbar_idx,const int interp_stencil_size,
+void TOV_interp_table_free(TOV_interp_table *table) {
+  free(table->bucket_start);
+  free(table->weights);
+}
+
+// Find the point nearest to rrbar. This used to be a bisection, now it's a bucket lookup and a short 
+// search from there, but it finds the same point: of the two around rrbar, the closer. 
+// There's nothing to branch on, the search always takes the same steps for a given table, so 
+// neighbouring grid points at very different radii cost the same. interp_main has already made 
+// sure rrbar is below rbar_arr[numlines_in_file-2], so this can't run off the end. 
+static inline int nearest_idx_finder(const REAL rrbar, const int numlines_in_file, const REAL *restrict rbar_arr,
+                                     const TOV_interp_table *restrict table) {
+  // The last point at or below rrbar. At rrbar = 0 that's the 0 index, the center. 
+  int x1 = table->bucket_start[TOV_interp_bucket(rrbar, table)];
+  for(int step=table->search_step;step>0;step/=2) {
+    const int probe = (x1+step < numlines_in_file-2) ? x1+step : numlines_in_file-2;
+    x1 += step*(rbar_arr[probe] <= rrbar);
+  }
+  // If rbar_arr[x1] is closer to rrbar than rbar_arr[x1+1] then return x1, otherwise x1+1:
+  return x1 + (fabs(rrbar-rbar_arr[x1]) >= fabs(rrbar-rbar_arr[x1+1]));
+}
+
+void TOV_interpolate_1D(REAL rrbar,const REAL Rbar,const int Rbar_idx,const TOV_interp_table *restrict table,
                         const int numlines_in_file,const REAL *restrict r_Schw_arr,const REAL *restrict rho_arr,const REAL *restrict rho_baryon_arr,const REAL *restrict P_arr,
                         const REAL *restrict M_arr,const REAL *restrict expnu_arr,const REAL *restrict exp4phi_arr,const REAL *restrict rbar_arr,
                         REAL *restrict rho,REAL *restrict rho_baryon,REAL *restrict P,REAL *restrict M,REAL *restrict expnu,REAL *restrict exp4phi) {
@@ -189,7 +393,8 @@ void TOV_interpolate_1D(REAL rrbar,const REAL Rbar,const int Rbar_idx,const int
   if(rrbar < 0) rrbar = -rrbar;
 
   // First find the central interpolation stencil index:
-  int idx = bisection_idx_finder(rrbar,numlines_in_file,rbar_arr);
+  int idx = nearest_idx_finder(rrbar,numlines_in_file,rbar_arr,table);
+  const int interp_stencil_size = table->interp_stencil_size;
 
 
 #ifdef MAX
@@ -211,28 +416,26 @@ void TOV_interpolate_1D(REAL rrbar,const REAL Rbar,const int Rbar_idx,const int
     idxmin = MIN(idxmin,Rbar_idx - interp_stencil_size + 1);
   } else {
     idxmin = MAX(idxmin,Rbar_idx+1);
-    idxmin = MIN(idxmin,numlines_in_file - interp_stencil_size + 1);
+    // and the last stencil in the table starts at numlines_in_file - interp_stencil_size.
+    idxmin = MIN(idxmin,numlines_in_file - interp_stencil_size);
   }
   // Now perform the Lagrange polynomial interpolation:
 
-  // First set the interpolation coefficients:
-  REAL rbar_sample[interp_stencil_size];
-  for(int i=idxmin;i<idxmin+interp_stencil_size;i++) {
-    rbar_sample[i-idxmin] = rbar_arr[i];
-  }
+  // First set the interpolation coefficients, from the weights in the table. The product over 
+  // the rest of the stencil is the product of the points before i times that of the points after, 
+  // so one pass up the stencil and one down. 
+  const REAL *restrict rbar_sample = &rbar_arr[idxmin];
+  const REAL *restrict weights = &table->weights[idxmin*interp_stencil_size];
   REAL l_i_of_r[interp_stencil_size];
+  REAL before = 1.0;
   for(int i=0;i<interp_stencil_size;i++) {
-    REAL numer = 1.0;
-    REAL denom = 1.0;
-    for(int j=0;j<i;j++) {
-      numer *= rrbar - rbar_sample[j];
-      denom *= rbar_sample[i] - rbar_sample[j];
-    }
-    for(int j=i+1;j<interp_stencil_size;j++) {
-      numer *= rrbar - rbar_sample[j];
-      denom *= rbar_sample[i] - rbar_sample[j];
-    }
-    l_i_of_r[i] = numer/denom;
+    l_i_of_r[i] = weights[i]*before;
+    before *= rrbar - rbar_sample[i];
+  }
+  REAL after = 1.0;
+  for(int i=interp_stencil_size-1;i>=0;i--) {
+    l_i_of_r[i] *= after;
+    after *= rrbar - rbar_sample[i];
   }
 
   // Then perform the interpolation:
@@ -272,66 +475,88 @@ void interp_main(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTS
   DECLARE_CCTK_PARAMETERS
 
-  // Open the data file:
-  char filename[100];
-  sprintf(filename,TOVOdieGM_file_name);
-
-  FILE *in1Dpolytrope = fopen(filename, "r");
-  if (in1Dpolytrope == NULL) {
-    fprintf(stderr,"ERROR: could not open file %s\n",filename);
-    exit(1);
+  // The solution nrpy_odiegm_main just found, still in memory, 
+  // or the one in TOVOdieGM_profile_file if there is one. 
+  if(strlen(TOVOdieGM_profile_file) > 0) {
+    if(TOVOdieGM_trajectory_load(TOVOdieGM_profile_file, &TOVOdieGM_solution) != 0) {
+      fprintf(stderr,"ERROR WHEN READING FILE %s!\n",TOVOdieGM_profile_file);
+      exit(1);
+    }
+    printf("Read %d points from file '%s'.\n",TOVOdieGM_solution.length,TOVOdieGM_profile_file);
   }
-
-  // Count the number of lines in the data file:
-  int numlines_in_file = count_num_lines_in_file(in1Dpolytrope);
-
-  // Allocate space for all data arrays:
-  REAL *r_Schw_arr     = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
-  REAL *rho_arr        = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
-  REAL *rho_baryon_arr = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
-  REAL *P_arr          = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
-  REAL *M_arr          = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
+  const TOVOdieGM_trajectory *solution = &TOVOdieGM_solution;
+  int numlines_in_file = solution->length; // One "line" per point, as in the data file. 
+
+  const REAL *r_Schw_arr     = solution->r_Schw;
+  const REAL *rho_arr        = solution->rho;
+  const REAL *rho_baryon_arr = solution->rho_baryon;
+  const REAL *P_arr          = solution->P;
+  const REAL *M_arr          = solution->M;
+  // Allocate space for the arrays that get normalized:
   REAL *expnu_arr      = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
   REAL *exp4phi_arr    = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
   REAL *rbar_arr       = (REAL *)malloc(sizeof(REAL)*numlines_in_file);
 
-  // Read from the data file, filling in arrays
-  if(read_datafile__set_arrays(in1Dpolytrope, r_Schw_arr,rho_arr,rho_baryon_arr,P_arr,M_arr,expnu_arr,exp4phi_arr,rbar_arr) == 1) {
-    fprintf(stderr,"ERROR WHEN READING FILE %s!\n",filename);
+  // Normalize, filling in arrays
+  if(set_arrays_from_solution(solution, expnu_arr,exp4phi_arr,rbar_arr) == 1) {
+    fprintf(stderr,"ERROR WHEN READING THE TOV SOLUTION! (%d points)\n",numlines_in_file);
     exit(1);
   }
-  fclose(in1Dpolytrope);
 
   REAL Rbar = -100;
   int Rbar_idx = -100;
   for(int i=1;i<numlines_in_file;i++) {
     if(rho_arr[i-1]>0 && rho_arr[i]==0) { Rbar = rbar_arr[i-1]; Rbar_idx = i-1; }
   }
+  if(TOVOdieGM_enthalpy_formulation && Rbar_idx >= 0) {
+    Rbar_idx++; Rbar = rbar_arr[Rbar_idx]; // As above, the surface itself. 
+  }
   
   printf("Star's Final Isotropic Radius, Radius, and Mass: %15.14e %15.14e %15.14e \n", Rbar*1477.974, r_Schw_arr[Rbar_idx]*1477.974, M_arr[Rbar_idx]);
   
   if(Rbar<0) {
-    fprintf(stderr,"Error: could not find r=R from data file.\n");
+    fprintf(stderr,"Error: could not find r=R in the TOV solution.\n");
     exit(1);
   }
 
+  TOV_interp_table table;
+  TOV_interp_table_setup(&table, 4, numlines_in_file, rbar_arr);
+  // A 4 point stencil, so cubic interpolation. 
+
+  // The solution has to reach past every grid point. That's checked here, once, rather than
+  // at every point inside the loop. The grid is Cartesian, so the farthest point is a corner.
+  REAL largest_radius = 0.0;
+  for(int corner=0; corner<8; corner++) {
+    int i3D = CCTK_GFINDEX3D(cctkGH, (corner & 1) ? cctk_lsh[0]-1 : 0,
+                                     (corner & 2) ? cctk_lsh[1]-1 : 0,
+                                     (corner & 4) ? cctk_lsh[2]-1 : 0);
+    REAL radius = sqrt( x[i3D]*x[i3D] + y[i3D]*y[i3D] + z[i3D]*z[i3D] );
+    if(radius > largest_radius) largest_radius = radius;
+  }
+  if(largest_radius >= rbar_arr[numlines_in_file-2]) {
+    CCTK_VWarn(CCTK_WARN_ABORT, __LINE__, __FILE__, CCTK_THORNSTRING,
+               "INTERPOLATION BRACKETING ERROR: the grid reaches r = %e, the TOV solution only %e. "
+               "Integrate the TOV equations further out.",
+               largest_radius, rbar_arr[numlines_in_file-2]);
+  }
+
 	// Here's the part where we actually place values on the
 	// ETK grid. 
-  for(int i=0; i<cctk_lsh[0]; i++) {
+	// k outermost and i innermost, so each thread sweeps along memory (CCTK_GFINDEX3D has i fastest). 
+	// Every point is independent, TOV_interpolate_1D only reads the solution and the table. 
+#pragma omp parallel for collapse(2)
+  for(int k=0; k<cctk_lsh[2]; k++) {
 	for(int j=0; j<cctk_lsh[1]; j++)  {
-	    for(int k=0; k<cctk_lsh[2]; k++) {
+	    for(int i=0; i<cctk_lsh[0]; i++) {
 	    	int i3D = CCTK_GFINDEX3D(cctkGH, i, j, k);
 	    	
 		double radiusETK = sqrt( x[i3D]*x[i3D] + y[i3D]*y[i3D] + z[i3D]*z[i3D] );
 		REAL rho_e,rho_baryon,P,M,expnu,exp4phi;
-		TOV_interpolate_1D(radiusETK,Rbar,Rbar_idx,4,  numlines_in_file,r_Schw_arr,rho_arr,rho_baryon_arr,P_arr,M_arr,expnu_arr,exp4phi_arr,rbar_arr,  &rho_e,&rho_baryon,&P,&M,&expnu,&exp4phi);
+		TOV_interpolate_1D(radiusETK,Rbar,Rbar_idx,&table,  numlines_in_file,r_Schw_arr,rho_arr,rho_baryon_arr,P_arr,M_arr,expnu_arr,exp4phi_arr,rbar_arr,  &rho_e,&rho_baryon,&P,&M,&expnu,&exp4phi);
 
 		rho[i3D] = rho_baryon;
 		press[i3D] = P;
-		betax[i3D] = 0.0;
-		betay[i3D] = 0.0;
-		betaz[i3D] = 0.0;
-		alp[i3D] = pow(expnu,0.5); 
+		alp[i3D] = sqrt(expnu); 
 		// Validated that this is the correct assignment, 
 		// as TOVSolver's values are comparable.
 		eps[i3D] = (rho_e / (rho_baryon+1e-30)) - 1.0; 
@@ -339,25 +564,32 @@ void interp_main(CCTK_ARGUMENTS) {
 		gxx[i3D] = 1.0/(exp4phi+1e-30);
 		gyy[i3D] = gxx[i3D];
 		gzz[i3D] = gxx[i3D];
-		gxy[i3D] = 0.0;
-		gxz[i3D] = 0.0;
-		gyz[i3D] = 0.0;
-		velx[i3D] = 0.0;
-		vely[i3D] = 0.0;
-		velz[i3D] = 0.0;
-	        w_lorentz[i3D] = 1/sqrt(1.0-(
-                          gxx[i3D] * velx[i3D] * velx[i3D]+
-                          gyy[i3D] * vely[i3D] * vely[i3D]+
-                          gzz[i3D] * velz[i3D] * velz[i3D]+
-                        2*gxy[i3D] * velx[i3D] * vely[i3D]+
-                        2*gxz[i3D] * velx[i3D] * velz[i3D]+
-                        2*gyz[i3D] * vely[i3D] * velz[i3D])*
-                        exp4phi);
-                // As the velocities are zero this reduces to 1.
 	    }	
 	}
   }
   int i3D = cctk_lsh[2]*cctk_lsh[1]*cctk_lsh[0];
+  // The star is static: no shift, no velocity, and a diagonal metric. So the rest is the same everywhere, 
+  // and the Lorentz factor, 1/sqrt(1 - exp4phi*g_ij v^i v^j), is exactly 1. 
+  // Those just get filled in, one plain sweep over memory per grid function. 
+#pragma omp parallel
+  {
+#pragma omp for nowait
+    for(int n=0; n<i3D; n++) betax[n] = 0.0;
+#pragma omp for nowait
+    for(int n=0; n<i3D; n++) betay[n] = 0.0;
+#pragma omp for nowait
+    for(int n=0; n<i3D; n++) betaz[n] = 0.0;
+#pragma omp for nowait
+    for(int n=0; n<i3D; n++) gxy[n] = 0.0;
+#pragma omp for nowait
+    for(int n=0; n<i3D; n++) gxz[n] = 0.0;
+#pragma omp for nowait
+    for(int n=0; n<i3D; n++) gyz[n] = 0.0;
+#pragma omp for nowait
+    for(int n=0; n<3*i3D; n++) vel[n] = 0.0; // velx, vely and velz, one after the other. 
+#pragma omp for nowait
+    for(int n=0; n<i3D; n++) w_lorentz[n] = 1.0;
+  }
   switch(TOV_Populate_Timelevels)
   {
     case 3:
@@ -399,12 +631,9 @@ void interp_main(CCTK_ARGUMENTS) {
 
   printf("Interpolation Successful!\n");
 
-  // Free the malloc()'s!
-  free(r_Schw_arr);
-  free(rho_arr);
-  free(rho_baryon_arr);
-  free(P_arr);
-  free(M_arr);
+  // Free the malloc()'s! The solution itself stays: interp_main runs once per component, after 
+  // nrpy_odiegm_main has run for all of them, and nrpy_odiegm_main reuses its room next time. 
+  TOV_interp_table_free(&table);
   free(expnu_arr);
   free(exp4phi_arr);
   free(rbar_arr);
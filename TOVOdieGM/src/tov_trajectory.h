@@ -0,0 +1,40 @@
+// The TOV solution as nrpy_odiegm_main leaves it for interp_main.
+// Both run in the same process, so the solution stays in memory, one array per quantity,
+// and never has to go through a text file. The files are only written if asked for.
+
+// Author: Gabriel M Steward
+
+#ifndef TOV_TRAJECTORY_H
+#define TOV_TRAJECTORY_H
+
+#include <stdint.h>
+
+typedef struct {
+    int length; // Number of points (lines of the old data file) held.
+    int capacity; // Number of points there is room for before the arrays have to grow.
+    double *r_Schw; // Radius.
+    double *rho; // Energy density.
+    double *rho_baryon; // Baryon density.
+    double *P; // Pressure.
+    double *M; // Mass.
+    double *nu; // 2ln(lapse), before it's normalized.
+    double *rbar; // Isotropic radius, before it's normalized.
+} TOVOdieGM_trajectory;
+
+extern TOVOdieGM_trajectory TOVOdieGM_solution;
+// Filled by nrpy_odiegm_main, read by interp_main.
+
+// The binary profile format: these 8 bytes, then the number of points and the number of 
+// quantities (7) as int64_t, then r_Schw, rho, rho_baryon, P, M, nu and rbar, each as that 
+// many doubles. Everything is in the byte order of the machine that wrote it. 
+#define TOVODIEGM_BINARY_MAGIC "TOVOdieB"
+
+void TOVOdieGM_trajectory_reserve(TOVOdieGM_trajectory *t, int capacity);
+void TOVOdieGM_trajectory_append(TOVOdieGM_trajectory *t, double r_Schw, double rho, double rho_baryon,
+                                 double P, double M, double nu, double rbar);
+int TOVOdieGM_trajectory_write_binary(const char *filename, const TOVOdieGM_trajectory *t);
+// In nrpy_odiegm_main.c. 
+int TOVOdieGM_trajectory_load(const char *filename, TOVOdieGM_trajectory *t);
+// In tov_interp.c, reads either format. 
+
+#endif
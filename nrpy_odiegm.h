@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdbool.h>
+#include <float.h>
       
 
 // #include <stdio.h>
@@ -33,11 +34,31 @@
 // Function prototypes can be found in nrpy_odiegm_proto.c
 
 
+typedef struct {
+    // The sparsity pattern of a Jacobian, for systems too big for a dense one. 
+    // Built with nrpy_odiegm_sparsity_alloc (any pattern) or nrpy_odiegm_sparsity_banded_alloc.
+    // Unless the system supplies its own, the Jacobian is then built by finite differences, 
+    // perturbing every column of one "color" at once: columns share a color only if they never share a row, 
+    // so one function call recovers all of them. A banded system needs (lower + upper + 1) 
+    // calls per Jacobian, no matter how big it is. 
+    int dimension;
+    int nonzeros;
+    int *row_start; // Compressed sparse row (CSR) pattern: the columns of row i are 
+    int *column_index; // column_index[row_start[i]] to column_index[row_start[i+1]-1]. 
+    int *column_start; // The same pattern stored by column, for filling in one color at a time. 
+    int *row_index;
+    int *csr_position; // Where each by-column entry lives in the CSR ordering. 
+    int *color; // The color of every column. 
+    int number_of_colors;
+    int lower_bandwidth; // How far below the diagonal the pattern reaches.
+    int upper_bandwidth; // How far above it. The linear solves use band storage of this size.
+} nrpy_odiegm_sparsity;
+
 typedef struct {
     int (*function) (double x, double y[], double dydx[], void *params);
     // The function passed to this struct contains the definitions of the differnetial equations. 
     // int (*jacobian) (double t, const double y[], double *dfdy, double dfdt[], void *params); 
-    // The Jacobian was a holdover from GSL, it will not be used in this program.
+    // The Jacobian was a holdover from GSL, it now lives at the end of the struct (see below).
     int (*true_function) (double x, double y[]);
     // INSTEAD we will use the Jacobian's slot slot to allow passing of a true value! 
     // Naturally, this is only used if desired.
@@ -46,8 +67,72 @@ typedef struct {
     void *params; // For storing extra constants needed to evaluate the functions. 
     // params->dimension stores how many there are. 
     // Struct definition can be found in nrpy_odiegm_user_methods.c
+    int (*jacobian) (double x, const double y[], double *dfdy, double dfdx[], void *params);
+    // The Jacobian is back, but at the end so existing {function, true_function, dimension, params}
+    // initializers still work (it comes out NULL). Only the implicit methods use it. 
+    // dfdy is dimension x dimension, row-major: dfdy[i*dimension+j] = df_i/dy_j. 
+    // With a sparsity pattern it's only the nonzeros, in the pattern's CSR order instead. 
+    // If it's NULL the implicit methods build the Jacobian with finite differences instead. 
+    nrpy_odiegm_sparsity *sparsity; // Optional sparsity pattern of the Jacobian, NULL means dense.
+    // If it's set, the Jacobian is stored in CSR form, and built by colored finite differences 
+    // unless the jacobian function above fills it in. 
+    int (*preconditioner) (double x, const double y[], double h_gamma, double r[], void *params);
+    // Optional, only used by the matrix-free (Krylov) linear solves, see nrpy_odiegm_step_set_matrix_free.
+    // It should overwrite r with an approximate solution z of (I - h_gamma*J(x,y)) z = r. 
+    // Anything cheap that captures the stiff part works, the diffusion operator on its own for example. 
+    // Return nonzero if it fails. NULL means no preconditioning. 
+    int (*batch_function) (int points, const double x[], double *y[], double *dydx[], void *params);
+    // Optional, the same equations as function but at several independent points in one call: 
+    // dydx[p] = f(x[p], y[p]) for p = 0..points-1. Same rules as function (y[p] may be clamped). 
+    // Used wherever the solver has evaluations that don't depend on each other: the full step 
+    // and first half step of step doubling, the extrapolation sequences, finite difference Jacobians. 
+    // For small systems this saves the per-call overhead, and the user can vectorize across points. 
+    // NULL means function is just called once per point. 
 } nrpy_odiegm_system;
 
+typedef struct {
+    // A second order system, y'' = f(x, y), for the Runge-Kutta-Nystrom methods. 
+    // Orbits, geodesics, anything with forces that don't depend on velocity. 
+    // The state handed to nrpy_odiegm_evolve_apply_nystrom is y followed by y', 2*dimension long 
+    // (so that's the size to allocate the step and evolve "objects" with), 
+    // but the function only ever sees the dimension values of y, and fills in y''. 
+    int (*function) (double x, double y[], double d2ydx2[], void *params);
+    size_t dimension; // How many second order equations, half the size of the state. 
+    void *params; // Same as nrpy_odiegm_system's. 
+} nrpy_odiegm_system_nystrom;
+
+typedef struct {
+    // A separable Hamiltonian system, H(q, p) = T(p) + V(q), for the symplectic methods. 
+    // The state handed to nrpy_odiegm_evolve_apply_split is q followed by p, 2*dimension long. 
+    // Each half of the derivative only depends on the other half of the state, which is 
+    // what lets the methods update them in turn and keep the flow symplectic. 
+    int (*position_derivative) (double x, double p[], double dqdx[], void *params); // dq/dx = dH/dp 
+    int (*momentum_derivative) (double x, double q[], double dpdx[], void *params); // dp/dx = -dH/dq 
+    size_t dimension; // How many positions, half the size of the state. 
+    void *params; // Same as nrpy_odiegm_system's. 
+} nrpy_odiegm_system_split;
+
+typedef struct {
+    // A change of independent variable, s = phi(x), for solutions that are smooth in s but not in x. 
+    // Something that changes on every scale from 1e-5 to 1e6 (a star and the space around it) is 
+    // close to uniform in s = ln(x), and then the step (and absolute_max_step) is in s, so a long 
+    // range costs a number of steps per decade instead of one per absolute_max_step of x. 
+    // nrpy_odiegm_evolve_apply_transformed takes x and hands back x, and calls the system in x, 
+    // multiplying by dx/ds itself. phi must increase. For s = ln(x): 
+    // nrpy_odiegm_transform log_x = {&system, nrpy_odiegm_log_to_s, nrpy_odiegm_log_to_x, nrpy_odiegm_log_dx_ds, NULL, false, 0.0, 0.0}; 
+    const nrpy_odiegm_system *sys; // The system, in x. 
+    double (*to_s) (double x, void *params); // s = phi(x) 
+    double (*to_x) (double s, void *params); // x = phi^-1(s) 
+    double (*dx_ds) (double s, void *params); // dx/ds at s, the Jacobian of the change. 
+    void *params; // For a phi with parameters of its own, NULL otherwise. 
+    bool have_last; // Where the last step ended, in both. The next step carries on from exactly 
+    double last_x; // the same s, rather than phi(phi^-1(s)), which needn't be the same to the last bit. 
+    double last_s; // Start these at false and 0. 
+} nrpy_odiegm_transform;
+
+typedef int (*nrpy_odiegm_kernel) (const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],
+                                   double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]);
+// One step of a fixed butcher table with every stage written out, see nrpy_odiegm_step_type. 
 
 typedef struct {
     // Unlike with the system struct above, this step_type struct does not need
@@ -57,9 +142,27 @@ typedef struct {
     // Since we're dealing with void pointers we need a way to know how big everything is. 
     int order; // record the order.
     // These are set at the bottom of this file. 
+    int method_type; // 0 means "work it out from the shape of the table," which is what every
+    // explicit method does. The implicit methods can't be told apart that way, so they set it:
+    // 3 is a Rosenbrock method, 4 is an ESDIRK method. 5 is Gragg-Bulirsch-Stoer extrapolation, 
+    // whose "table" is a single row: the number of midpoint steps for each column. 
+    // 6 is a Runge-Kutta-Nystrom method, for nrpy_odiegm_evolve_apply_nystrom only. 
+    // 7 is a symplectic splitting method, for nrpy_odiegm_evolve_apply_split only. 
+    // 8 is a low-storage Runge-Kutta method, again with its own table layout. 
     void *butcher;
     // Make sure to put this at the end of the struct
     // in case we add more parts to it. Nonspecific arrays must be the last element.
+    int interpolant_rows; 
+    void *interpolant; // Optional dense output table, see nrpy_odiegm_evolve_dense_output. 
+    // Row k is {p, P_1, P_2, ...}: stage i's weight at theta of the way through the step 
+    // is the sum over rows of P_i*theta^p. Comes after the butcher table so every 
+    // initializer that stops at the butcher table still works (no dense output, NULL). 
+    nrpy_odiegm_kernel kernel;
+    // Optional, a step of this exact table with every stage written out. nrpy_odiegm_evolve_apply 
+    // uses it in place of its own loop over the table, with the same answer. NULL means no kernel. 
+    // The built-in tables leave this NULL: their kernels are generated by nrpy_odiegm_codegen.py 
+    // into nrpy_odiegm_kernels.c and found by nrpy_odiegm_builtin_kernel, so nothing in this 
+    // header needs them to link. 
 
     //Two of these step_type "objects" might be needed at once, depending on implementation. 
     //Fortunately you can make as many as you want. 
@@ -77,6 +180,77 @@ typedef struct {
   void *y_values; // The extremely funky parameter that hides a 2D array, used when
   // the past steps are important for AB method.  
   // Stored in step struct since it needs access to adams_bashforth_order for allocation.
+  double *jacobian; // df/dy, dimension x dimension, row-major. 
+  // If the system has a sparsity pattern, this holds only the nonzeros, in CSR order. 
+  double *dfdx; // df/dx, Rosenbrock methods need it when the system depends on x. 
+  double *lu; // LU decomposition of the iteration matrix (I - h*gamma*J). Band storage if sparse. 
+  int *pivots; // Row swaps from the LU decomposition.
+  double *jacobian_work; // Scratch for the finite difference Jacobian, NULL if the system has its own. 
+  double **jacobian_lanes; // Where each batched evaluation's y and f live, if the system is batched. 
+  // The arrays above are allocated the first time an implicit method needs them, NULL until then. 
+  // Their size depends on the system, which the step "object" doesn't know about until then. 
+  int krylov_dimension; // 0 (the default) stores the Jacobian. Above 0 the implicit methods go matrix-free: 
+  // linear solves are done by restarted GMRES with this many basis vectors, 
+  // and J*v comes from a directional finite difference of the system's function. 
+  // Set with nrpy_odiegm_step_set_matrix_free. Memory is then O(dimension*krylov_dimension). 
+  double krylov_tolerance; // GMRES stops once the residual is this fraction of where it started. 
+  // Defaults to 1e-6. Rosenbrock methods need it that tight, since no Newton iteration cleans up after 
+  // GMRES. ESDIRK3 does fine with much looser, 1e-2 say, and saves iterations. 
+  int krylov_max_restarts; // How many times GMRES may start over before giving up.
+  double krylov_x; // Where J is "evaluated" in matrix-free mode: we store the point 
+  double *krylov_y; // and the function there instead of J itself. 
+  double *krylov_f; 
+  double *krylov_basis; // (krylov_dimension+1) x dimension, the Arnoldi vectors.
+  double *krylov_work; // Three more vectors of scratch space for GMRES.
+  unsigned long int krylov_iterations; // How many GMRES iterations (J*v products) we've done in total.
+  double lu_h_gamma; // The h*gamma the stored LU decomposition was built with, 0 if there isn't one.
+  bool jacobian_current; // Was the stored Jacobian evaluated at the start of the current step?
+  bool jacobian_refresh; // Set when Newton converges slowly, asks for a fresh Jacobian next step. 
+  unsigned long int jacobian_count; // How many Jacobians we've evaluated.
+  unsigned long int lu_count; // How many LU decompositions we've done. 
+  // Decompositions are the expensive part of an implicit step, so we keep count. 
+  const nrpy_odiegm_step_type *nonstiff_type; // The explicit method we started with.
+  const nrpy_odiegm_step_type *stiff_type; // The implicit method we switch to when things get stiff.
+  // NULL (the default) turns stiffness switching off. Set with nrpy_odiegm_step_set_stiff_switching. 
+  double stiffness_threshold; // h*lambda above which the explicit method is limited by stability, not accuracy.
+  // Defaults to 3.25, the edge of DP5's stability region along the negative real axis. 
+  int stiff_count; // How many steps in a row have looked stiff.
+  int nonstiff_count; // How many steps in a row haven't. 
+  unsigned long int switch_count; // How many times we've switched methods. 
+  bool fsal_valid; // Do we know f at the start of the next step? 
+  double fsal_x; // "First same as last" methods (ADP5, Tsit5) end every step by evaluating f at 
+  double *fsal_y; // the new point, which is exactly the first stage of the next step. 
+  double *fsal_f; // We keep it, and the next step skips that evaluation if it starts at fsal_x, fsal_y. 
+  // (It checks, since the user is free to change y between steps.) 
+  double dense_x; // Where the last accepted step started, 
+  double dense_h; // how long it was, 
+  double *dense_y; // the y it started from, 
+  double *dense_k; // and its stages (step*f, one row per stage). Only kept for methods with an interpolant. 
+  int dense_stages; // How many stages dense_k has room for. 
+  const nrpy_odiegm_step_type *dense_type; // The method that took the step, for its interpolant. 
+  bool dense_valid; // Is there a step to interpolate in? 
+  int extrapolation_columns; // How many columns the next extrapolation step builds (order 2*columns). 
+  // Adapted after every step to whatever costs the least work, 0 until the first step picks one. 
+  int extrapolation_columns_used; // How many the last extrapolation step actually built. 
+  int extrapolation_threads; // How many threads the midpoint sequences are spread over, 1 by default. 
+  // Set with nrpy_odiegm_step_set_extrapolation_threads. Needs a system function that's safe to call 
+  // from several threads at once, and OpenMP at compile time, otherwise it runs serially. 
+  double *extrapolation_table; // The extrapolation tableau, one row per column. 
+  double *extrapolation_work; // f(x,y), then four vectors of scratch space for every midpoint sequence. 
+  // These two are allocated on the first extrapolation step, NULL until then. 
+  double *low_storage_registers; // The low-storage methods' working register, the running stage 
+  // combination, 1 x dimension. Allocated on the first low-storage step. 
+  double *stage_work; // Scratch space for nrpy_odiegm_evolve_apply and the other drivers: the K-values, 
+  size_t stage_work_size; // the stage input, both solutions, f at either end of the step. 
+  double *method_work; // The same for the single-step routines they call: step doubling, 
+  size_t method_work_size; // the Rosenbrock and ESDIRK steps, Nystrom, splitting, the first step estimate. 
+  // All of this is a few times the size of the state, far too much for the stack once the system is 
+  // big (a 3D grid of gridfunctions), so it's on the heap. Allocated on the first step that needs it, 
+  // and grown if a later step needs more (a switch to a method with more stages). 
+  int parallel_threshold; // Systems with at least this many equations have their stage combinations 
+  // (y + sum a_ij k_j for every stage, and the final answers) split over threads, if compiled with OpenMP. 
+  // 100000 by default, below that the threads cost more than they save. The system's function is 
+  // still called from one thread, it's up to the user to parallelize that. 
 } nrpy_odiegm_step;
 
 typedef struct {
@@ -96,6 +270,18 @@ typedef struct {
     // We added these ourselves. Control the error!
     // We suppose this means that our control struct acts NOTHING like GSL's control struct
     // save that it stores error limits. 
+    double *abs_lim_vector; // Per-component absolute error limits. NULL means abs_lim is used for all.
+    double *rel_lim_vector; // Per-component relative error limits. Set alongside abs_lim_vector.
+    double *error_weight; // 1 if a component takes part in step control, 0 if it's ignored.
+    double error_weight_sum; // How many components take part in step control.
+    // The three arrays above are set with nrpy_odiegm_control_set_tolerances.
+    int error_norm; // How errors of all the components are combined. 0 is the max norm, 1 is the RMS norm.
+    int gridfunctions; // 0 (the default) means y is just a list of numbers. Above 0, y is this many 
+    // NRPy+ gridfunctions one after another (IDX4S order: gridfunction, then the third direction, 
+    // then the second, then the first), and the ghost zones are left out of the error estimate. 
+    // Set with nrpy_odiegm_control_set_gridfunctions. 
+    int grid_size[3]; // Nxx_plus_2NGHOSTS in each direction. 
+    int grid_ghosts[3]; // NGHOSTS in each direction, 0 in any direction too small to have them. 
 } nrpy_odiegm_control;
 
 typedef struct
@@ -109,6 +295,8 @@ typedef struct
   double current_position; // It's a good idea to know where we are at any given time. 
   unsigned long int count; // Equivalent to i. Keeps track of steps taken.
   bool no_adaptive_step; // A simple toggle for forcing the steps to be the same or not.
+  // y0 may be NULL, in which case nothing is copied there. For a big state (gridfunctions, 
+  // see nrpy_odiegm_driver_alloc_gridfunctions) that copy is a whole extra pass through memory every step. 
 } nrpy_odiegm_evolve;
 
 
@@ -123,6 +311,36 @@ typedef struct {
     // Usually it's passed to functions directly though. 
 } nrpy_odiegm_driver;
 
+typedef struct {
+    // Parareal: solves a long interval in parallel-in-time. The interval is cut into slices, 
+    // a cheap coarse method sweeps through them serially, and the accurate fine method 
+    // (which is where the time goes) redoes every slice at once on separate threads. 
+    // Each iteration corrects the slice boundaries with the difference between the two, 
+    // and once the corrections stop mattering the answer is the fine method's. 
+    // Built from the same step/evolve/control "objects" as the driver. 
+    const nrpy_odiegm_system *sys; // ODE system 
+    nrpy_odiegm_control *c; // Shared by every solve. Sets the fine method's error limits, 
+    // and the corrections are measured against them to decide when we're done. 
+    int slices; // How many pieces the interval is cut into. 
+    nrpy_odiegm_step *coarse_s; // The coarse method, which takes fixed steps... 
+    nrpy_odiegm_evolve *coarse_e; 
+    double coarse_step; // ...this big. 0 or less means one step per slice. 
+    nrpy_odiegm_step **fine_s; // The fine method gets its own step and evolve "object" for every slice, 
+    nrpy_odiegm_evolve **fine_e; // so the slices can run at the same time, 
+    double *fine_h; // and every slice remembers its step size from one iteration to the next. 
+    double *u; // The solution at the slice boundaries, (slices+1) x dimension. 
+    double *coarse; // The coarse solution at the end of every slice, from the last sweep. 
+    double *fine; // The fine solution at the end of every slice, from the last sweep. 
+    int max_iterations; // Give up after this many iterations (never more than slices, 
+    // since then every slice boundary is already exactly the fine solution). 
+    double tolerance; // We're done when no slice boundary moves by more than tolerance times 
+    // the allowed error. 1 (the default) means "less than the fine method's own error". 
+    int threads; // How many threads the fine solves are spread over, 1 by default. 
+    // As with the extrapolation methods, the system's function must be thread-safe for more than 1. 
+    int iterations; // How many iterations the last solve took.
+    double correction; // The biggest correction in the last iteration, relative to the allowed error. 
+} nrpy_odiegm_parareal;
+
 
 
 // A collection of butcher tables, courtesy of NRPy+.
@@ -130,57 +348,57 @@ typedef struct {
 // Specifically of all the various kinds of stepper methods we have on offer. 
 
 double butcher_Euler[2][2] = {{0.0,0.0},{1.0,1.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_euler0 = {2,2,1,&butcher_Euler};
+const nrpy_odiegm_step_type nrpy_odiegm_step_euler0 = {2,2,1,0,&butcher_Euler,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_euler = &nrpy_odiegm_step_euler0;
 
 double butcher_RK2H[3][3] = {{0.0,0.0,0.0},{1.0,1.0,0.0},{2.0,1.0/2.0,1.0/2.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK2_Heun0 = {3,3,2,&butcher_RK2H};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK2_Heun0 = {3,3,2,0,&butcher_RK2H,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_RK2_Heun = &nrpy_odiegm_step_RK2_Heun0;
 
 double butcher_RK2MP[3][3] = {{0.0,0.0,0.0},{1.0/2.0,1.0/2.0,0.0},{2.0,0.0,1.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK2_MP0 = {3,3,2,&butcher_RK2MP};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK2_MP0 = {3,3,2,0,&butcher_RK2MP,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_RK2_MP = &nrpy_odiegm_step_RK2_MP0;
 
 double butcher_RK2R[3][3] = {{0.0,0.0,0.0},{2.0/3.0,2.0/3.0,0.0},{2.0,1.0/4.0,3.0/4.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK2_R0 = {3,3,2,&butcher_RK2R};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK2_R0 = {3,3,2,0,&butcher_RK2R,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_RK2_Ralston = &nrpy_odiegm_step_RK2_R0;
 
 double butcher_RK3[4][4] = {{0.0,0.0,0.0,0.0},{1.0/2.0,1.0/2.0,0.0,0.0},{1.0,-1.0,2.0,0.0},{3.0,1.0/6.0,2.0/3.0,1.0/6.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_0 = {4,4,3,&butcher_RK3};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_0 = {4,4,3,0,&butcher_RK3,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_RK3 = &nrpy_odiegm_step_RK3_0;
 
 double butcher_RK3H[4][4] = {{0.0,0.0,0.0,0.0},{1.0/3.0,1.0/3.0,0.0,0.0},{2.0/3.0,0.0,2.0/3.0,0.0},{3.0,1.0/4.0,0.0,3.0/4.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_H0 = {4,4,3,&butcher_RK3H};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_H0 = {4,4,3,0,&butcher_RK3H,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_RK3_Heun = &nrpy_odiegm_step_RK3_H0;
 
 double butcher_RK3R[4][4] = {{0.0,0.0,0.0,0.0},{1.0/2.0,1.0/2.0,0.0,0.0},{3.0/4.0,0.0,3.0/4.0,0.0},{3.0,2.0/9.0,1.0/3.0,4.0/9.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_R0 = {4,4,3,&butcher_RK3R};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_R0 = {4,4,3,0,&butcher_RK3R,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_RK3_Ralston = &nrpy_odiegm_step_RK3_R0;
 
 double butcher_RK3S[4][4] = {{0.0,0.0,0.0,0.0},{1.0,1.0,0.0,0.0},{1.0/2.0,1.0/4.0,1.0/4.0,0.0},{3.0,1.0/6.0,1.0/6.0,2.0/3.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_S0 = {4,4,3,&butcher_RK3S};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK3_S0 = {4,4,3,0,&butcher_RK3S,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_SSPRK3 = &nrpy_odiegm_step_RK3_S0;
 
 double butcher_RK4[5][5] = {{0.0,0.0,0.0,0.0,0.0},{1.0/2.0,1.0/2.0,0.0,0.0,0.0},{1.0/2.0,0.0,1.0/2.0,0.0,0.0},{1.0,0.0,0.0,1.0,0.0},{4.0,1.0/6.0,1.0/3.0,1.0/3.0,1.0/6.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_RK4_0 = {5,5,4,&butcher_RK4};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RK4_0 = {5,5,4,0,&butcher_RK4,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_RK4 = &nrpy_odiegm_step_RK4_0;
 // This alternate name is declared for gsl drop in requirements. 
 const nrpy_odiegm_step_type *nrpy_odiegm_step_rk4 = &nrpy_odiegm_step_RK4_0;
 
 double butcher_DP5[8][8] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/5.0,1.0/5.0,0.0,0.0,0.0,0.0,0.0,0.0},{3.0/10.0,3.0/40.0,9.0/40.0,0.0,0.0,0.0,0.0,0.0},{4.0/5.0,44.0/45.0,-56.0/15.0,32.0/9.0,0.0,0.0,0.0,0.0},{8.0/9.0,19372.0/6561.0,-25360.0/2187.0,64448.0/6561.0,-212.0/729.0,0.0,0.0,0.0},{1.0,9017.0/3168.0,-355.0/33.0,46732.0/5247.0,49.0/176.0,-5103.0/18656.0,0.0,0.0},{1.0,35.0/384.0,0.0,500.0/1113.0,125.0/192.0,-2187.0/6784.0,11.0/84.0,0.0},{5.0,35.0/384.0,0.0,500.0/1113.0,125.0/192.0,-2187.0/6784.0,11.0/84.0,0.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_DP5_0 = {8,8,5,&butcher_DP5};
+const nrpy_odiegm_step_type nrpy_odiegm_step_DP5_0 = {8,8,5,0,&butcher_DP5,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_DP5 = &nrpy_odiegm_step_DP5_0;
 
 double butcher_DP5A[8][8] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/10.0,1.0/10.0,0.0,0.0,0.0,0.0,0.0,0.0},{2.0/9.0,-2.0/81.0,20.0/81.0,0.0,0.0,0.0,0.0,0.0},{3.0/7.0,615.0/1372.0,-270.0/343.0,1053.0/1372.0,0.0,0.0,0.0,0.0},{3.0/5.0,3243.0/5500.0,-54.0/55.0,50949.0/71500.0,4998.0/17875.0,0.0,0.0,0.0},{4.0/5.0,-26492.0/37125.0,72.0/55.0,2808.0/23375.0,-24206.0/37125.0,338.0/459.0,0.0,0.0},{1.0,5561.0/2376.0,-35.0/11.0,-24117.0/31603.0,899983.0/200772.0,-5225.0/1836.0,3925.0/4056.0,0.0},{5.0,821.0/10800.0,0.0,19683.0/71825.0,175273.0/912600.0,395.0/3672.0,785.0/2704.0,3.0/50.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_DP5A_0 = {8,8,5,&butcher_DP5A};
+const nrpy_odiegm_step_type nrpy_odiegm_step_DP5A_0 = {8,8,5,0,&butcher_DP5A,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_DP5alt = &nrpy_odiegm_step_DP5A_0;
 
 double butcher_CK5[7][7] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/5.0,1.0/5.0,0.0,0.0,0.0,0.0,0.0},{3.0/10.0,3.0/40.0,9.0/40.0,0.0,0.0,0.0,0.0},{3.0/5.0,3.0/10.0,-9.0/10.0,6.0/5.0,0.0,0.0,0.0},{1.0,-11.0/54.0,5.0/2.0,-70.0/27.0,35.0/27.0,0.0,0.0},{7.0/8.0,1631.0/55296.0,175.0/512.0,575.0/13824.0,44275.0/110592.0,253.0/4096.0,0.0},{5.0,37.0/378.0,0.0,250.0/621.0,125.0/594.0,0.0,512.0/1771.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_CK5_0 = {7,7,5,&butcher_CK5};
+const nrpy_odiegm_step_type nrpy_odiegm_step_CK5_0 = {7,7,5,0,&butcher_CK5,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_CK5 = &nrpy_odiegm_step_CK5_0;
 
 double butcher_DP6[9][9] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/10.0,1.0/10.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{2.0/9.0,-2.0/81.0,20.0/81.0,0.0,0.0,0.0,0.0,0.0,0.0},{3.0/7.0,615.0/1372.0,-270.0/343.0,1053.0/1372.0,0.0,0.0,0.0,0.0,0.0},{3.0/5.0,3243.0/5500.0,-54.0/55.0,50949.0/71500.0,4998.0/17875.0,0.0,0.0,0.0,0.0},{4.0/5.0,-26492.0/37125.0,72.0/55.0,2808.0/23375.0,-24206.0/37125.0,338.0/459.0,0.0,0.0,0.0},{1.0,5561.0/2376.0,-35.0/11.0,-24117.0/31603.0,899983.0/200772.0,-5225.0/1836.0,3925.0/4056.0,0.0,0.0},{1.0,465467.0/266112.0,-2945.0/1232.0,-5610201.0/14158144.0,10513573.0/3212352.0,-424325.0/205632.0,376225.0/454272.0,0.0,0.0},{6.0,61.0/864.0,0.0,98415.0/321776.0,16807.0/146016.0,1375.0/7344.0,1375.0/5408.0,-37.0/1120.0,1.0/10.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_DP6_0 = {9,9,6,&butcher_DP6};
+const nrpy_odiegm_step_type nrpy_odiegm_step_DP6_0 = {9,9,6,0,&butcher_DP6,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_DP6 = &nrpy_odiegm_step_DP6_0;
 
 // This one is left in terms of floating points, as the form stored in 
@@ -189,50 +407,200 @@ const nrpy_odiegm_step_type *nrpy_odiegm_step_DP6 = &nrpy_odiegm_step_DP6_0;
 // const double sqrt21 = 4.58257569495584; //explicitly declared to avoid the funky problems with consts. 
 // Manually added to the below definition since Visual Studio complained sqrt21 wasn't a constant.
 double butcher_L6[8][8] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0,1.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/2.0,3.0/8.0,1.0/8.0,0.0,0.0,0.0,0.0,0.0},{2.0/3.0,8.0/27.0,2.0/27.0,8.0/27.0,0.0,0.0,0.0,0.0},{1.0/2.0 - 4.58257569495584/14.0,-3.0/56.0 + 9.0*4.58257569495584/392.0,-1.0/7.0 + 4.58257569495584/49.0,6.0/7.0 - 6.0*4.58257569495584/49.0,-9.0/56.0 + 3.0*4.58257569495584/392.0,0.0,0.0,0.0},{4.58257569495584/14.0 + 1.0/2.0,-51.0*4.58257569495584/392.0 - 33.0/56.0,-1.0/7.0 - 4.58257569495584/49.0,-8.0*4.58257569495584/49.0,9.0/280.0 + 363.0*4.58257569495584/1960.0,4.58257569495584/5.0 + 6.0/5.0,0.0,0.0},{1.0,11.0/6.0 + 7.0*4.58257569495584/12.0,2.0/3.0,-10.0/9.0 + 14.0*4.58257569495584/9.0,7.0/10.0 - 21.0*4.58257569495584/20.0,-343.0/90.0 - 7.0*4.58257569495584/10.0,49.0/18.0 - 7.0*4.58257569495584/18.0,0.0},{6.0,1.0/20.0,0.0,16.0/45.0,0.0,49.0/180.0,49.0/180.0,1.0/20.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_L6_0 = {8,8,6,&butcher_L6};
+const nrpy_odiegm_step_type nrpy_odiegm_step_L6_0 = {8,8,6,0,&butcher_L6,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_L6 = &nrpy_odiegm_step_L6_0;
 
 double butcher_DP8[14][14] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/18.0,1.0/18.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/12.0,1.0/48.0,1.0/16.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/8.0,1.0/32.0,0.0,3.0/32.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{5.0/16.0,5.0/16.0,0.0,-75.0/64.0,75.0/64.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{3.0/8.0,3.0/80.0,0.0,0.0,3.0/16.0,3.0/20.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{59.0/400.0,29443841.0/614563906.0,0.0,0.0,77736538.0/692538347.0,-28693883.0/1125000000.0,23124283.0/1800000000.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{93.0/200.0,16016141.0/946692911.0,0.0,0.0,61564180.0/158732637.0,22789713.0/633445777.0,545815736.0/2771057229.0,-180193667.0/1043307555.0,0.0,0.0,0.0,0.0,0.0,0.0},{5490023248.0/9719169821.0,39632708.0/573591083.0,0.0,0.0,-433636366.0/683701615.0,-421739975.0/2616292301.0,100302831.0/723423059.0,790204164.0/839813087.0,800635310.0/3783071287.0,0.0,0.0,0.0,0.0,0.0},{13.0/20.0,246121993.0/1340847787.0,0.0,0.0,-37695042795.0/15268766246.0,-309121744.0/1061227803.0,-12992083.0/490766935.0,6005943493.0/2108947869.0,393006217.0/1396673457.0,123872331.0/1001029789.0,0.0,0.0,0.0,0.0},{1201146811.0/1299019798.0,-1028468189.0/846180014.0,0.0,0.0,8478235783.0/508512852.0,1311729495.0/1432422823.0,-10304129995.0/1701304382.0,-48777925059.0/3047939560.0,15336726248.0/1032824649.0,-45442868181.0/3398467696.0,3065993473.0/597172653.0,0.0,0.0,0.0},{1.0,185892177.0/718116043.0,0.0,0.0,-3185094517.0/667107341.0,-477755414.0/1098053517.0,-703635378.0/230739211.0,5731566787.0/1027545527.0,5232866602.0/850066563.0,-4093664535.0/808688257.0,3962137247.0/1805957418.0,65686358.0/487910083.0,0.0,0.0},{1.0,403863854.0/491063109.0,0.0,0.0,-5068492393.0/434740067.0,-411421997.0/543043805.0,652783627.0/914296604.0,11173962825.0/925320556.0,-13158990841.0/6184727034.0,3936647629.0/1978049680.0,-160528059.0/685178525.0,248638103.0/1413531060.0,0.0,0.0},{8.0,14005451.0/335480064.0,0.0,0.0,0.0,0.0,-59238493.0/1068277825.0,181606767.0/758867731.0,561292985.0/797845732.0,-1041891430.0/1371343529.0,760417239.0/1151165299.0,118820643.0/751138087.0,-528747749.0/2220607170.0,1.0/4.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_DP8_0 = {14,14,8,&butcher_DP8};
+const nrpy_odiegm_step_type nrpy_odiegm_step_DP8_0 = {14,14,8,0,&butcher_DP8,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_DP8 = &nrpy_odiegm_step_DP8_0;
 
 // Adaptive Methods
 double butcher_AHE[4][3] = {{0.0,0.0,0.0},{1.0,1.0,0.0},{2.0,1.0/2.0,1.0/2.0},{2.0,1.0,0.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_AHE_0 = {4,3,2,&butcher_AHE};
+const nrpy_odiegm_step_type nrpy_odiegm_step_AHE_0 = {4,3,2,0,&butcher_AHE,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_AHE = &nrpy_odiegm_step_AHE_0;
 // This alternate name is declared because of the need for GSL drop in. 
 const nrpy_odiegm_step_type *nrpy_odiegm_step_rk2 = &nrpy_odiegm_step_AHE_0;
 
 double butcher_ABS[6][5] = {{0.0,0.0,0.0,0.0,0.0},{1.0/2.0,1.0/2.0,0.0,0.0,0.0},{3.0/4.0,0.0,3.0/4.0,0.0,0.0},{1.0,2.0/9.0,1.0/3.0,4.0/9.0,0.0},{3.0,2.0/9.0,1.0/3.0,4.0/9.0,0.0},{3.0,7.0/24.0,1.0/4.0,1.0/3.0,1.0/8.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_ABS_0 = {6,5,3,&butcher_ABS};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ABS_0 = {6,5,3,0,&butcher_ABS,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_ABS = &nrpy_odiegm_step_ABS_0;
 
 double butcher_ARKF[8][7] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/4.0,1.0/4.0,0.0,0.0,0.0,0.0,0.0},{3.0/8.0,3.0/32.0,9.0/32.0,0.0,0.0,0.0,0.0},{12.0/13.0,1932.0/2197.0,-7200.0/2197.0,7296.0/2197.0,0.0,0.0,0.0},{1.0,439.0/216.0,-8.0,3680.0/513.0,-845.0/4104.0,0.0,0.0},{1.0/2.0,-8.0/27.0,2.0,-3544.0/2565.0,1859.0/4104.0,-11.0/40.0,0.0},{5.0,16.0/135.0,0.0,6656.0/12825.0,28561.0/56430.0,-9.0/50.0,2.0/55.0},{5.0,25.0/216.0,0.0,1408.0/2565.0,2197.0/4104.0,-1.0/5.0,0.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_ARKF_0 = {8,7,5,&butcher_ARKF};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ARKF_0 = {8,7,5,0,&butcher_ARKF,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_ARKF = &nrpy_odiegm_step_ARKF_0;
 // This alternate name is declared because of the need for GSL drop in. 
 const nrpy_odiegm_step_type *nrpy_odiegm_step_rkf45 = &nrpy_odiegm_step_ARKF_0;
 
 double butcher_ACK[8][7] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/5.0,1.0/5.0,0.0,0.0,0.0,0.0,0.0},{3.0/10.0,3.0/40.0,9.0/40.0,0.0,0.0,0.0,0.0},{3.0/5.0,3.0/10.0,-9.0/10.0,6.0/5.0,0.0,0.0,0.0},{1.0,-11.0/54.0,5.0/2.0,-70.0/27.0,35.0/27.0,0.0,0.0},{7.0/8.0,1631.0/55296.0,175.0/512.0,575.0/13824.0,44275.0/110592.0,253.0/4096.0,0.0},{5.0,37.0/378.0,0.0,250.0/621.0,125.0/594.0,0.0,512.0/1771.0},{5.0,2825.0/27648.0,0.0,18575.0/48384.0,13525.0/55296.0,277.0/14336.0,1.0/4.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_ACK_0 = {8,7,5,&butcher_ACK};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ACK_0 = {8,7,5,0,&butcher_ACK,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_ACK = &nrpy_odiegm_step_ACK_0;
 // This alternate name is declared because of the need for GSL drop in. 
 const nrpy_odiegm_step_type *nrpy_odiegm_step_rkck = &nrpy_odiegm_step_ACK_0;
 
 double butcher_ADP5[9][8] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/5.0,1.0/5.0,0.0,0.0,0.0,0.0,0.0,0.0},{3.0/10.0,3.0/40.0,9.0/40.0,0.0,0.0,0.0,0.0,0.0},{4.0/5.0,44.0/45.0,-56.0/15.0,32.0/9.0,0.0,0.0,0.0,0.0},{8.0/9.0,19372.0/6561.0,-25360.0/2187.0,64448.0/6561.0,-212.0/729.0,0.0,0.0,0.0},{1.0,9017.0/3168.0,-355.0/33.0,46732.0/5247.0,49.0/176.0,-5103.0/18656.0,0.0,0.0},{1.0,35.0/384.0,0.0,500.0/1113.0,125.0/192.0,-2187.0/6784.0,11.0/84.0,0.0},{5.0,35.0/384.0,0.0,500.0/1113.0,125.0/192.0,-2187.0/6784.0,11.0/84.0,0.0},{5.0,5179.0/57600.0,0.0,7571.0/16695.0,393.0/640.0,-92097.0/339200.0,187.0/2100.0,1.0/40.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_ADP5_0 = {9,8,5,&butcher_ADP5};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ADP5_0 = {9,8,5,0,&butcher_ADP5,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_ADP5 = &nrpy_odiegm_step_ADP5_0;
 
 double butcher_ADP8[15][14] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/18.0,1.0/18.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/12.0,1.0/48.0,1.0/16.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/8.0,1.0/32.0,0.0,3.0/32.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{5.0/16.0,5.0/16.0,0.0,-75.0/64.0,75.0/64.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{3.0/8.0,3.0/80.0,0.0,0.0,3.0/16.0,3.0/20.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{59.0/400.0,29443841.0/614563906.0,0.0,0.0,77736538.0/692538347.0,-28693883.0/1125000000.0,23124283.0/1800000000.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{93.0/200.0,16016141.0/946692911.0,0.0,0.0,61564180.0/158732637.0,22789713.0/633445777.0,545815736.0/2771057229.0,-180193667.0/1043307555.0,0.0,0.0,0.0,0.0,0.0,0.0},{5490023248.0/9719169821.0,39632708.0/573591083.0,0.0,0.0,-433636366.0/683701615.0,-421739975.0/2616292301.0,100302831.0/723423059.0,790204164.0/839813087.0,800635310.0/3783071287.0,0.0,0.0,0.0,0.0,0.0},{13.0/20.0,246121993.0/1340847787.0,0.0,0.0,-37695042795.0/15268766246.0,-309121744.0/1061227803.0,-12992083.0/490766935.0,6005943493.0/2108947869.0,393006217.0/1396673457.0,123872331.0/1001029789.0,0.0,0.0,0.0,0.0},{1201146811.0/1299019798.0,-1028468189.0/846180014.0,0.0,0.0,8478235783.0/508512852.0,1311729495.0/1432422823.0,-10304129995.0/1701304382.0,-48777925059.0/3047939560.0,15336726248.0/1032824649.0,-45442868181.0/3398467696.0,3065993473.0/597172653.0,0.0,0.0,0.0},{1.0,185892177.0/718116043.0,0.0,0.0,-3185094517.0/667107341.0,-477755414.0/1098053517.0,-703635378.0/230739211.0,5731566787.0/1027545527.0,5232866602.0/850066563.0,-4093664535.0/808688257.0,3962137247.0/1805957418.0,65686358.0/487910083.0,0.0,0.0},{1.0,403863854.0/491063109.0,0.0,0.0,-5068492393.0/434740067.0,-411421997.0/543043805.0,652783627.0/914296604.0,11173962825.0/925320556.0,-13158990841.0/6184727034.0,3936647629.0/1978049680.0,-160528059.0/685178525.0,248638103.0/1413531060.0,0.0,0.0},{8.0,14005451.0/335480064.0,0.0,0.0,0.0,0.0,-59238493.0/1068277825.0,181606767.0/758867731.0,561292985.0/797845732.0,-1041891430.0/1371343529.0,760417239.0/1151165299.0,118820643.0/751138087.0,-528747749.0/2220607170.0,1.0/4.0},{8.0,13451932.0/455176623.0,0.0,0.0,0.0,0.0,-808719846.0/976000145.0,1757004468.0/5645159321.0,656045339.0/265891186.0,-3867574721.0/1518517206.0,465885868.0/322736535.0,53011238.0/667516719.0,2.0/45.0,0.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_ADP8_0 = {15,14,8,&butcher_ADP8};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ADP8_0 = {15,14,8,0,&butcher_ADP8,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_ADP8 = &nrpy_odiegm_step_ADP8_0;
 // This alternate name is declared because of the need for GSL drop in. 
 const nrpy_odiegm_step_type *nrpy_odiegm_step_rk8pd = &nrpy_odiegm_step_ADP8_0;
 
+// Tsitouras 5(4), 2011. Same cost per step as ADP5 (seven stages, "first same as last", 
+// so six evaluations a step) but with smaller error coefficients, so it takes fewer steps.
+// The weights are the free 4th order interpolant from the same paper (one row per power of theta).
+double butcher_Tsit5[9][8] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.161,0.161,0.0,0.0,0.0,0.0,0.0,0.0},{0.327,-0.008480655492356989,0.335480655492357,0.0,0.0,0.0,0.0,0.0},{0.9,2.897153057105493,-6.359448489975075,4.3622954328695815,0.0,0.0,0.0,0.0},{0.9800255409045097,5.325864828439257,-11.748883564062828,7.4955393428898365,-0.09249506636175525,0.0,0.0,0.0},{1.0,5.86145544294642,-12.92096931784711,8.159367898576159,-0.071584973281401,-0.028269050394068383,0.0,0.0},{1.0,0.09646076681806523,0.01,0.4798896504144996,1.379008574103742,-3.290069515436081,2.324710524099774,0.0},{5.0,0.09646076681806523,0.01,0.4798896504144996,1.379008574103742,-3.290069515436081,2.324710524099774,0.0},{5.0,0.09824077787029101,0.010816434459656746,0.4720087724042376,1.5237195812770048,-3.872426680888636,2.7827926300289607,-0.015151515151515152}};
+double interpolant_Tsit5[4][8] = {{1.0,1.0,0.0,0.0,0.0,0.0,0.0,0.0},{2.0,-2.763706197274826,0.1317,3.930296236894751,-12.411077166933676,37.50931341651104,-27.896526289197286,1.5},{3.0,2.9132554618219126,-0.2234,-5.941033872131505,30.33818863028232,-88.1789048947664,65.09189467479368,-4.0},{4.0,-1.0530884977290216,0.1017,2.490627285651253,-16.548102889244902,47.37952196281928,-34.87065786149661,2.5}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Tsit5_0 = {9,8,5,0,&butcher_Tsit5,4,&interpolant_Tsit5,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Tsit5 = &nrpy_odiegm_step_Tsit5_0;
+
+// Verner's "most efficient" 6(5) pair, 2010. Nine stages, the last of them f at the answer, 
+// so like Tsit5 it's reused as the first stage of the next step and a step costs eight evaluations. 
+// The fifth order weights are the pair's own, the one set the order conditions allow that gives 
+// the seventh stage no weight. 
+double butcher_Vern6[11][10] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.06,0.06,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.09593333333333333,0.019239962962962962,0.07669337037037037,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.1439,0.035975,0.0,0.107925,0.0,0.0,0.0,0.0,0.0,0.0},{0.4973,1.3186834152331484,0.0,-5.042058063628562,4.220674648395414,0.0,0.0,0.0,0.0,0.0},{0.9725,-41.872591664327516,0.0,159.4325621631375,-122.11921356501003,5.531743066200054,0.0,0.0,0.0,0.0},{0.9995,-54.43015693531651,0.0,207.06725136501848,-158.61081378459,6.991816585950242,-0.018597231062203234,0.0,0.0,0.0},{1.0,-54.66374178728198,0.0,207.95280625538936,-159.2889574744995,7.018743740796944,-0.018338785905045722,-0.0005119484997882099,0.0,0.0},{1.0,0.03438957868357036,0.0,0.0,0.2582624555633503,0.4209371189673537,4.40539646966931,-176.48311902429865,172.36413340141507,0.0},{6.0,0.03438957868357036,0.0,0.0,0.2582624555633503,0.4209371189673537,4.40539646966931,-176.48311902429865,172.36413340141507,0.0},{6.0,0.04909967648369985,0.0,0.0,0.22511122295186925,0.46946822530281707,0.8065792249992284,0.0,-0.6071194891780128,0.05686113944039828}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Vern6_0 = {11,10,6,0,&butcher_Vern6,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Vern6 = &nrpy_odiegm_step_Vern6_0;
+
+// Verner's "most efficient" 7(6) pair, 2010. Ten stages against ADP8's thirteen, for tight 
+// tolerances (1e-10 and below). Which of the two is cheaper depends on the problem, 
+// see nrpy_odiegm_benchmark.c. 
+// No dense output: Verner's interpolant needs six more evaluations a step, and the dense output 
+// here only has the step's own stages to work with. 
+double butcher_Vern7[12][11] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.005,0.005,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.10888888888888888,-1.07679012345679,1.185679012345679,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.16333333333333333,0.04083333333333333,0.0,0.1225,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.4555,0.6389139236255726,0.0,-2.455672638223657,2.272258714598084,0.0,0.0,0.0,0.0,0.0,0.0},{0.6095094489978381,-2.6615773750187572,0.0,10.804513886456137,-8.3539146573962,0.820487594956657,0.0,0.0,0.0,0.0,0.0},{0.884,6.067741434696772,0.0,-24.711273635911088,20.427517930788895,-1.9061579788166472,1.006172249242068,0.0,0.0,0.0,0.0},{0.925,12.054670076253203,0.0,-49.75478495046899,41.142888638604674,-4.461760149974004,2.042334822239175,-0.09834843665406107,0.0,0.0,0.0},{1.0,10.138146522881808,0.0,-42.6411360317175,35.76384003992257,-4.3480228403929075,2.0098622683770357,0.3487490460338272,-0.27143900510483127,0.0,0.0},{1.0,-45.030072034298676,0.0,187.3272437654589,-154.02882369350186,18.56465306347536,-7.141809679295079,1.3088085781613787,0.0,0.0,0.0},{7.0,0.04715561848627222,0.0,0.0,0.25750564298434153,0.26216653977412624,0.15216092656738558,0.4939969170032485,-0.29430311714032503,0.08131747232495111,0.0},{7.0,0.044608606606341174,0.0,0.0,0.26716403785713727,0.22010183001772932,0.2188431703143157,0.2289871705411204,0.0,0.0,0.02029518466335628}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Vern7_0 = {12,11,7,0,&butcher_Vern7,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Vern7 = &nrpy_odiegm_step_Vern7_0;
+
+// Verner's "most efficient" 9(8) pair, 2010. Sixteen stages, all needed every step (the last only 
+// for the estimate), for the very tightest tolerances (1e-12 and below, close to round off), 
+// where ninth order takes far fewer steps than ADP8 or Vern7. 
+double butcher_Vern9[18][17] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.03462,0.03462,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.09702435063878045,-0.0389335438857287,0.13595789452451,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.14553652595817068,0.03638413148954267,0.0,0.10915239446862801,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.561,2.0257639143939694,0.0,-7.638023836496292,6.173259922102322,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.22900791159048503,0.05112275589406061,0.0,0.0,0.17708237945550218,0.0008027762409222536,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.544992088409515,0.13160063579752163,0.0,0.0,-0.2957276252669636,0.08781378035642955,0.6213052975225274,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.645,0.07166666666666667,0.0,0.0,0.0,0.0,0.33055335789153195,0.2427799754418014,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.48375,0.071806640625,0.0,0.0,0.0,0.0,0.3294380283228177,0.1165190029271823,-0.034013671875,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.06757,0.04836757646340646,0.0,0.0,0.0,0.0,0.03928989925676164,0.10547409458903446,-0.021438652846483126,-0.10412291746271944,0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.25,-0.026645614872014785,0.0,0.0,0.0,0.0,0.03333333333333333,-0.1631072244872467,0.03396081684127761,0.1572319413814626,0.21522674780318796,0.0,0.0,0.0,0.0,0.0,0.0},{0.6590650618730999,0.03689009248708622,0.0,0.0,0.0,0.0,-0.1465181576725543,0.2242577768172024,0.02294405717066073,-0.0035850052905728597,0.08669223316444385,0.43838406519683376,0.0,0.0,0.0,0.0,0.0},{0.8206,-0.4866012215113341,0.0,0.0,0.0,0.0,-6.304602650282853,-0.2812456182894729,-2.679019236219849,0.5188156639241577,1.3653531876033418,5.8850910885039465,2.8028087862720636,0.0,0.0,0.0,0.0},{0.9012,0.4185367457753472,0.0,0.0,0.0,0.0,6.724547581906459,-0.42544428016461133,3.3432791530012653,0.6170816631175374,-0.9299661239399329,-6.099948804751011,-3.002206187889399,0.2553202529443446,0.0,0.0,0.0},{1.0,-0.7793740861228848,0.0,0.0,0.0,0.0,-13.937342538107776,1.2520488533793563,-14.691500408016868,-0.494705058533141,2.2429749091462368,13.367893803828643,14.396650486650687,-0.79758133317768,0.4409353709534278,0.0,0.0},{1.0,2.0580513374668867,0.0,0.0,0.0,0.0,22.357937727968032,0.9094981099755646,35.89110098240264,-3.442515027624454,-4.865481358036369,-18.909803813543427,-34.26354448030452,1.2647565216956427,0.0,0.0,0.0},{9.0,0.014611976858423152,0.0,0.0,0.0,0.0,0.0,0.0,-0.3915211862331339,0.23109325002895065,0.12747667699928525,0.2246434176204158,0.5684352689748513,0.058258715572158275,0.13643174034822156,0.030570139830827976,0.0},{9.0,0.01996996514886773,0.0,0.0,0.0,0.0,0.0,0.0,2.19149930494933,0.08857071848208439,0.11405602348659657,0.2533163805345107,-2.056564386240941,0.340809679901312,0.0,0.0,0.04834231373823958}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Vern9_0 = {18,17,9,0,&butcher_Vern9,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Vern9 = &nrpy_odiegm_step_Vern9_0;
+
+// Gragg-Bulirsch-Stoer extrapolation. Each column is the modified midpoint method with 
+// this many substeps, and the columns are extrapolated to zero substep size. 
+// The order changes from step to step (up to twice the number of columns), 
+// which makes these very efficient at tight tolerances on smooth problems. 
+// GBS uses the harmonic sequence (2, 4, 6, ...), the cheapest; GBS_Romberg doubles every column. 
+double butcher_GBS[1][10] = {{2.0,4.0,6.0,8.0,10.0,12.0,14.0,16.0,18.0,20.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_GBS_0 = {1,10,20,5,&butcher_GBS,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_GBS = &nrpy_odiegm_step_GBS_0;
+double butcher_GBS_Romberg[1][8] = {{2.0,4.0,8.0,16.0,32.0,64.0,128.0,256.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_GBS_Romberg_0 = {1,8,16,5,&butcher_GBS_Romberg,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_GBS_Romberg = &nrpy_odiegm_step_GBS_Romberg_0;
+
+// Runge-Kutta-Nystrom methods, for second order systems (see nrpy_odiegm_system_nystrom). 
+// Applied to y'' = f directly they need fewer stages than a Runge-Kutta method on the doubled system, 
+// and every stage only builds y, never y'. method_type 6, and the tables are laid out differently. For s stages: 
+// Rows 0 to s-1 hold {c_i, a_i1, a_i2, ...}: stage i evaluates f at y + c_i*h*y' + h^2*(sum a_ij f_j). 
+// Row s holds {order, bbar_1, bbar_2, ...}, the weights for y: y + h*y' + h^2*(sum bbar_j f_j). 
+// Row s+1 holds {order, b_1, b_2, ...}, the weights for y': y' + h*(sum b_j f_j). 
+// Rows s+2 and s+3, if there are any, are the same for the embedded solution. 
+
+// Nystrom's classic fourth order method. Three stages, no embedded method, so fixed steps only. 
+double butcher_Nystrom4[5][4] = {{0.0,0.0,0.0,0.0},{1.0/2.0,1.0/8.0,0.0,0.0},{1.0,0.0,1.0/2.0,0.0},{4.0,1.0/6.0,1.0/3.0,0.0},{4.0,1.0/6.0,2.0/3.0,1.0/6.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Nystrom4_0 = {5,4,4,6,&butcher_Nystrom4,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Nystrom4 = &nrpy_odiegm_step_Nystrom4_0;
+
+// The sixth order solution of RKN6(4)6FM (Dormand, El-Mikkawy and Prince 1987), six stages. 
+// The last stage is f at the new point, so it's "first same as last" and costs five evaluations a step. 
+// The pair's fourth order weights aren't here, so like Nystrom4 this takes fixed steps. 
+// (Neither is the 12(10) pair from the same authors, whose coefficients would have to be copied 
+// in from the paper.) 
+double butcher_RKN6[8][7] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0},{1.0/10.0,1.0/200.0,0.0,0.0,0.0,0.0,0.0},{3.0/10.0,-1.0/2200.0,1.0/22.0,0.0,0.0,0.0,0.0},{7.0/10.0,637.0/6600.0,-7.0/110.0,7.0/33.0,0.0,0.0,0.0},{17.0/25.0,225437.0/1968750.0,-30073.0/281250.0,65569.0/281250.0,-9367.0/984375.0,0.0,0.0},{1.0,151.0/2142.0,5.0/116.0,385.0/1368.0,55.0/168.0,-6250.0/28101.0,0.0},{6.0,151.0/2142.0,5.0/116.0,385.0/1368.0,55.0/168.0,-6250.0/28101.0,0.0},{6.0,151.0/2142.0,25.0/522.0,275.0/684.0,275.0/252.0,-78125.0/112404.0,1.0/12.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RKN6_0 = {8,7,6,6,&butcher_RKN6,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_RKN6 = &nrpy_odiegm_step_RKN6_0;
+
+// Symplectic methods, for separable Hamiltonian systems (see nrpy_odiegm_system_split). 
+// None of them have an error estimate, they take fixed steps. What they buy instead is that the 
+// energy error stays bounded over any number of steps rather than drifting, so a long orbit 
+// can be run at a much bigger step than an adaptive method would need to keep its drift down. 
+// method_type 7. Row 0 holds the drift coefficients a_i, row 1 the kick coefficients b_i. 
+// Every step does q += a_i*h*dq/dx(p), then p += b_i*h*dp/dx(q), for each i in turn. 
+// Kicks with a zero coefficient are skipped (they'd be a wasted evaluation). 
+
+// Stormer-Verlet (drift-kick-drift leapfrog). Second order, one evaluation of each derivative a step. 
+double butcher_Verlet[2][2] = {{1.0/2.0,1.0/2.0},{1.0,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Verlet_0 = {2,2,2,7,&butcher_Verlet,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Verlet = &nrpy_odiegm_step_Verlet_0;
+
+// Forest and Ruth 1990, fourth order. Three leapfrogs with weights 1/(2-2^(1/3)), 1-2/(2-2^(1/3)), 1/(2-2^(1/3)), 
+// which is also Yoshida's fourth order "triple jump". 
+double butcher_ForestRuth[2][4] = {{0.6756035959798289,-0.17560359597982889,-0.17560359597982889,0.6756035959798289},{1.3512071919596578,-1.7024143839193155,1.3512071919596578,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ForestRuth_0 = {2,4,4,7,&butcher_ForestRuth,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_ForestRuth = &nrpy_odiegm_step_ForestRuth_0;
+
+// Yoshida 1990, sixth and eighth order: symmetric compositions of 7 and 15 leapfrogs 
+// (his solutions A and D), with the neighboring drifts merged. 
+double butcher_Yoshida6[2][8] = {{0.39225680523878,0.5100434119184585,-0.47105338540975655,0.0687531682525181,0.0687531682525181,-0.47105338540975655,0.5100434119184585,0.39225680523878},{0.78451361047756,0.235573213359357,-1.17767998417887,1.3151863206839063,-1.17767998417887,0.235573213359357,0.78451361047756,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Yoshida6_0 = {2,8,6,7,&butcher_Yoshida6,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Yoshida6 = &nrpy_odiegm_step_Yoshida6_0;
+double butcher_Yoshida8[2][16] = {{0.45742212311487,0.5842687913979845,-0.5955794501471254,-0.8015464361143615,0.8899492511272584,-0.011235547676365032,-0.9289051917917525,0.9056264600894915,0.9056264600894915,-0.9289051917917525,-0.011235547676365032,0.8899492511272584,-0.8015464361143615,-0.5955794501471254,0.5842687913979845,0.45742212311487},{0.91484424622974,0.253693336566229,-1.44485223686048,-0.158240635368243,1.93813913762276,-1.96061023297549,0.102799849391985,1.708453070786998,0.102799849391985,-1.96061023297549,1.93813913762276,-0.158240635368243,-1.44485223686048,0.253693336566229,0.91484424622974,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Yoshida8_0 = {2,16,8,7,&butcher_Yoshida8,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Yoshida8 = &nrpy_odiegm_step_Yoshida8_0;
+
+// Blanes and Moan 2002, the six stage fourth order method (S6). Twice the kicks of Forest-Ruth, 
+// but a few hundred times less error at the same step, so it comes out well ahead for the same work. 
+double butcher_BlanesMoan[2][7] = {{0.0792036964311957,0.353172906049774,-0.0420650803577195,0.21937695575349958,-0.0420650803577195,0.353172906049774,0.0792036964311957},{0.209515106613362,-0.143851773179818,0.434336666566456,0.434336666566456,-0.143851773179818,0.209515106613362,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_BlanesMoan_0 = {2,7,4,7,&butcher_BlanesMoan,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_BlanesMoan = &nrpy_odiegm_step_BlanesMoan_0;
+
+// Low-storage Runge-Kutta methods, for systems so big that memory (and memory bandwidth) 
+// runs out before the processor does. Written in Williamson's 2N form, every stage is 
+// dq = A_i*dq + h*f(x + c_i*h, y), then y = y + B_i*dq, so no matter how many stages there are 
+// y is updated in place and only dq and f are kept besides, instead of one register per stage. 
+// That's three state-sized arrays, against the ~20 DP8 needs in nrpy_odiegm_evolve_apply. 
+// method_type 8. Row 0 holds A_i, row 1 B_i, row 2 c_i. 
+// Neither method has a published embedded solution in this form, so they take fixed steps. 
+
+// Williamson 1980, three stages, third order. 
+double butcher_Williamson3[3][4] = {{0.0,-5.0/9.0,-153.0/128.0,0.0},{1.0/3.0,15.0/16.0,8.0/15.0,0.0},{0.0,1.0/3.0,3.0/4.0,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_Williamson3_0 = {3,4,3,8,&butcher_Williamson3,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_Williamson3 = &nrpy_odiegm_step_Williamson3_0;
+
+// Carpenter and Kennedy 1994, RK4(3)5[2N]. Five stages, fourth order. 
+double butcher_CK4[3][6] = {{0.0,-567301805773.0/1357537059087.0,-2404267990393.0/2016746695238.0,-3550918686646.0/2091501179385.0,-1275806237668.0/842570457699.0,0.0},{1432997174477.0/9575080441755.0,5161836677717.0/13612068292357.0,1720146321549.0/2090206949498.0,3134564353537.0/4481467310338.0,2277821191437.0/14882151754819.0,0.0},{0.0,1432997174477.0/9575080441755.0,2526269341429.0/6820363962896.0,2006345519317.0/3224310063776.0,2802321613138.0/2924317926251.0,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_CK4_0 = {3,6,4,8,&butcher_CK4,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_CK4 = &nrpy_odiegm_step_CK4_0;
+
+// Implicit methods, for stiff systems. These need the Jacobian (see the system struct) 
+// and solve a linear system every stage, so they're only worth it when the explicit methods
+// are forced into tiny steps for stability rather than accuracy. 
+// The method_type (3 or 4) is set explicitly, the table shapes alone can't identify them. 
+
+// Rosenbrock tables are stored differently from the Butcher tables above. For s stages: 
+// Rows 0 to s-1 hold {alpha_i, A_i1, A_i2, ...}, the stage offsets and stage coefficients. 
+// Rows s to 2s-1 hold {gamma_i, C_i1, C_i2, ...}, the time-derivative weights and stage couplings. 
+// Row 2s holds {order, M_1, M_2, ...}, the weights of the solution. 
+// Row 2s+1 holds {gamma, E_1, E_2, ...}, the diagonal gamma and the weights of the error estimate. 
+// So every stage solves (I/(h*gamma) - J) U_i = f(x + alpha_i*h, y + sum A_ij U_j) + sum (C_ij/h) U_j + h*gamma_i*df/dx
+// (the form used by Hairer and Wanner's RODAS), and the J is evaluated once per step. 
+
+// ROS3P, Lang and Verwer 2001. Third order, A-stable, second order embedded. 
+// The error weights are the solution weights minus those of the embedded method. 
+double butcher_ROS3P[8][4] = {{0.0,0.0,0.0,0.0},{1.0,1.267949192431123,0.0,0.0},{1.0,1.267949192431123,0.0,0.0},{0.7886751345948129,0.0,0.0,0.0},{-0.2113248654051871,-1.607695154586736,0.0,0.0},{-1.077350269189626,-3.464101615137755,-1.732050807568877,0.0},{3.0,2.0,0.5773502691896258,0.4226497308103742},{0.7886751345948129,-0.113248654051871,-0.4226497308103742,0.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ROS3P_0 = {8,4,3,3,&butcher_ROS3P,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_ROS3P = &nrpy_odiegm_step_ROS3P_0;
+
+// RODAS4, Hairer and Wanner. Fourth order, stiffly accurate and L-stable, third order embedded. 
+double butcher_RODAS4[14][7] = {{0.0,0.0,0.0,0.0,0.0,0.0,0.0},{0.386,1.544,0.0,0.0,0.0,0.0,0.0},{0.21,0.9466785280815826,0.2557011698983284,0.0,0.0,0.0,0.0},{0.63,3.314825187068521,2.896124015972201,0.9986419139977817,0.0,0.0,0.0},{1.0,1.221224509226641,6.019134481288629,12.53708332932087,-0.6878860361058950,0.0,0.0},{1.0,1.221224509226641,6.019134481288629,12.53708332932087,-0.6878860361058950,1.0,0.0},{0.25,0.0,0.0,0.0,0.0,0.0,0.0},{-0.1043,-5.668800000000000,0.0,0.0,0.0,0.0,0.0},{0.1035,-2.430093356833875,-0.2063599157091915,0.0,0.0,0.0,0.0},{-0.03620000000000023,-0.1073529058151375,-9.594562251023355,-20.47028614809616,0.0,0.0,0.0},{0.0,7.496443313967647,-10.24680431464352,-33.99990352819905,11.70890893206160,0.0,0.0},{0.0,8.083246795921522,-7.981132988064893,-31.52159432874371,16.31930543123136,-6.058818238834054,0.0},{4.0,1.221224509226641,6.019134481288629,12.53708332932087,-0.6878860361058950,1.0,1.0},{0.25,0.0,0.0,0.0,0.0,0.0,1.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_RODAS4_0 = {14,7,4,3,&butcher_RODAS4,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_RODAS4 = &nrpy_odiegm_step_RODAS4_0;
+
+// ESDIRK tables use the same layout as the adaptive Butcher tables above, 
+// the only difference is the (constant) diagonal, which makes every stage after the first implicit. 
+// ESDIRK3(2)4L[2]SA, the implicit half of Kennedy and Carpenter's ARK3(2)4L[2]SA. 
+// Third order, L-stable and stiffly accurate, second order embedded. gamma = 1767732205903.0/4055673282236.0. 
+double butcher_ESDIRK3[6][5] = {{0.0,0.0,0.0,0.0,0.0},{1767732205903.0/2027836641118.0,1767732205903.0/4055673282236.0,1767732205903.0/4055673282236.0,0.0,0.0},{3.0/5.0,2746238789719.0/10658868560708.0,-640167445237.0/6845629431997.0,1767732205903.0/4055673282236.0,0.0},{1.0,1471266399579.0/7840856788654.0,-4482444167858.0/7529755066697.0,11266239266428.0/11593286722821.0,1767732205903.0/4055673282236.0},{3.0,1471266399579.0/7840856788654.0,-4482444167858.0/7529755066697.0,11266239266428.0/11593286722821.0,1767732205903.0/4055673282236.0},{2.0,2756255671327.0/12835298489170.0,-10771552573575.0/22201958757719.0,9247589265047.0/10645013368117.0,2193209047091.0/5459859503100.0}};
+const nrpy_odiegm_step_type nrpy_odiegm_step_ESDIRK3_0 = {6,5,3,4,&butcher_ESDIRK3,0,NULL,NULL};
+const nrpy_odiegm_step_type *nrpy_odiegm_step_ESDIRK3 = &nrpy_odiegm_step_ESDIRK3_0;
+
 // Adams-Bashforth Method. Could be set to arbitrary size, but we chose 19. 
 // Should never need all 19.
 double butcher_AB[19][19] = {{333374427829017307697.0/51090942171709440000.0,-5148905233415267713.0/109168679854080000.0,395276943631267674287.0/1548210368839680000.0,-2129159630108649501931.0/2128789257154560000.0,841527158963865085639.0/283838567620608000.0,-189774312558599272277.0/27646613729280000.0,856822959645399341657.0/67580611338240000.0,-13440468702008745259589.0/709596419051520000.0,196513123964380075325537.0/8515157028618240000.0,-57429776853357830333.0/2494674910728000.0,53354279746900330600757.0/2838385676206080000.0,-26632588461762447833393.0/2128789257154560000.0,4091553114434184723167.0/608225502044160000.0,-291902259907317785203.0/101370917007360000.0,816476630884557765547.0/851515702861824000.0,-169944934591213283591.0/709596419051520000.0,239730549209090923561.0/5676771352412160000.0,-19963382447193730393.0/4257578514309120000.0,12600467236042756559.0/51090942171709440000.0},{0.0,57424625956493833.0/9146248151040000.0,-3947240465864473.0/92386344960000.0,497505713064683651.0/2286562037760000.0,-511501877919758129.0/640237370572800.0,65509525475265061.0/29640619008000.0,-38023516029116089751.0/8002967132160000.0,129650088885345917773.0/16005934264320000.0,-19726972891423175089.0/1778437140480000.0,3146403501110383511.0/256094948229120.0,-70617432699294428737.0/6402373705728000.0,14237182892280945743.0/1778437140480000.0,-74619315088494380723.0/16005934264320000.0,17195392832483362153.0/8002967132160000.0,-4543527303777247.0/5928123801600.0,653581961828485643.0/3201186852864000.0,-612172313896136299.0/16005934264320000.0,2460247368070567.0/547211427840000.0,-85455477715379.0/342372925440000.0},{0.0,0.0,14845854129333883.0/2462451425280000.0,-55994879072429317.0/1455084933120000.0,2612634723678583.0/14227497123840.0,-22133884200927593.0/35177877504000.0,5173388005728297701.0/3201186852864000.0,-5702855818380878219.0/1778437140480000.0,80207429499737366711.0/16005934264320000.0,-3993885936674091251.0/640237370572800.0,2879939505554213.0/463134672000.0,-324179886697104913.0/65330343936000.0,7205576917796031023.0/2286562037760000.0,-2797406189209536629.0/1778437140480000.0,386778238886497951.0/640237370572800.0,-551863998439384493.0/3201186852864000.0,942359269351333.0/27360571392000.0,-68846386581756617.0/16005934264320000.0,8092989203533249.0/32011868528640000.0},{0.0,0.0,0.0,362555126427073.0/62768369664000.0,-2161567671248849.0/62768369664000.0,740161300731949.0/4828336128000.0,-4372481980074367.0/8966909952000.0,72558117072259733.0/62768369664000.0,-131963191940828581.0/62768369664000.0,62487713370967631.0/20922789888000.0,-70006862970773983.0/20922789888000.0,62029181421198881.0/20922789888000.0,-129930094104237331.0/62768369664000.0,10103478797549069.0/8966909952000.0,-2674355537386529.0/5706215424000.0,9038571752734087.0/62768369664000.0,-1934443196892599.0/62768369664000.0,36807182273689.0/8966909952000.0,-25221445.0/98402304.0},{0.0,0.0,0.0,0.0,13325653738373.0/2414168064000.0,-60007679150257.0/1961511552000.0,3966421670215481.0/31384184832000.0,-25990262345039.0/70053984000.0,25298910337081429.0/31384184832000.0,-2614079370781733.0/1961511552000.0,17823675553313503.0/10461394944000.0,-2166615342637.0/1277025750.0,13760072112094753.0/10461394944000.0,-1544031478475483.0/1961511552000.0,1600835679073597.0/4483454976000.0,-58262613384023.0/490377888000.0,859236476684231.0/31384184832000.0,-696561442637.0/178319232000.0,1166309819657.0/4483454976000.0},{0.0,0.0,0.0,0.0,0.0,905730205.0/172204032.0,-140970750679621.0/5230697472000.0,89541175419277.0/871782912000.0,-34412222659093.0/124540416000.0,570885914358161.0/1046139494400.0,-31457535950413.0/38745907200.0,134046425652457.0/145297152000.0,-350379327127877.0/435891456000.0,310429955875453.0/581188608000.0,-10320787460413.0/38745907200.0,7222659159949.0/74724249600.0,-21029162113651.0/871782912000.0,6460951197929.0/1743565824000.0,-106364763817.0/402361344000.0},{0.0,0.0,0.0,0.0,0.0,0.0,13064406523627.0/2615348736000.0,-931781102989.0/39626496000.0,5963794194517.0/72648576000.0,-10498491598103.0/52306974720.0,20730767690131.0/58118860800.0,-34266367915049.0/72648576000.0,228133014533.0/486486000.0,-2826800577631.0/8072064000.0,2253957198793.0/11623772160.0,-20232291373837.0/261534873600.0,4588414555201.0/217945728000.0,-169639834921.0/48432384000.0,703604254357.0/2615348736000.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,4527766399.0/958003200.0,-6477936721.0/319334400.0,12326645437.0/191600640.0,-15064372973.0/106444800.0,35689892561.0/159667200.0,-41290273229.0/159667200.0,35183928883.0/159667200.0,-625551749.0/4561920.0,923636629.0/15206400.0,-17410248271.0/958003200.0,30082309.0/9123840.0,-4777223.0/17418240.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,2132509567.0/479001600.0,-2067948781.0/119750400.0,1572737587.0/31933440.0,-1921376209.0/19958400.0,3539798831.0/26611200.0,-82260679.0/623700.0,2492064913.0/26611200.0,-186080291.0/3991680.0,2472634817.0/159667200.0,-52841941.0/17107200.0,26842253.0/95800320.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,4325321.0/1036800.0,-104995189.0/7257600.0,6648317.0/181440.0,-28416361.0/453600.0,269181919.0/3628800.0,-222386081.0/3628800.0,15788639.0/453600.0,-2357683.0/181440.0,20884811.0/7257600.0,-25713.0/89600.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,14097247.0/3628800.0,-21562603.0/1814400.0,47738393.0/1814400.0,-69927631.0/1814400.0,862303.0/22680.0,-45586321.0/1814400.0,19416743.0/1814400.0,-4832053.0/1814400.0,1070017.0/3628800.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,16083.0/4480.0,-1152169.0/120960.0,242653.0/13440.0,-296053.0/13440.0,2102243.0/120960.0,-115747.0/13440.0,32863.0/13440.0,-5257.0/17280.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,198721.0/60480.0,-18637.0/2520.0,235183.0/20160.0,-10754.0/945.0,135713.0/20160.0,-5603.0/2520.0,19087.0/60480.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,4277.0/1440.0,-2641.0/480.0,4991.0/720.0,-3649.0/720.0,959.0/480.0,-95.0/288.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,1901.0/720.0,-1387.0/360.0,109.0/30.0,-637.0/360.0,251.0/720.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,55.0/24.0,-59.0/24.0,37.0/24.0,-3.0/8.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,23.0/12.0,-4.0/3.0,5.0/12.0},{0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,3.0/2.0,-1.0/2.0},{0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,1.0}};
-const nrpy_odiegm_step_type nrpy_odiegm_step_AB0 = {19,19,19,&butcher_AB};
+const nrpy_odiegm_step_type nrpy_odiegm_step_AB0 = {19,19,19,0,&butcher_AB,0,NULL,NULL};
 const nrpy_odiegm_step_type *nrpy_odiegm_step_AB = &nrpy_odiegm_step_AB0;
 // NOT comparable to GSL's AB method, so it is not named as such.
 // Not adaptive, has to use constant time steps.  
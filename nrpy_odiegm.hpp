@@ -0,0 +1,543 @@
+#ifndef NRPY_ODIEGM_HPP
+#define NRPY_ODIEGM_HPP
+
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "nrpy_odiegm.h" // The control and system structs, shared with the C code. 
+
+// This is the C++ front end for Odie. It's optional, everything in here is also in the C code. 
+// What it buys is speed on small systems. nrpy_odiegm_evolve_apply can't know at compile time 
+// what the table is, what the system is, or how big it is: the right hand side goes through 
+// a function pointer, the table through a void pointer, and every loop is over a runtime dimension. 
+// Here all three are template parameters, so the compiler sees them: 
+//  - The Butcher tables are constexpr, so every zero coefficient is dropped at compile time 
+//    and the stages are unrolled. 
+//  - The right hand side is any callable (a lambda, a functor), called directly so it can be inlined. 
+//  - The state is a fixed size array the compiler can keep in registers. 
+// For the 4 equation TOV system that's several times as many steps per second. 
+//
+// Usage, for a system of N equations: 
+//
+//     auto rhs = [&](double x, std::array<double, N> &y, std::array<double, N> &dydx) { ... };
+//     odiegm::Integrator<odiegm::ADP5, decltype(rhs), N> integrator(rhs, 1e-10, 1e-10);
+//     double t = 0.0, h = 0.0; // h <= 0 picks a starting step, as with the C code. 
+//     while (t < t1) {
+//         integrator.evolve_apply(&t, t1, &h, y);
+//     }
+//
+// As with the C function, rhs may change y (clamp it, say), it's only ever handed a scratch copy. 
+// The step control is the same as nrpy_odiegm_evolve_apply's, down to the control struct: 
+// integrator.control is an ordinary nrpy_odiegm_control, so tolerances, per-component limits 
+// (set the vectors yourself, N long) and the choice of norm all work the same way. 
+// Going the other way, Integrator::c_function lets the C solver run the same functor, 
+// for the methods only the C code has (implicit, extrapolation, and so on). 
+//
+// Unlike the C code this needs C++17, and it doesn't do step doubling: a table without 
+// an embedded solution (RK4) always takes the step it's given. 
+
+namespace odiegm {
+
+// The Butcher tables, copied from nrpy_odiegm.h. c is where each stage is evaluated, 
+// a[i][j] the weight of stage j in stage i, b the weights of the answer, b_embedded those 
+// of the lower order solution used for the error estimate. order is the answer's order, 
+// which is also what the step control uses (the same as the C tables' first column). 
+
+struct RK4 {
+    // Classic fourth order Runge-Kutta, fixed steps only.
+    static constexpr int stages = 4;
+    static constexpr int order = 4;
+    static constexpr bool embedded = false;
+    static constexpr double c[stages] = {0.0, 1.0/2.0, 1.0/2.0, 1.0};
+    static constexpr double a[stages][stages] = {
+        {0.0, 0.0, 0.0, 0.0},
+        {1.0/2.0, 0.0, 0.0, 0.0},
+        {0.0, 1.0/2.0, 0.0, 0.0},
+        {0.0, 0.0, 1.0, 0.0}
+    };
+    static constexpr double b[stages] = {1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0};
+    static constexpr double b_embedded[stages] = {0.0, 0.0, 0.0, 0.0};
+};
+
+struct ADP5 {
+    // Dormand-Prince 5(4), the same table as nrpy_odiegm_step_ADP5.
+    static constexpr int stages = 7;
+    static constexpr int order = 5;
+    static constexpr bool embedded = true;
+    static constexpr double c[stages] = {0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0, 8.0/9.0, 1.0, 1.0};
+    static constexpr double a[stages][stages] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {1.0/5.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {3.0/40.0, 9.0/40.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {44.0/45.0, -56.0/15.0, 32.0/9.0, 0.0, 0.0, 0.0, 0.0},
+        {19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0, 0.0, 0.0, 0.0},
+        {9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0, 0.0, 0.0},
+        {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0, 0.0}
+    };
+    static constexpr double b[stages] = {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0, 0.0};
+    static constexpr double b_embedded[stages] = {5179.0/57600.0, 0.0, 7571.0/16695.0, 393.0/640.0, -92097.0/339200.0, 187.0/2100.0, 1.0/40.0};
+};
+
+struct Tsit5 {
+    // Tsitouras 5(4), the same table as nrpy_odiegm_step_Tsit5.
+    static constexpr int stages = 7;
+    static constexpr int order = 5;
+    static constexpr bool embedded = true;
+    static constexpr double c[stages] = {0.0, 0.161, 0.327, 0.9, 0.9800255409045097, 1.0, 1.0};
+    static constexpr double a[stages][stages] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.161, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {-0.008480655492356989, 0.335480655492357, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {2.897153057105493, -6.359448489975075, 4.3622954328695815, 0.0, 0.0, 0.0, 0.0},
+        {5.325864828439257, -11.748883564062828, 7.4955393428898365, -0.09249506636175525, 0.0, 0.0, 0.0},
+        {5.86145544294642, -12.92096931784711, 8.159367898576159, -0.071584973281401, -0.028269050394068383, 0.0, 0.0},
+        {0.09646076681806523, 0.01, 0.4798896504144996, 1.379008574103742, -3.290069515436081, 2.324710524099774, 0.0}
+    };
+    static constexpr double b[stages] = {0.09646076681806523, 0.01, 0.4798896504144996, 1.379008574103742, -3.290069515436081, 2.324710524099774, 0.0};
+    static constexpr double b_embedded[stages] = {0.09824077787029101, 0.010816434459656746, 0.4720087724042376, 1.5237195812770048, -3.872426680888636, 2.7827926300289607, -0.015151515151515152};
+};
+
+struct Vern6 {
+    // Verner 6(5), the same table as nrpy_odiegm_step_Vern6.
+    static constexpr int stages = 9;
+    static constexpr int order = 6;
+    static constexpr bool embedded = true;
+    static constexpr double c[stages] = {0.0, 0.06, 0.09593333333333333, 0.1439, 0.4973, 0.9725, 0.9995, 1.0, 1.0};
+    static constexpr double a[stages][stages] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.06, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.019239962962962962, 0.07669337037037037, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.035975, 0.0, 0.107925, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {1.3186834152331484, 0.0, -5.042058063628562, 4.220674648395414, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {-41.872591664327516, 0.0, 159.4325621631375, -122.11921356501003, 5.531743066200054, 0.0, 0.0, 0.0, 0.0},
+        {-54.43015693531651, 0.0, 207.06725136501848, -158.61081378459, 6.991816585950242, -0.018597231062203234, 0.0, 0.0, 0.0},
+        {-54.66374178728198, 0.0, 207.95280625538936, -159.2889574744995, 7.018743740796944, -0.018338785905045722, -0.0005119484997882099, 0.0, 0.0},
+        {0.03438957868357036, 0.0, 0.0, 0.2582624555633503, 0.4209371189673537, 4.40539646966931, -176.48311902429865, 172.36413340141507, 0.0}
+    };
+    static constexpr double b[stages] = {0.03438957868357036, 0.0, 0.0, 0.2582624555633503, 0.4209371189673537, 4.40539646966931, -176.48311902429865, 172.36413340141507, 0.0};
+    static constexpr double b_embedded[stages] = {0.04909967648369985, 0.0, 0.0, 0.22511122295186925, 0.46946822530281707, 0.8065792249992284, 0.0, -0.6071194891780128, 0.05686113944039828};
+};
+
+struct Vern7 {
+    // Verner 7(6), the same table as nrpy_odiegm_step_Vern7.
+    static constexpr int stages = 10;
+    static constexpr int order = 7;
+    static constexpr bool embedded = true;
+    static constexpr double c[stages] = {0.0, 0.005, 0.10888888888888888, 0.16333333333333333, 0.4555, 0.6095094489978381, 0.884, 0.925, 1.0, 1.0};
+    static constexpr double a[stages][stages] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.005, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {-1.07679012345679, 1.185679012345679, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.04083333333333333, 0.0, 0.1225, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.6389139236255726, 0.0, -2.455672638223657, 2.272258714598084, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {-2.6615773750187572, 0.0, 10.804513886456137, -8.3539146573962, 0.820487594956657, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {6.067741434696772, 0.0, -24.711273635911088, 20.427517930788895, -1.9061579788166472, 1.006172249242068, 0.0, 0.0, 0.0, 0.0},
+        {12.054670076253203, 0.0, -49.75478495046899, 41.142888638604674, -4.461760149974004, 2.042334822239175, -0.09834843665406107, 0.0, 0.0, 0.0},
+        {10.138146522881808, 0.0, -42.6411360317175, 35.76384003992257, -4.3480228403929075, 2.0098622683770357, 0.3487490460338272, -0.27143900510483127, 0.0, 0.0},
+        {-45.030072034298676, 0.0, 187.3272437654589, -154.02882369350186, 18.56465306347536, -7.141809679295079, 1.3088085781613787, 0.0, 0.0, 0.0}
+    };
+    static constexpr double b[stages] = {0.04715561848627222, 0.0, 0.0, 0.25750564298434153, 0.26216653977412624, 0.15216092656738558, 0.4939969170032485, -0.29430311714032503, 0.08131747232495111, 0.0};
+    static constexpr double b_embedded[stages] = {0.044608606606341174, 0.0, 0.0, 0.26716403785713727, 0.22010183001772932, 0.2188431703143157, 0.2289871705411204, 0.0, 0.0, 0.02029518466335628};
+};
+
+struct ADP8 {
+    // Dormand-Prince 8(7), the same table as nrpy_odiegm_step_ADP8.
+    static constexpr int stages = 13;
+    static constexpr int order = 8;
+    static constexpr bool embedded = true;
+    static constexpr double c[stages] = {0.0, 1.0/18.0, 1.0/12.0, 1.0/8.0, 5.0/16.0, 3.0/8.0, 59.0/400.0, 93.0/200.0, 5490023248.0/9719169821.0, 13.0/20.0, 1201146811.0/1299019798.0, 1.0, 1.0};
+    static constexpr double a[stages][stages] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {1.0/18.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {1.0/48.0, 1.0/16.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {1.0/32.0, 0.0, 3.0/32.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {5.0/16.0, 0.0, -75.0/64.0, 75.0/64.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {3.0/80.0, 0.0, 0.0, 3.0/16.0, 3.0/20.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {29443841.0/614563906.0, 0.0, 0.0, 77736538.0/692538347.0, -28693883.0/1125000000.0, 23124283.0/1800000000.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {16016141.0/946692911.0, 0.0, 0.0, 61564180.0/158732637.0, 22789713.0/633445777.0, 545815736.0/2771057229.0, -180193667.0/1043307555.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {39632708.0/573591083.0, 0.0, 0.0, -433636366.0/683701615.0, -421739975.0/2616292301.0, 100302831.0/723423059.0, 790204164.0/839813087.0, 800635310.0/3783071287.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {246121993.0/1340847787.0, 0.0, 0.0, -37695042795.0/15268766246.0, -309121744.0/1061227803.0, -12992083.0/490766935.0, 6005943493.0/2108947869.0, 393006217.0/1396673457.0, 123872331.0/1001029789.0, 0.0, 0.0, 0.0, 0.0},
+        {-1028468189.0/846180014.0, 0.0, 0.0, 8478235783.0/508512852.0, 1311729495.0/1432422823.0, -10304129995.0/1701304382.0, -48777925059.0/3047939560.0, 15336726248.0/1032824649.0, -45442868181.0/3398467696.0, 3065993473.0/597172653.0, 0.0, 0.0, 0.0},
+        {185892177.0/718116043.0, 0.0, 0.0, -3185094517.0/667107341.0, -477755414.0/1098053517.0, -703635378.0/230739211.0, 5731566787.0/1027545527.0, 5232866602.0/850066563.0, -4093664535.0/808688257.0, 3962137247.0/1805957418.0, 65686358.0/487910083.0, 0.0, 0.0},
+        {403863854.0/491063109.0, 0.0, 0.0, -5068492393.0/434740067.0, -411421997.0/543043805.0, 652783627.0/914296604.0, 11173962825.0/925320556.0, -13158990841.0/6184727034.0, 3936647629.0/1978049680.0, -160528059.0/685178525.0, 248638103.0/1413531060.0, 0.0, 0.0}
+    };
+    static constexpr double b[stages] = {14005451.0/335480064.0, 0.0, 0.0, 0.0, 0.0, -59238493.0/1068277825.0, 181606767.0/758867731.0, 561292985.0/797845732.0, -1041891430.0/1371343529.0, 760417239.0/1151165299.0, 118820643.0/751138087.0, -528747749.0/2220607170.0, 1.0/4.0};
+    static constexpr double b_embedded[stages] = {13451932.0/455176623.0, 0.0, 0.0, 0.0, 0.0, -808719846.0/976000145.0, 1757004468.0/5645159321.0, 656045339.0/265891186.0, -3867574721.0/1518517206.0, 465885868.0/322736535.0, 53011238.0/667516719.0, 2.0/45.0, 0.0};
+};
+
+struct Vern9 {
+    // Verner 9(8), the same table as nrpy_odiegm_step_Vern9.
+    static constexpr int stages = 16;
+    static constexpr int order = 9;
+    static constexpr bool embedded = true;
+    static constexpr double c[stages] = {0.0, 0.03462, 0.09702435063878045, 0.14553652595817068, 0.561, 0.22900791159048503, 0.544992088409515, 0.645, 0.48375, 0.06757, 0.25, 0.6590650618730999, 0.8206, 0.9012, 1.0, 1.0};
+    static constexpr double a[stages][stages] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.03462, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {-0.0389335438857287, 0.13595789452451, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.03638413148954267, 0.0, 0.10915239446862801, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {2.0257639143939694, 0.0, -7.638023836496292, 6.173259922102322, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.05112275589406061, 0.0, 0.0, 0.17708237945550218, 0.0008027762409222536, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.13160063579752163, 0.0, 0.0, -0.2957276252669636, 0.08781378035642955, 0.6213052975225274, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.07166666666666667, 0.0, 0.0, 0.0, 0.0, 0.33055335789153195, 0.2427799754418014, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.071806640625, 0.0, 0.0, 0.0, 0.0, 0.3294380283228177, 0.1165190029271823, -0.034013671875, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.04836757646340646, 0.0, 0.0, 0.0, 0.0, 0.03928989925676164, 0.10547409458903446, -0.021438652846483126, -0.10412291746271944, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {-0.026645614872014785, 0.0, 0.0, 0.0, 0.0, 0.03333333333333333, -0.1631072244872467, 0.03396081684127761, 0.1572319413814626, 0.21522674780318796, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {0.03689009248708622, 0.0, 0.0, 0.0, 0.0, -0.1465181576725543, 0.2242577768172024, 0.02294405717066073, -0.0035850052905728597, 0.08669223316444385, 0.43838406519683376, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {-0.4866012215113341, 0.0, 0.0, 0.0, 0.0, -6.304602650282853, -0.2812456182894729, -2.679019236219849, 0.5188156639241577, 1.3653531876033418, 5.8850910885039465, 2.8028087862720636, 0.0, 0.0, 0.0, 0.0},
+        {0.4185367457753472, 0.0, 0.0, 0.0, 0.0, 6.724547581906459, -0.42544428016461133, 3.3432791530012653, 0.6170816631175374, -0.9299661239399329, -6.099948804751011, -3.002206187889399, 0.2553202529443446, 0.0, 0.0, 0.0},
+        {-0.7793740861228848, 0.0, 0.0, 0.0, 0.0, -13.937342538107776, 1.2520488533793563, -14.691500408016868, -0.494705058533141, 2.2429749091462368, 13.367893803828643, 14.396650486650687, -0.79758133317768, 0.4409353709534278, 0.0, 0.0},
+        {2.0580513374668867, 0.0, 0.0, 0.0, 0.0, 22.357937727968032, 0.9094981099755646, 35.89110098240264, -3.442515027624454, -4.865481358036369, -18.909803813543427, -34.26354448030452, 1.2647565216956427, 0.0, 0.0, 0.0}
+    };
+    static constexpr double b[stages] = {0.014611976858423152, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.3915211862331339, 0.23109325002895065, 0.12747667699928525, 0.2246434176204158, 0.5684352689748513, 0.058258715572158275, 0.13643174034822156, 0.030570139830827976, 0.0};
+    static constexpr double b_embedded[stages] = {0.01996996514886773, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.19149930494933, 0.08857071848208439, 0.11405602348659657, 0.2533163805345107, -2.056564386240941, 0.340809679901312, 0.0, 0.0, 0.04834231373823958};
+};
+
+namespace detail {
+
+// Each weight is its own type, so "if constexpr" can drop the zeros. 
+template <class T, int I, int J> struct stage_weight { static constexpr double value = T::a[I][J]; };
+template <class T, int J> struct answer_weight { static constexpr double value = T::b[J]; };
+template <class T, int J> struct embedded_weight { static constexpr double value = T::b_embedded[J]; };
+
+template <class W>
+inline void accumulate (double &sum, double k) {
+    if constexpr (W::value != 0.0) {
+        sum = sum + W::value*k;
+    }
+}
+
+template <class T>
+constexpr bool first_same_as_last () {
+    // The last stage is evaluated at x+h with exactly the answer's weights, so its derivative 
+    // is f at the start of the next step. 
+    if (T::c[T::stages - 1] != 1.0) {
+        return false;
+    }
+    for (int j = 0; j < T::stages; j++) {
+        if (T::a[T::stages - 1][j] != T::b[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace detail
+
+template <class Tableau, class Rhs, int N>
+class Integrator {
+  public:
+    using state = std::array<double, N>;
+
+    nrpy_odiegm_control control; // Same meaning as the C control "object," see nrpy_odiegm.h. 
+    unsigned long count; // Steps taken, like nrpy_odiegm_evolve's count. 
+    bool no_adaptive_step; // Set to true for fixed steps, like nrpy_odiegm_evolve's. 
+    double last_step; // Set to 1 when the step was cut short to land on t1. 
+
+    Integrator (Rhs rhs, double eps_abs, double eps_rel) : rhs(rhs) {
+        // Same defaults as nrpy_odiegm_control_y_new. 
+        control.abs_lim = eps_abs;
+        control.rel_lim = eps_rel;
+        control.scale_factor = 0.9;
+        control.error_safety = 4.0/15.0;
+        control.ay_error_scaler = 1.0;
+        control.ady_error_scaler = 1.0;
+        control.max_step_adjustment = 5.0;
+        control.min_step_adjustment = 0.2;
+        control.absolute_max_step = 0.1;
+        control.absolute_min_step = 1e-10;
+        control.error_upper_tolerance = 1.1;
+        control.error_lower_tolerance = 0.5;
+        control.abs_lim_vector = NULL;
+        control.rel_lim_vector = NULL;
+        control.error_weight = NULL;
+        control.error_weight_sum = 0.0;
+        control.error_norm = 0;
+        control.gridfunctions = 0;
+        for (int d = 0; d < 3; d++) {
+            control.grid_size[d] = 1;
+            control.grid_ghosts[d] = 0;
+        }
+        reset();
+    }
+
+    Integrator (Rhs rhs, const nrpy_odiegm_control &c) : control(c), rhs(rhs) {
+        // Takes the limits from an existing C control "object." Only the values are copied, 
+        // the per-component vectors (if any) still belong to whoever made them. 
+        reset();
+    }
+
+    void reset () {
+        // Forget the previous step, like nrpy_odiegm_evolve_reset. 
+        count = 0;
+        no_adaptive_step = false;
+        last_step = 0.0;
+        f_start_valid = false;
+    }
+
+    void step (double x, double h, const state &y, state &y_new, state &y_embedded) {
+        // One step of the method from (x, y), the answer in y_new and the embedded solution 
+        // (zero for tables without one) in y_embedded. The stages are unrolled at compile time. 
+        // Afterwards f_start holds f(x+h, y_new) if the table is "first same as last." 
+        if (f_start_valid == false || f_start_x != x || f_start_y != y) {
+            state y_insert = y;
+            rhs(x, y_insert, f_start);
+        }
+        f_start_valid = false;
+        for (int n = 0; n < N; n++) {
+            k[0][n] = h*f_start[n];
+        }
+        stages(x, h, y, std::make_integer_sequence<int, Tableau::stages>{});
+        combine(y, y_new, y_embedded, std::make_integer_sequence<int, Tableau::stages>{});
+        if constexpr (detail::first_same_as_last<Tableau>() == true) {
+            f_start = f;
+            f_start_x = x + h;
+            f_start_y = y_new;
+            f_start_valid = true;
+        }
+    }
+
+    int evolve_apply (double *t, double t1, double *h, state &y) {
+        // Takes one step towards t1, the same contract as nrpy_odiegm_evolve_apply: 
+        // on the way out t is where we are, h the step to try next, y the answer there. 
+        bool check_first_step = false;
+        if (*h <= 0.0) {
+            *h = initial_step(*t, y);
+            check_first_step = true;
+        }
+        if (*t + *h > t1) {
+            *h = t1 - *t;
+            last_step = 1.0;
+        }
+
+        double current_position = *t;
+        double step_size = *h;
+        double original_step = step_size;
+        double next_step = step_size;
+        // As with the C code, the very first step always goes through if the user picked it. 
+        bool check_error = (Tableau::embedded == true && no_adaptive_step == false && (count != 0 || check_first_step == true));
+
+        state y_new;
+        state y_embedded;
+        state yerr;
+        bool floored = false;
+        while (true) {
+            step(current_position, step_size, y, y_new, y_embedded);
+            if (check_error == false) {
+                break;
+            }
+            for (int n = 0; n < N; n++) {
+                yerr[n] = std::fabs(y_new[n] - y_embedded[n])*control.error_safety;
+            }
+            // The error kernel wants the derivative at the new point, which is also the next 
+            // step's first stage, so it's never wasted. "First same as last" tables have it already. 
+            if (f_start_valid == false) {
+                state y_insert = y_new;
+                rhs(current_position + step_size, y_insert, f_start);
+                f_start_x = current_position + step_size;
+                f_start_y = y_new;
+                f_start_valid = true;
+            }
+            double ratio_ED = error_ratio(step_size, yerr, y_new, f_start);
+
+            if (ratio_ED > control.error_upper_tolerance && floored == false) {
+                // Too big, shrink it and try again, with the same limits as the C code. 
+                step_size = step_size * control.scale_factor * std::pow(ratio_ED, -1.0/Tableau::order);
+                if (step_size < control.min_step_adjustment * original_step) {
+                    step_size = control.min_step_adjustment * original_step;
+                    floored = true;
+                }
+                if (step_size < control.absolute_min_step) {
+                    step_size = control.absolute_min_step;
+                    floored = true;
+                }
+                continue;
+            }
+            if (ratio_ED <= control.error_lower_tolerance) {
+                // Comfortably under, take this step and a bigger one next time. 
+                next_step = step_size * control.scale_factor * std::pow(ratio_ED, -1.0/(Tableau::order + 1));
+                if (next_step > control.max_step_adjustment * original_step) {
+                    next_step = control.max_step_adjustment * original_step;
+                }
+            } else {
+                next_step = step_size;
+            }
+            if (next_step > control.absolute_max_step) {
+                next_step = control.absolute_max_step;
+            }
+            break;
+        }
+
+        y = y_new;
+        *h = next_step;
+        *t = current_position + step_size;
+        count = count + 1;
+        return 0;
+    }
+
+    int evolve_apply (double *t, double t1, double *h, double y[]) {
+        // The same for a plain array, N long, so C-style callers don't have to change anything. 
+        state y_state;
+        for (int n = 0; n < N; n++) {
+            y_state[n] = y[n];
+        }
+        int status = evolve_apply(t, t1, h, y_state);
+        for (int n = 0; n < N; n++) {
+            y[n] = y_state[n];
+        }
+        return status;
+    }
+
+    double error_ratio (double step_size, const state &yerr, const state &y, const state &dydx) const {
+        // The error kernel, nrpy_odiegm_error_ratio for a fixed size state. 
+        // The gridfunction layout is left to the C code, systems that big don't belong here. 
+        double ratio_max = 0.0;
+        double ratio_squared_sum = 0.0;
+        double components_counted = 0.0;
+        for (int n = 0; n < N; n++) {
+            double absolute_error_limit = control.abs_lim;
+            double relative_error_limit = control.rel_lim;
+            double weight = 1.0;
+            if (control.abs_lim_vector != NULL) {
+                absolute_error_limit = control.abs_lim_vector[n];
+                relative_error_limit = control.rel_lim_vector[n];
+                if (control.error_weight != NULL) {
+                    weight = control.error_weight[n];
+                }
+            }
+            // Masked components are skipped, not multiplied by 0, as in the C kernel: 
+            // 0*inf or 0/0 would put a NaN into the RMS sum. 
+            double ratio = (weight > 0.0) ? yerr[n]/(absolute_error_limit + relative_error_limit*(control.ay_error_scaler*std::fabs(y[n]) + control.ady_error_scaler*step_size*std::fabs(dydx[n]))) : 0.0;
+            ratio_max = std::fmax(ratio_max, ratio);
+            ratio_squared_sum = ratio_squared_sum + ratio*ratio;
+            components_counted = components_counted + weight;
+        }
+        if (control.error_norm == 1 && components_counted > 0.0) {
+            return std::sqrt(ratio_squared_sum/components_counted);
+        }
+        return ratio_max;
+    }
+
+    double initial_step (double x, const state &y) {
+        // The starting step estimate from nrpy_odiegm_initial_step (Hairer, Norsett, and Wanner), 
+        // two function evaluations. 
+        state y_insert = y;
+        state f_initial;
+        state f_trial;
+        state error_scale;
+        for (int n = 0; n < N; n++) {
+            if (control.abs_lim_vector == NULL) {
+                error_scale[n] = control.abs_lim + control.rel_lim*std::fabs(y[n]);
+            } else {
+                error_scale[n] = control.abs_lim_vector[n] + control.rel_lim_vector[n]*std::fabs(y[n]);
+            }
+        }
+        rhs(x, y_insert, f_initial);
+
+        double d0 = 0.0;
+        double d1 = 0.0;
+        for (int n = 0; n < N; n++) {
+            d0 = d0 + (y[n]/error_scale[n])*(y[n]/error_scale[n]);
+            d1 = d1 + (f_initial[n]/error_scale[n])*(f_initial[n]/error_scale[n]);
+        }
+        d0 = std::sqrt(d0/N);
+        d1 = std::sqrt(d1/N);
+        double h0 = 1.0e-6;
+        if (d0 >= 1.0e-5 && d1 >= 1.0e-5) {
+            h0 = 0.01*d0/d1;
+        }
+        if (h0 > control.absolute_max_step) {
+            h0 = control.absolute_max_step;
+        }
+
+        for (int n = 0; n < N; n++) {
+            y_insert[n] = y[n] + h0*f_initial[n];
+        }
+        rhs(x + h0, y_insert, f_trial);
+        double d2 = 0.0;
+        for (int n = 0; n < N; n++) {
+            d2 = d2 + ((f_trial[n] - f_initial[n])/error_scale[n])*((f_trial[n] - f_initial[n])/error_scale[n]);
+        }
+        d2 = std::sqrt(d2/N)/h0;
+
+        double d_max = std::fmax(d1, d2);
+        double h1;
+        if (d_max <= 1.0e-15) {
+            h1 = std::fmax(h0*1.0e-3, 1.0e-6);
+        } else {
+            h1 = std::pow(0.01/d_max, 1.0/(Tableau::order + 1.0));
+        }
+        double step_size = std::fmin(100.0*h0, h1);
+        if (step_size > control.absolute_max_step) {
+            step_size = control.absolute_max_step;
+        } else if (step_size < control.absolute_min_step) {
+            step_size = control.absolute_min_step;
+        }
+        return step_size;
+    }
+
+    static int c_function (double x, double y[], double dydx[], void *params) {
+        // The functor as a C right hand side, so the C solver can run the same system: 
+        // nrpy_odiegm_system system = {Integrator::c_function, NULL, N, &rhs}; 
+        state y_state;
+        state dydx_state;
+        for (int n = 0; n < N; n++) {
+            y_state[n] = y[n];
+        }
+        (*(Rhs *)params)(x, y_state, dydx_state);
+        for (int n = 0; n < N; n++) {
+            y[n] = y_state[n];
+            dydx[n] = dydx_state[n];
+        }
+        return 0;
+    }
+
+  private:
+    Rhs rhs;
+    state k[Tableau::stages]; // The K-values, h*f at every stage, as in the C code. 
+    state f; // Scratch for the derivative at a stage. 
+    state f_start; // f at the start of the next step, when we know it. 
+    state f_start_y;
+    double f_start_x;
+    bool f_start_valid;
+
+    template <int I, int... J>
+    void stage (double x, double h, const state &y, std::integer_sequence<int, J...>) {
+        // Stage I: y + sum of a[I][j]*k[j], then f there. Only the nonzero weights survive. 
+        state y_insert;
+        for (int n = 0; n < N; n++) {
+            double sum = y[n];
+            (detail::accumulate<detail::stage_weight<Tableau, I, J>>(sum, k[J][n]), ...);
+            y_insert[n] = sum;
+        }
+        rhs(x + Tableau::c[I]*h, y_insert, f);
+        for (int n = 0; n < N; n++) {
+            k[I][n] = h*f[n];
+        }
+    }
+
+    template <int... I>
+    void stages (double x, double h, const state &y, std::integer_sequence<int, 0, I...>) {
+        // Every stage after the first (which is f_start), in order. 
+        (stage<I>(x, h, y, std::make_integer_sequence<int, I>{}), ...);
+    }
+
+    template <int... J>
+    void combine (const state &y, state &y_new, state &y_embedded, std::integer_sequence<int, J...>) {
+        for (int n = 0; n < N; n++) {
+            double sum = y[n];
+            (detail::accumulate<detail::answer_weight<Tableau, J>>(sum, k[J][n]), ...);
+            y_new[n] = sum;
+            double sum_embedded = y[n];
+            if constexpr (Tableau::embedded == true) {
+                (detail::accumulate<detail::embedded_weight<Tableau, J>>(sum_embedded, k[J][n]), ...);
+            }
+            y_embedded[n] = sum_embedded;
+        }
+    }
+};
+
+} // namespace odiegm
+
+#endif
@@ -0,0 +1,125 @@
+
+// The TOV right hand side, written by nrpy_odiegm_TOV_rhs.py.
+// Regenerate this file (python3 nrpy_odiegm_TOV_rhs.py) rather than editing it.
+
+/*
+ * The TOV equations for a given total energy density rho, for x > 0.
+ */
+void TOV_rhs(double x, const double y[], double rho, double dydx[]) {
+    const double _pi = 3.1415926535897931160;
+    const double P = y[0];
+    const double m = y[2];
+    const double rbar = y[3];
+    const double _Rational_1_2 = 1.0/2.0;
+    const double _Integer_1 = 1.0;
+    const double _Integer_2 = 2.0;
+    const double _Integer_8 = 8.0;
+    const double _Integer_4 = 4.0;
+    const double tmp_0 = (1.0/(x));
+    const double tmp_1 = _Integer_2*m*tmp_0;
+    const double tmp_2 = _Integer_1 - tmp_1;
+    const double tmp_3 = _pi*((x)*(x));
+    const double tmp_4 = tmp_0*(P*_Integer_8*tmp_3 + tmp_1)/tmp_2;
+    dydx[0] = _Rational_1_2*tmp_4*(-P - rho);
+    dydx[1] = tmp_4;
+    dydx[2] = _Integer_4*rho*tmp_3;
+    dydx[3] = rbar*tmp_0/sqrt(tmp_2);
+}
+
+/*
+ * The TOV equations for one polytropic piece (K, Gamma, energy constant a), for x > 0.
+ * The total energy density comes back in *rho.
+ */
+void TOV_rhs_polytrope(double x, const double y[], double K, double Gamma, double a, double *rho, double dydx[]) {
+    const double _pi = 3.1415926535897931160;
+    const double P = y[0];
+    const double m = y[2];
+    const double rbar = y[3];
+    const double _Rational_1_2 = 1.0/2.0;
+    const double _Integer_1 = 1.0;
+    const double _Integer_2 = 2.0;
+    const double _Integer_8 = 8.0;
+    const double _Integer_4 = 4.0;
+    const double tmp_0 = P/(Gamma - 1) + pow(P/K, (1.0/(Gamma)))*(_Integer_1 + a);
+    const double tmp_1 = (1.0/(x));
+    const double tmp_2 = _Integer_2*m*tmp_1;
+    const double tmp_3 = _Integer_1 - tmp_2;
+    const double tmp_4 = _pi*((x)*(x));
+    const double tmp_5 = tmp_1*(P*_Integer_8*tmp_4 + tmp_2)/tmp_3;
+    dydx[0] = _Rational_1_2*tmp_5*(-P - tmp_0);
+    dydx[1] = tmp_5;
+    dydx[2] = _Integer_4*tmp_0*tmp_4;
+    dydx[3] = rbar*tmp_1/sqrt(tmp_3);
+    *rho = tmp_0;
+}
+
+/*
+ * The TOV equations in x = -h (h the pseudo-enthalpy) for a given total energy density rho,
+ * with y = (P, nu, m/r^3, rbar/r, r^2). Good everywhere but the center, the surface included.
+ */
+void TOV_rhs_enthalpy(const double y[], double rho, double dydx[]) {
+    const double _pi = 3.1415926535897931160;
+    const double P = y[0];
+    const double v = y[2];
+    const double w = y[3];
+    const double u = y[4];
+    const double _Integer_2 = 2.0;
+    const double _Integer_4 = 4.0;
+    const double _Integer_1 = 1.0;
+    const double _Integer_3 = 3.0;
+    const double tmp_1 = _Integer_1 - _Integer_2*u*v;
+    const double tmp_2 = (1.0/(P*_Integer_4*_pi + v));
+    const double tmp_3 = sqrt(tmp_1);
+    dydx[0] = -P - rho;
+    dydx[1] = _Integer_2;
+    dydx[2] = tmp_1*tmp_2*(-_Integer_3*v + _Integer_4*_pi*rho)/u;
+    dydx[3] = _Integer_2*tmp_2*tmp_3*v*w/(_Integer_1 + tmp_3);
+    dydx[4] = tmp_2*(_Integer_2 - _Integer_4*u*v);
+}
+
+/*
+ * Which piece of a piecewise polytrope pressure P is in.
+ * P_boundary holds the pieces-1 pressures between the pieces, increasing.
+ */
+int TOV_polytrope_piece(double P, int pieces, const double P_boundary[]) {
+    int piece = 0;
+    while (piece < pieces-1 && P > P_boundary[piece]) {
+        piece++;
+    }
+    return piece;
+}
+
+/*
+ * The solution a short way out from the center, from its Taylor expansion there.
+ * Goes as far out as the first term left out stays below error_limit (relative to the
+ * central pressure), fills y in there and returns how far that is.
+ */
+double TOV_center_series(double P_c, double rho_c, double drho_dP_c, double error_limit, double y[]) {
+    const double _pi = 3.1415926535897931160;
+    const double P2 = -2.0/3.0*_pi*(P_c + rho_c)*(3*P_c + rho_c);
+    const double x = sqrt(P_c/fabs(P2))*pow(fmax(error_limit, 1e-16), 1.0/6.0);
+    const double _Rational_2_3 = 2.0/3.0;
+    const double _Integer_3 = 3.0;
+    const double _Rational_4_45 = 4.0/45.0;
+    const double _Integer_15 = 15.0;
+    const double _Integer_4 = 4.0;
+    const double _Integer_9 = 9.0;
+    const double _Rational_4_3 = 4.0/3.0;
+    const double _Integer_5 = 5.0;
+    const double _Rational_8_15 = 8.0/15.0;
+    const double _Integer_1 = 1.0;
+    const double _Rational_2_45 = 2.0/45.0;
+    const double _Integer_20 = 20.0;
+    const double _Integer_12 = 12.0;
+    const double tmp_0 = P_c + rho_c;
+    const double tmp_2 = P_c*_Integer_3 + rho_c;
+    const double tmp_3 = tmp_2*((x)*(x));
+    const double tmp_6 = P_c*drho_dP_c;
+    const double tmp_9 = ((_pi)*(_pi))*((x)*(x)*(x)*(x));
+    const double tmp_10 = _Rational_4_45*tmp_2*tmp_9;
+    y[0] = P_c - _Rational_2_3*_pi*tmp_0*tmp_3 + tmp_0*tmp_10*(P_c*_Integer_15 + _Integer_4*drho_dP_c*rho_c + _Integer_9*tmp_6);
+    y[1] = _Rational_4_3*_pi*tmp_3 - tmp_10*(P_c*_Integer_15 + _Integer_3*(drho_dP_c*rho_c + tmp_6) - _Integer_5*rho_c);
+    y[2] = _Rational_4_3*_pi*rho_c*((x)*(x)*(x)) - _Rational_8_15*((_pi)*(_pi))*drho_dP_c*tmp_0*tmp_2*((x)*(x)*(x)*(x)*(x));
+    y[3] = x*(_Integer_1 + _Rational_2_3*_pi*rho_c*((x)*(x)) - _Rational_2_45*tmp_9*(((P_c)*(P_c))*_Integer_9*drho_dP_c + _Integer_12*rho_c*tmp_6 - _Integer_20*((rho_c)*(rho_c)) + _Integer_3*drho_dP_c*((rho_c)*(rho_c))));
+    return x;
+}
@@ -0,0 +1,281 @@
+""" Generate the TOV right hand side from its symbolic form
+
+    diffy_Q_eval in nrpy_odiegm_user_methods.c used to spell the TOV equations out by hand,
+    working out 2m/r, 1 - 2m/r and 8 pi r^2 P over again for every equation it appeared in.
+    Here the equations are written once in SymPy and handed to outputC, which does the
+    common subexpression elimination (with cse_helpers.cse_preprocess pulling the constants
+    out first), so each of those only gets computed once per call.
+
+    The output, nrpy_odiegm_TOV_rhs.c, is included by nrpy_odiegm_user_methods.c and has:
+        TOV_rhs                the equations for a given total energy density rho, any EOS.
+                               diffy_Q_eval calls this for everything but x = 0.
+        TOV_rhs_enthalpy       the same in terms of the pseudo-enthalpy instead of r, which
+                               reaches the surface at exactly h = 0, with r^2, m/r^3 and
+                               rbar/r in place of m, rbar and r.
+        TOV_rhs_polytrope      the same with one polytropic piece P = K rho_b^Gamma built in,
+                               rho = (1 + a) rho_b + P/(Gamma - 1), handing rho back as well.
+                               a = 0 is a plain polytrope; a piecewise polytrope picks its piece
+                               with TOV_polytrope_piece and passes that piece's K, Gamma and a.
+    With enable_SIMD=True it also writes SIMD versions of both, which do SIMD_width points
+    at once (stage points, or the members of an ensemble), and diffy_Q_eval_batch, which fits
+    nrpy_odiegm_system.batch_function. Those need NRPy+'s SIMD/SIMD_intrinsics.h, which isn't
+    part of this repository, so the checked-in file is the scalar one.
+
+    Usage: python3 nrpy_odiegm_TOV_rhs.py [--simd]
+"""
+# Author: Gabriel M Steward
+
+import sys                      # Standard Python module for multiplatform OS-level functions
+import sympy as sp              # SymPy: The Python computer algebra package upon which NRPy+ depends
+import outputC as outC          # NRPy+: Core C code output module
+
+# The variables, in the order Odie keeps them: y = (P, nu, m, rbar), x = r.
+x, P, nu, m, rbar = sp.symbols("x P nu m rbar", real=True)
+rho, K, Gamma, a = sp.symbols("rho K Gamma a", real=True)
+# Pi gets its own symbol so it can be written out in full (Visual Studio doesn't always have M_PI).
+pi = sp.Symbol("_pi", real=True)
+pi_value = "3.1415926535897931160"
+
+
+def TOV_equations(energy_density):
+    """ dP/dr, dnu/dr, dm/dr and drbar/dr for total energy density energy_density. """
+    compactness = 2*m/x
+    dnu = (compactness + 8*pi*x**2*P)/(x*(1 - compactness))
+    dP = -(energy_density + P)*dnu/2
+    dm = 4*pi*x**2*energy_density
+    drbar = rbar/(x*sp.sqrt(1 - compactness))
+    return [dP, dnu, dm, drbar]
+
+
+# The variables in the enthalpy formulation: y = (P, nu, m/r^3, rbar/r, r^2), x = -h.
+u, v, w = sp.symbols("u v w", positive=True)
+
+
+def TOV_enthalpy_equations(energy_density):
+    """ The same equations with the pseudo-enthalpy h as the independent variable (Lindblom 1992),
+        dh = dP/(rho + P). Odie only steps forward, so they're written for x = -h, which runs from
+        -h_c up to 0 at the surface. r, m and rbar go like sqrt(h_c - h) and its powers near the
+        center, so they're replaced by u = r^2, v = m/r^3 and w = rbar/r, which are smooth in h.
+        The forms below are arranged so that nothing cancels as r goes to 0; check_enthalpy_equations
+        makes sure they're still the TOV equations. """
+    P_term = v + 4*pi*P
+    s = sp.sqrt(1 - 2*v*u)
+    dP = -(energy_density + P)
+    dnu = sp.Integer(2) # nu = -2h + constant, exactly.
+    dv = (4*pi*energy_density - 3*v)*(1 - 2*v*u)/(u*P_term)
+    dw = 2*v*w*s/((1 + s)*P_term)
+    du = 2*(1 - 2*v*u)/P_term
+    return [dP, dnu, dv, dw, du]
+
+
+def check_enthalpy_equations():
+    """ The enthalpy equations, by the chain rule from TOV_equations: d/d(-h) = (2/(dnu/dr)) d/dr. """
+    r_of_x = {x: sp.sqrt(u), m: v*sp.sqrt(u)**3, rbar: w*sp.sqrt(u)}
+    dP, dnu, dm, drbar = [e.subs(r_of_x) for e in TOV_equations(rho)]
+    dr = 2/dnu
+    r = sp.sqrt(u)
+    derived = [dP*dr, dnu*dr, (dm/r**3 - 3*v/r)*dr, (drbar/r - w/r)*dr, 2*r*dr]
+    for expression, check in zip(TOV_enthalpy_equations(rho), derived):
+        if sp.simplify(expression - check) != 0:
+            print("check_enthalpy_equations: " + str(expression) + " isn't " + str(sp.simplify(check)))
+            sys.exit(1)
+
+
+def polytrope_energy_density():
+    """ Total energy density of one polytropic piece, P = K rho_b^Gamma with energy constant a. """
+    baryon_density = (P/K)**(1/Gamma)
+    return (1 + a)*baryon_density + P/(Gamma - 1)
+
+
+def TOV_center_series():
+    """ The Taylor expansion about the center, where the equations themselves are 0/0.
+        Every function is even or odd in r there, so P and nu go to r^4 and m and rbar to r^5,
+        all in terms of the central pressure, energy density and drho/dP (which is all of the EOS
+        that reaches this order). The coefficients come from putting the series into the
+        equations and matching powers of r. """
+    P_c, rho_c, drho_dP_c = sp.symbols("P_c rho_c drho_dP_c", real=True)
+    P2, P4, nu2, nu4, m3, m5, rbar2, rbar4 = sp.symbols("P2 P4 nu2 nu4 m3 m5 rbar2 rbar4")
+    r = sp.Symbol("r", positive=True)
+    P_series = P_c + P2*r**2 + P4*r**4
+    rho_series = rho_c + drho_dP_c*(P_series - P_c)
+    m_series = m3*r**3 + m5*r**5
+    nu_series = nu2*r**2 + nu4*r**4
+    rbar_series = r*(1 + rbar2*r**2 + rbar4*r**4) # rbar'(0) = 1, as diffy_Q_eval always had it.
+
+    def matched(expression, powers):
+        expanded = sp.expand(sp.series(expression, r, 0, max(powers) + 1).removeO())
+        return [expanded.coeff(r, power) for power in powers]
+    # The equations with the denominators multiplied out (and squared, for the square root).
+    conditions = matched(sp.diff(m_series, r) - 4*pi*r**2*rho_series, [2, 4])
+    conditions += matched(sp.diff(nu_series, r)*r*(r - 2*m_series) - 2*(m_series + 4*pi*r**3*P_series), [3, 5])
+    conditions += matched(sp.diff(P_series, r) + (rho_series + P_series)*sp.diff(nu_series, r)/2, [1, 3])
+    conditions += matched((r*sp.diff(rbar_series, r))**2*(1 - 2*m_series/r) - rbar_series**2, [4, 6])
+    coefficients = sp.solve(conditions, [P2, P4, nu2, nu4, m3, m5, rbar2, rbar4], dict=True)[0]
+    series = [e.subs(coefficients).subs(r, x) for e in [P_series, nu_series, m_series, rbar_series]]
+    return series, coefficients[P2]
+
+
+def scalar_body(expressions, outputs, variables=("P", None, "m", "rbar")):
+    """ Plain C for the expressions, with CSE. variables names y[0], y[1] and so on. """
+    body = "    const double " + str(pi) + " = " + pi_value + ";\n"
+    for i, name in enumerate(variables):
+        if name is not None:
+            body += "    const double " + name + " = y[" + str(i) + "];\n"
+    body += outC.outputC(expressions, outputs, filename="returnstring",
+                         params="includebraces=False,outCverbose=False,CSE_preprocess=True,preindent=2")
+    return body
+
+
+def SIMD_body(expressions, outputs, inputs, scalars):
+    """ SIMD_width points at a time, through NRPy+'s SIMD intrinsics, then the leftovers one by one.
+        inputs are per point (gathered into lanes), scalars are the same for every point. """
+    code = outC.outputC(expressions, [o + "_SIMD" for o in outputs], filename="returnstring",
+                        params="includebraces=False,outCverbose=False,enable_SIMD=True")
+    constants = [line for line in code.splitlines() if "ConstSIMD" in line or line.startswith("const double")]
+    assignments = [line for line in code.splitlines() if line.strip() and line not in constants]
+    body = "    const double tmp" + str(pi) + " = " + pi_value + ";\n"
+    body += "    const REAL_SIMD_ARRAY " + str(pi) + " = ConstSIMD(tmp" + str(pi) + ");\n"
+    for name in scalars:
+        body += "    const REAL_SIMD_ARRAY " + name + " = ConstSIMD(" + name + "_in);\n"
+    for line in constants:
+        body += "    " + line + "\n"
+    body += "    int points_SIMD = points - points % SIMD_width;\n"
+    body += "    for (int p = 0; p < points_SIMD; p += SIMD_width) {\n"
+    # The points aren't next to each other in memory, so they're gathered into lanes first.
+    for name, source in inputs:
+        body += "        double " + name + "_lanes[SIMD_width];\n"
+    body += "        for (int l = 0; l < SIMD_width; l++) {\n"
+    for name, source in inputs:
+        body += "            " + name + "_lanes[l] = " + source + ";\n"
+    body += "        }\n"
+    for name, source in inputs:
+        body += "        const REAL_SIMD_ARRAY " + name + " = ReadSIMD(" + name + "_lanes);\n"
+    for line in assignments:
+        if not line.startswith("const"):
+            line = "const REAL_SIMD_ARRAY " + line.strip()
+        body += "        " + line.strip() + "\n"
+    for output in outputs:
+        body += "        double " + output + "_lanes[SIMD_width];\n"
+        body += "        WriteSIMD(" + output + "_lanes, " + output + "_SIMD);\n"
+    body += "        for (int l = 0; l < SIMD_width; l++) {\n"
+    for i, output in enumerate(outputs):
+        if output == "rho":
+            body += "            rho[p+l] = rho_lanes[l];\n"
+        else:
+            body += "            dydx[p+l][" + str(i) + "] = " + output + "_lanes[l];\n"
+    body += "        }\n"
+    body += "    }\n"
+    return body
+
+
+def TOV_rhs_C(enable_SIMD=False):
+    """ The whole of nrpy_odiegm_TOV_rhs.c, as a string. """
+    outputs = ["dydx[0]", "dydx[1]", "dydx[2]", "dydx[3]"]
+    given_rho = TOV_equations(rho)
+    polytrope_rho = polytrope_energy_density()
+    polytrope = TOV_equations(polytrope_rho) + [polytrope_rho]
+
+    functions = []
+    functions.append(outC.Cfunction(
+        desc="The TOV equations for a given total energy density rho, for x > 0.",
+        c_type="void", name="TOV_rhs",
+        params="double x, const double y[], double rho, double dydx[]",
+        body=scalar_body(given_rho, outputs), enableCparameters=False)[1])
+    functions.append(outC.Cfunction(
+        desc="The TOV equations for one polytropic piece (K, Gamma, energy constant a), for x > 0.\n"
+             "The total energy density comes back in *rho.",
+        c_type="void", name="TOV_rhs_polytrope",
+        params="double x, const double y[], double K, double Gamma, double a, double *rho, double dydx[]",
+        body=scalar_body(polytrope, outputs + ["*rho"]), enableCparameters=False)[1])
+    functions.append(outC.Cfunction(
+        desc="The TOV equations in x = -h (h the pseudo-enthalpy) for a given total energy density rho,\n"
+             "with y = (P, nu, m/r^3, rbar/r, r^2). Good everywhere but the center, the surface included.",
+        c_type="void", name="TOV_rhs_enthalpy",
+        params="const double y[], double rho, double dydx[]",
+        body=scalar_body(TOV_enthalpy_equations(rho), outputs + ["dydx[4]"], ("P", None, "v", "w", "u")),
+        enableCparameters=False)[1])
+    functions.append(outC.Cfunction(
+        desc="Which piece of a piecewise polytrope pressure P is in.\n"
+             "P_boundary holds the pieces-1 pressures between the pieces, increasing.",
+        c_type="int", name="TOV_polytrope_piece",
+        params="double P, int pieces, const double P_boundary[]",
+        body="    int piece = 0;\n"
+             "    while (piece < pieces-1 && P > P_boundary[piece]) {\n"
+             "        piece++;\n"
+             "    }\n"
+             "    return piece;\n", enableCparameters=False)[1])
+
+    series, P2 = TOV_center_series()
+    body = "    const double " + str(pi) + " = " + pi_value + ";\n"
+    # Relative to the center, P changes over a length L = sqrt(P_c/|P2|) and the first term left
+    # out goes like (x/L)^6, so that's what sets how far out the series can be trusted.
+    body += "    const double P2 = " + sp.ccode(P2) + ";\n"
+    # (Limits below double precision don't mean anything, and would put x back at the center.)
+    body += "    const double x = sqrt(P_c/fabs(P2))*pow(fmax(error_limit, 1e-16), 1.0/6.0);\n"
+    body += outC.outputC(series, ["y[0]", "y[1]", "y[2]", "y[3]"], filename="returnstring",
+                         params="includebraces=False,outCverbose=False,CSE_preprocess=True,preindent=2")
+    body += "    return x;\n"
+    functions.append(outC.Cfunction(
+        desc="The solution a short way out from the center, from its Taylor expansion there.\n"
+             "Goes as far out as the first term left out stays below error_limit (relative to the\n"
+             "central pressure), fills y in there and returns how far that is.",
+        c_type="double", name="TOV_center_series",
+        params="double P_c, double rho_c, double drho_dP_c, double error_limit, double y[]",
+        body=body.replace("_pi", str(pi)), enableCparameters=False)[1])
+
+    if enable_SIMD:
+        lanes = ["dydx0", "dydx1", "dydx2", "dydx3"]
+        state = [("x", "x_in[p+l]"), ("P", "y[p+l][0]"), ("m", "y[p+l][2]"), ("rbar", "y[p+l][3]")]
+        body = SIMD_body(given_rho, lanes, state + [("rho", "rho_in[p+l]")], [])
+        body += "    for (int p = points_SIMD; p < points; p++) {\n"
+        body += "        TOV_rhs(x_in[p], y[p], rho_in[p], dydx[p]);\n"
+        body += "    }\n"
+        functions.append(outC.Cfunction(
+            desc="TOV_rhs at several points, SIMD_width at a time, for x > 0.",
+            c_type="void", name="TOV_rhs_SIMD",
+            params="int points, const double x_in[], double *y[], const double rho_in[], double *dydx[]",
+            body=body, enableCparameters=False)[1])
+        body = SIMD_body(polytrope, lanes + ["rho"], state, ["K", "Gamma", "a"])
+        body += "    for (int p = points_SIMD; p < points; p++) {\n"
+        body += "        TOV_rhs_polytrope(x_in[p], y[p], K_in, Gamma_in, a_in, &rho[p], dydx[p]);\n"
+        body += "    }\n"
+        functions.append(outC.Cfunction(
+            desc="TOV_rhs_polytrope at several points sharing one piece, SIMD_width at a time, for x > 0.",
+            c_type="void", name="TOV_rhs_polytrope_SIMD",
+            params="int points, const double x_in[], double *y[], double K_in, double Gamma_in, double a_in,\n"
+                   "    double rho[], double *dydx[]",
+            body=body, enableCparameters=False)[1])
+        # The batch version of diffy_Q_eval: the EOS and the exceptions point by point, as diffy_Q_eval
+        # does them, then the equations SIMD_width points at a time.
+        functions.append(outC.Cfunction(
+            desc="diffy_Q_eval for several points at once, for nrpy_odiegm_system.batch_function.",
+            c_type="int", name="diffy_Q_eval_batch",
+            params="int points, const double x[], double *y[], double *dydx[], void *params",
+            body="    double rho[points];\n"
+                 "    for (int p = 0; p < points; p++) {\n"
+                 "        exception_handler(x[p],y[p]);\n"
+                 "        const_eval(x[p],y[p],params);\n"
+                 "        rho[p] = (*(struct constant_parameters*)params).rho;\n"
+                 "    }\n"
+                 "    TOV_rhs_SIMD(points, x, y, rho, dydx);\n"
+                 "    return 0;\n", enableCparameters=False)[1])
+
+    text = "\n// The TOV right hand side, written by nrpy_odiegm_TOV_rhs.py.\n"
+    text += "// Regenerate this file (python3 nrpy_odiegm_TOV_rhs.py) rather than editing it.\n"
+    if enable_SIMD:
+        text += "#include \"SIMD/SIMD_intrinsics.h\"\n"
+        text += "#define TOV_RHS_SIMD // Lets the main file know diffy_Q_eval_batch is here.\n"
+    for function in functions:
+        text += "\n" + function.replace(" {\n\n", " {\n")
+    return text
+
+
+def write_TOV_rhs(filename="nrpy_odiegm_TOV_rhs.c", enable_SIMD=False):
+    check_enthalpy_equations()
+    with open(filename, "w") as file:
+        file.write(TOV_rhs_C(enable_SIMD))
+    print("Wrote to file \"" + filename + "\"")
+
+
+if __name__ == "__main__":
+    write_TOV_rhs(enable_SIMD=("--simd" in sys.argv))
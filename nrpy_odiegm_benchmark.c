@@ -0,0 +1,108 @@
+
+#include "nrpy_odiegm_funcs.c" //nrpy_odiegm itself.
+#include "nrpy_odiegm_user_methods.c" //user-dependent functions.
+
+// This file is not part of Odie either, it is a work-precision benchmark for the adaptive methods.
+// Every method integrates the same system (whatever diffy_Q_eval in nrpy_odiegm_user_methods.c
+// declares, by default the TOV equations) from the initial condition out to a fixed position
+// at a range of error limits. For each run it reports how many times the right hand side
+// was evaluated, and how far the answer landed from a reference solution.
+// The method that reaches a given error with the fewest evaluations is the one to use.
+
+long benchmark_evaluations = 0;
+
+int counted_diffy_Q_eval (double x, double y[], double dydx[], void *params)
+{
+    // Pass straight through to the real system, but keep count.
+    benchmark_evaluations++;
+    return diffy_Q_eval(x, y, dydx, params);
+}
+
+double benchmark_run (const nrpy_odiegm_step_type * step_type, double error_limit,
+                      double final_position, double y[], long *steps)
+{
+    // Solve out to final_position with the given method and error limit, handing back
+    // the answer in y and the number of steps taken. Returns where we actually stopped.
+    // The evaluation count is kept in benchmark_evaluations.
+    struct constant_parameters cp;
+    cp.dimension = 1;
+    nrpy_odiegm_system system = {counted_diffy_Q_eval,known_Q_eval,4,&cp,NULL,NULL,NULL,NULL};
+
+    double current_position = 0.0;
+    get_initial_condition(y);
+    const_eval(current_position, y, &cp);
+    // The TOV equations are 0/0 at the center, so, as in nrpy_odiegm_main.c, series_start 
+    // moves us out with the series expansion first. It's held to 1e-16 whatever the error limit, 
+    // so every run starts from the same point and the errors are the methods' alone. 
+    current_position = series_start(current_position, y, &cp, 1e-16);
+
+    nrpy_odiegm_driver *d;
+    d = nrpy_odiegm_driver_alloc_y_new(&system, step_type, 0.00001, error_limit, error_limit);
+    d->h = 0.0; // Off the center, every method estimates its own first step. 
+    d->s->adams_bashforth_order = 0;
+
+    benchmark_evaluations = 0;
+    *steps = 0;
+    while (current_position < final_position) {
+        nrpy_odiegm_evolve_apply(d->e, d->c, d->s, &system, &current_position, final_position, &(d->h), y);
+        exception_handler(current_position,y);
+        *steps = *steps + 1;
+    }
+
+    nrpy_odiegm_driver_free(d);
+    return current_position;
+}
+
+int main()
+{
+    printf("Beginning ODE Solver \"Odie\" Work-Precision Benchmark...\n");
+
+    const int number_of_equations = 4;
+    double final_position = 0.5; // Where we compare answers.
+    // For the default TOV star this is well inside the surface, where the equations are smooth.
+    // Past the surface the pressure is clamped to zero and every method's error is
+    // dominated by how it crosses the surface rather than its order.
+
+    // The methods under test, and the error limits we run them at.
+    const nrpy_odiegm_step_type * step_types[] = {nrpy_odiegm_step_ADP5, nrpy_odiegm_step_Tsit5,
+                                                  nrpy_odiegm_step_Vern6, nrpy_odiegm_step_ADP8,
+                                                  nrpy_odiegm_step_Vern7, nrpy_odiegm_step_Vern9,
+                                                  nrpy_odiegm_step_GBS};
+    const char *step_names[] = {"ADP5", "Tsit5", "Vern6", "ADP8", "Vern7", "Vern9", "GBS"};
+    const int number_of_methods = 7;
+    const double error_limits[] = {1e-6, 1e-8, 1e-10, 1e-12, 1e-14};
+    const int number_of_limits = 5;
+
+    // The reference is the highest order method at the tightest limit we can ask for.
+    double y_reference[number_of_equations];
+    long steps = 0;
+    benchmark_run(nrpy_odiegm_step_ADP8, 1e-16, final_position, y_reference, &steps);
+    printf("Reference: ADP8 at 1e-16, %ld steps, %ld evaluations.\n", steps, benchmark_evaluations);
+    printf("Reference at r = %f:", final_position);
+    for (int n = 0; n < number_of_equations; n++) {
+        printf(" %15.14e", y_reference[n]);
+    }
+    printf("\n\n");
+
+    printf("%-8s %-8s %8s %12s %15s\n", "Method", "Limit", "Steps", "Evaluations", "Max Rel. Error");
+    for (int k = 0; k < number_of_limits; k++) {
+        for (int m = 0; m < number_of_methods; m++) {
+            double y[number_of_equations];
+            benchmark_run(step_types[m], error_limits[k], final_position, y, &steps);
+
+            double error = 0.0;
+            for (int n = 0; n < number_of_equations; n++) {
+                double relative = fabs(y[n] - y_reference[n]);
+                if (y_reference[n] != 0.0) {
+                    relative = relative/fabs(y_reference[n]);
+                }
+                if (relative > error) {
+                    error = relative;
+                }
+            }
+            printf("%-8s %-8.0e %8ld %12ld %15.6e\n", step_names[m], error_limits[k], steps, benchmark_evaluations, error);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+""" Generate unrolled step kernels for Odie's explicit adaptive methods
+
+    nrpy_odiegm_evolve_apply handles every explicit Runge-Kutta method with one loop over
+    stages, one over the weights of each stage, and one over the equations, reading the
+    Butcher table as it goes. This script writes a dedicated C function for a given table
+    instead: every stage spelled out, the zero weights gone, the coefficients folded into
+    constants, so all that's left at runtime is the loop over the equations.
+
+    The tables are read straight from nrpy_odiegm.h, so there is only one copy of them.
+    The output, nrpy_odiegm_kernels.c, defines one kernel per method (nrpy_odiegm_kernel_ADP5
+    and so on) and nrpy_odiegm_builtin_kernel, which matches a built-in table to its kernel.
+    The step types in nrpy_odiegm.h don't point at the kernels (so the header links without
+    them): evolve_apply asks nrpy_odiegm_builtin_kernel, or takes a user step type's own
+    kernel field, and calls the kernel instead of its own stage loop if there is one.
+    The plain C kernels add the terms up in the same order evolve_apply does, so the answers
+    don't change by a single bit, only how fast they arrive.
+
+    With enable_SIMD=True the loop over the equations is written with NRPy+'s SIMD
+    intrinsics (FusedMulAddSIMD and so on, through SIMD.py), SIMD_width equations at a time.
+    That needs NRPy+'s SIMD/SIMD_intrinsics.h on the include path, which isn't part of this
+    repository, so the checked-in kernels are the plain C ones. The fused multiply-adds
+    round differently, so SIMD kernels agree with the generic loop to rounding, not bitwise.
+
+    Usage: python3 nrpy_odiegm_codegen.py [--simd]
+"""
+# Author: Gabriel M Steward
+
+import re                       # Standard Python module for regular expressions
+import sys                      # Standard Python module for multiplatform OS-level functions
+import sympy as sp              # SymPy: The Python computer algebra package upon which NRPy+ depends
+import outputC as outC          # NRPy+: Core C code output module
+
+# The methods that get a kernel: the adaptive tables (rows = columns + 1) in nrpy_odiegm.h.
+kernel_methods = ["ADP5", "Tsit5", "Vern6", "Vern7", "ADP8", "Vern9"]
+
+
+def coefficient_from_C(literal):
+    """ Turn a table entry as written in nrpy_odiegm.h into a SymPy number that prints back as
+        the same double. Fractions (1.0/5.0, -355.0/33.0) become exact rationals, which print
+        as the same fraction. Decimals (0.161) stay decimals: a 17 digit numerator doesn't fit
+        in a double, so as a fraction it would be rounded twice. """
+    parts = literal.strip().split("/")
+    if len(parts) == 1:
+        if float(parts[0]) == int(float(parts[0])):
+            return sp.Integer(int(float(parts[0])))
+        return sp.Float(parts[0], 17)
+    value = sp.Rational(parts[0])
+    for denominator in parts[1:]:
+        value = value/sp.Rational(denominator)
+    return value
+
+
+def butcher_table_from_header(name, header="nrpy_odiegm.h"):
+    """ Read butcher_<name> out of the header, as a list of rows of rationals. """
+    with open(header, "r") as file:
+        text = file.read()
+    table = re.search(r"double butcher_" + name + r"\[(\d+)\]\[(\d+)\] = \{(.*?)\};", text, re.S)
+    if table is None:
+        print("butcher_table_from_header: no table butcher_" + name + " in " + header)
+        sys.exit(1)
+    rows = int(table.group(1))
+    columns = int(table.group(2))
+    table_rows = [[coefficient_from_C(entry) for entry in row.split(",")]
+                  for row in re.findall(r"\{([^{}]*)\}", table.group(3))]
+    if len(table_rows) != rows or any(len(row) != columns for row in table_rows):
+        print("butcher_table_from_header: butcher_" + name + " isn't " + str(rows) + " by " + str(columns))
+        sys.exit(1)
+    return table_rows
+
+
+def combination_code(outputs, expressions, enable_SIMD, indent):
+    """ The loop over the equations for one or more outputs y + sum of a*K.
+        Plain C, or NRPy+ SIMD intrinsics with a plain C loop for whatever is left over. """
+    scalar_symbols = sorted(set().union(*[e.free_symbols for e in expressions]), key=str)
+    # The plain C loop keeps the terms in the order they were built (y first, then stage by stage),
+    # which is the order nrpy_odiegm_stage_combination adds them in.
+    scalar_body = ""
+    for output, expression in zip(outputs, expressions):
+        scalar_body += output + "[n] = " + sp.ccode(expression, order="none") + ";\n"
+    scalar_body = re.sub(r"\b(\w+)_n\b", r"\1[n]", scalar_body)
+    code = ""
+    start = "0"
+    if enable_SIMD:
+        # Each combination gets its own block, so its constants don't clash with the next stage's.
+        code += indent + "{\n"
+        indent += "    "
+        # SIMD.py makes ConstSIMDs out of rationals but not decimals, so those get named here.
+        decimals = sorted(set().union(*[e.atoms(sp.Float) for e in expressions]), key=float)
+        names = {f: sp.Symbol("_Decimal_" + str(i)) for i, f in enumerate(decimals)}
+        for f in decimals:
+            code += indent + "const double tmp" + str(names[f]) + " = " + sp.ccode(f) + ";\n"
+            code += indent + "const REAL_SIMD_ARRAY " + str(names[f]) + " = ConstSIMD(tmp" + str(names[f]) + ");\n"
+        expressions = [e.xreplace(names) for e in expressions]
+        SIMD_body = outC.outputC(expressions, [o + "_n" for o in outputs], filename="returnstring",
+                                 params="includebraces=False,outCverbose=False,enable_SIMD=True")
+        # The rational constants only need setting up once, the rest (including any common
+        # subexpressions) is per equation.
+        constants = [line for line in SIMD_body.splitlines() if "ConstSIMD" in line or line.startswith("const double")]
+        assignments = [line for line in SIMD_body.splitlines() if line.strip() and line not in constants]
+        for line in constants:
+            code += indent + line + "\n"
+        code += indent + "int n_SIMD = number_of_equations - number_of_equations % SIMD_width;\n"
+        code += indent + "for (int n = 0; n < n_SIMD; n += SIMD_width) {\n"
+        for symbol in scalar_symbols:
+            code += indent + "    const REAL_SIMD_ARRAY " + str(symbol) + " = ReadSIMD(&" + str(symbol)[:-2] + "[n]);\n"
+        for line in assignments:
+            if not line.startswith("const"):
+                line = "const REAL_SIMD_ARRAY " + line.strip()
+            code += indent + "    " + line.strip() + "\n"
+        for output in outputs:
+            code += indent + "    WriteSIMD(&" + output + "[n], " + output + "_n);\n"
+        code += indent + "}\n"
+        start = "n_SIMD"
+    code += indent + "for (int n = " + start + "; n < number_of_equations; n++) {\n"
+    for line in scalar_body.splitlines():
+        if line.strip():
+            code += indent + "    " + line.strip() + "\n"
+    code += indent + "}\n"
+    if enable_SIMD:
+        code += indent[:-4] + "}\n"
+    return code
+
+
+def weighted_sum(y, weights, K):
+    """ y + sum of weight*K over the nonzero weights, left unevaluated so the terms stay in order. """
+    terms = [sp.Mul(weights[l], K[l], evaluate=False) for l in range(1, len(weights)) if weights[l] != 0]
+    return sp.Add(y, *terms, evaluate=False)
+
+
+def stepper_kernel(name, enable_SIMD=False, header="nrpy_odiegm.h"):
+    """ The kernel for one method, as a string of C. """
+    table = butcher_table_from_header(name, header)
+    stages = len(table[0]) - 1
+    if len(table) != stages + 2 or table[0][0] != 0:
+        print("stepper_kernel: butcher_" + name + " isn't an adaptive table starting at x")
+        sys.exit(1)
+    y = sp.Symbol("y_n")
+    K = [None] + [sp.Symbol("K" + str(j) + "_n") for j in range(1, stages + 1)]
+
+    body = "    int number_of_equations = (int)(dydt->dimension);\n"
+    body += "    double * restrict K1 = K + number_of_equations;\n"
+    body += "    for (int n = 0; n < number_of_equations; n++) {\n"
+    body += "        K1[n] = h*f_start[n];\n"
+    body += "    }\n"
+    for j in range(2, stages + 1):
+        # Stage j: y + sum of a_jl*K_l, then f there. Only the nonzero weights are written out.
+        stage = weighted_sum(y, table[j-1][:j], K)
+        body += "\n    // Stage " + str(j) + ".\n"
+        body += "    double * restrict K" + str(j) + " = K + " + str(j) + "*number_of_equations;\n"
+        body += combination_code(["y_insert"], [stage], enable_SIMD, "    ")
+        position = "x + h"
+        if table[j-1][0] != 1:
+            position = "x + " + sp.ccode(table[j-1][0]) + "*h"
+        body += "    dydt->function(" + position + ", y_insert, f_last, dydt->params);\n"
+        body += "    for (int n = 0; n < number_of_equations; n++) {\n"
+        body += "        K" + str(j) + "[n] = h*f_last[n];\n"
+        body += "    }\n"
+    answer = weighted_sum(y, table[stages], K)
+    embedded = weighted_sum(y, table[stages+1], K)
+    body += "\n    // The answer and the embedded solution, in one pass.\n"
+    body += combination_code(["y_new", "y_embedded"], [answer, embedded], enable_SIMD, "    ")
+    body += "    return 0;\n"
+
+    desc = ("Generated by nrpy_odiegm_codegen.py from butcher_" + name + " in nrpy_odiegm.h, don't edit by hand.\n"
+            "One step of " + name + " from (x, y), the same as nrpy_odiegm_evolve_apply's stage loop:\n"
+            "K holds the K-values (h*f at each stage, stage j at K + j*dimension, like the dense output),\n"
+            "f_start is f(x, y), f_last comes back as f at the last stage.\n"
+            "y_insert is scratch space for the stage inputs, as long as y. It's the caller's so that\n"
+            "nothing the size of the system goes on the stack.")
+    params = ("const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],\n"
+              "    double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]")
+    _prototype, function = outC.Cfunction(desc=desc, c_type="int", name="nrpy_odiegm_kernel_" + name,
+                                          params=params, body=body, enableCparameters=False)
+    return function.replace(" {\n\n", " {\n")
+
+
+def builtin_kernel_lookup():
+    """ Matches each built-in table to its kernel. This lives here rather than in the step types
+        in nrpy_odiegm.h, so that including the header never needs the kernels to link. """
+    body = ("\n// The generated kernel for a built-in table, NULL if it doesn't have one.\n"
+            "nrpy_odiegm_kernel nrpy_odiegm_builtin_kernel (const nrpy_odiegm_step_type * step_type) {\n")
+    for name in kernel_methods:
+        body += ("    if (step_type->butcher == (void *)butcher_" + name + ") {\n"
+                 "        return nrpy_odiegm_kernel_" + name + ";\n"
+                 "    }\n")
+    body += "    return NULL;\n}\n"
+    return body
+
+
+def write_kernels(filename="nrpy_odiegm_kernels.c", enable_SIMD=False, header="nrpy_odiegm.h"):
+    """ Every method's kernel, in one file that nrpy_odiegm_funcs.c includes. """
+    with open(filename, "w") as file:
+        file.write("\n// Unrolled step kernels for the adaptive methods, written by nrpy_odiegm_codegen.py.\n")
+        file.write("// Regenerate this file (python3 nrpy_odiegm_codegen.py) rather than editing it.\n")
+        if enable_SIMD:
+            file.write("#include \"SIMD/SIMD_intrinsics.h\"\n")
+        for name in kernel_methods:
+            file.write("\n" + stepper_kernel(name, enable_SIMD, header))
+        file.write(builtin_kernel_lookup())
+    print("Wrote to file \"" + filename + "\"")
+
+
+if __name__ == "__main__":
+    write_kernels(enable_SIMD=("--simd" in sys.argv))
@@ -0,0 +1,73 @@
+// Checks on nrpy_odiegm.hpp's error kernel: masked components have to drop out of the step control
+// completely, even when their error estimate is inf or NaN.
+// Build and run with: g++ -std=c++17 -O2 nrpy_odiegm_hpp_test.cpp -o nrpy_odiegm_hpp_test && ./nrpy_odiegm_hpp_test
+// It prints one line per check and returns nonzero if any of them fail.
+
+// Author: Gabriel M Steward
+
+#include <cstdio>
+#include <limits>
+
+#include "nrpy_odiegm.hpp"
+
+int failures = 0;
+
+void check (bool passed, const char *what) {
+    printf("%s: %s\n", passed ? "PASS" : "FAIL", what);
+    if (passed == false) {
+        failures++;
+    }
+}
+
+int main () {
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    // y0' = -y0 is the one we care about. y1' is inf, so y1 and its error estimate are garbage.
+    auto rhs = [&](double x, std::array<double, 2> &y, std::array<double, 2> &dydx) {
+        dydx[0] = -y[0];
+        dydx[1] = infinity;
+    };
+    using Integrator = odiegm::Integrator<odiegm::ADP5, decltype(rhs), 2>;
+
+    double abs_lim_vector[2] = {1e-10, 0.0};
+    double rel_lim_vector[2] = {1e-10, 0.0};
+    double error_weight[2] = {1.0, 0.0};
+
+    for (int error_norm = 0; error_norm < 2; error_norm++) {
+        Integrator integrator(rhs, 1e-10, 1e-10);
+        integrator.control.error_norm = error_norm;
+        integrator.control.abs_lim_vector = abs_lim_vector;
+        integrator.control.rel_lim_vector = rel_lim_vector;
+        integrator.control.error_weight = error_weight;
+
+        // The kernel on its own: only the first component should count.
+        std::array<double, 2> yerr = {1e-12, infinity};
+        std::array<double, 2> y = {1.0, infinity};
+        std::array<double, 2> dydx = {0.0, infinity};
+        double ratio = integrator.error_ratio(0.1, yerr, y, dydx);
+        check(ratio > 0.0049 && ratio < 0.0051, error_norm == 0 ? "masked inf component, max norm"
+                                                                : "masked inf component, RMS norm");
+
+        // And a whole solve: the first component has to come out right, in a sensible number of steps.
+        std::array<double, 2> y_solve = {1.0, 0.0};
+        double t = 0.0;
+        double h = 0.0;
+        while (t < 1.0) {
+            integrator.evolve_apply(&t, 1.0, &h, y_solve);
+        }
+        check(std::fabs(y_solve[0] - std::exp(-1.0)) < 1e-8 && integrator.count < 1000,
+              error_norm == 0 ? "solve with a masked inf component, max norm"
+                              : "solve with a masked inf component, RMS norm");
+    }
+
+    // Per-component limits without a mask: every component counts, and nothing reads the NULL mask.
+    Integrator integrator(rhs, 1e-10, 1e-10);
+    integrator.control.abs_lim_vector = abs_lim_vector;
+    integrator.control.rel_lim_vector = rel_lim_vector;
+    std::array<double, 2> yerr = {1e-12, 1e-12};
+    std::array<double, 2> y = {1.0, 1.0};
+    std::array<double, 2> dydx = {0.0, 0.0};
+    check(std::isinf(integrator.error_ratio(0.1, yerr, y, dydx)), "per-component limits with no mask");
+
+    return failures;
+}
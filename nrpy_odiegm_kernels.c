@@ -0,0 +1,730 @@
+
+// Unrolled step kernels for the adaptive methods, written by nrpy_odiegm_codegen.py.
+// Regenerate this file (python3 nrpy_odiegm_codegen.py) rather than editing it.
+
+/*
+ * Generated by nrpy_odiegm_codegen.py from butcher_ADP5 in nrpy_odiegm.h, don't edit by hand.
+ * One step of ADP5 from (x, y), the same as nrpy_odiegm_evolve_apply's stage loop:
+ * K holds the K-values (h*f at each stage, stage j at K + j*dimension, like the dense output),
+ * f_start is f(x, y), f_last comes back as f at the last stage.
+ * y_insert is scratch space for the stage inputs, as long as y. It's the caller's so that
+ * nothing the size of the system goes on the stack.
+ */
+int nrpy_odiegm_kernel_ADP5(const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],
+    double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]) {
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict K1 = K + number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        K1[n] = h*f_start[n];
+    }
+
+    // Stage 2.
+    double * restrict K2 = K + 2*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (1.0/5.0)*K1[n];
+    }
+    dydt->function(x + 1.0/5.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K2[n] = h*f_last[n];
+    }
+
+    // Stage 3.
+    double * restrict K3 = K + 3*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (3.0/40.0)*K1[n] + (9.0/40.0)*K2[n];
+    }
+    dydt->function(x + 3.0/10.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K3[n] = h*f_last[n];
+    }
+
+    // Stage 4.
+    double * restrict K4 = K + 4*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (44.0/45.0)*K1[n] - 56.0/15.0*K2[n] + (32.0/9.0)*K3[n];
+    }
+    dydt->function(x + 4.0/5.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K4[n] = h*f_last[n];
+    }
+
+    // Stage 5.
+    double * restrict K5 = K + 5*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (19372.0/6561.0)*K1[n] - 25360.0/2187.0*K2[n] + (64448.0/6561.0)*K3[n] - 212.0/729.0*K4[n];
+    }
+    dydt->function(x + 8.0/9.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K5[n] = h*f_last[n];
+    }
+
+    // Stage 6.
+    double * restrict K6 = K + 6*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (9017.0/3168.0)*K1[n] - 355.0/33.0*K2[n] + (46732.0/5247.0)*K3[n] + (49.0/176.0)*K4[n] - 5103.0/18656.0*K5[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K6[n] = h*f_last[n];
+    }
+
+    // Stage 7.
+    double * restrict K7 = K + 7*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (35.0/384.0)*K1[n] + (500.0/1113.0)*K3[n] + (125.0/192.0)*K4[n] - 2187.0/6784.0*K5[n] + (11.0/84.0)*K6[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K7[n] = h*f_last[n];
+    }
+
+    // The answer and the embedded solution, in one pass.
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n] + (35.0/384.0)*K1[n] + (500.0/1113.0)*K3[n] + (125.0/192.0)*K4[n] - 2187.0/6784.0*K5[n] + (11.0/84.0)*K6[n];
+        y_embedded[n] = y[n] + (5179.0/57600.0)*K1[n] + (7571.0/16695.0)*K3[n] + (393.0/640.0)*K4[n] - 92097.0/339200.0*K5[n] + (187.0/2100.0)*K6[n] + (1.0/40.0)*K7[n];
+    }
+    return 0;
+}
+
+/*
+ * Generated by nrpy_odiegm_codegen.py from butcher_Tsit5 in nrpy_odiegm.h, don't edit by hand.
+ * One step of Tsit5 from (x, y), the same as nrpy_odiegm_evolve_apply's stage loop:
+ * K holds the K-values (h*f at each stage, stage j at K + j*dimension, like the dense output),
+ * f_start is f(x, y), f_last comes back as f at the last stage.
+ * y_insert is scratch space for the stage inputs, as long as y. It's the caller's so that
+ * nothing the size of the system goes on the stack.
+ */
+int nrpy_odiegm_kernel_Tsit5(const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],
+    double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]) {
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict K1 = K + number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        K1[n] = h*f_start[n];
+    }
+
+    // Stage 2.
+    double * restrict K2 = K + 2*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.161*K1[n];
+    }
+    dydt->function(x + 0.161*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K2[n] = h*f_last[n];
+    }
+
+    // Stage 3.
+    double * restrict K3 = K + 3*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 0.008480655492356989*K1[n] + 0.335480655492357*K2[n];
+    }
+    dydt->function(x + 0.327*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K3[n] = h*f_last[n];
+    }
+
+    // Stage 4.
+    double * restrict K4 = K + 4*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 2.897153057105493*K1[n] - 6.359448489975075*K2[n] + 4.3622954328695815*K3[n];
+    }
+    dydt->function(x + 0.9*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K4[n] = h*f_last[n];
+    }
+
+    // Stage 5.
+    double * restrict K5 = K + 5*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 5.325864828439257*K1[n] - 11.748883564062828*K2[n] + 7.4955393428898365*K3[n] - 0.09249506636175525*K4[n];
+    }
+    dydt->function(x + 0.9800255409045097*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K5[n] = h*f_last[n];
+    }
+
+    // Stage 6.
+    double * restrict K6 = K + 6*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 5.86145544294642*K1[n] - 12.92096931784711*K2[n] + 8.159367898576159*K3[n] - 0.071584973281401*K4[n] - 0.028269050394068383*K5[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K6[n] = h*f_last[n];
+    }
+
+    // Stage 7.
+    double * restrict K7 = K + 7*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.09646076681806523*K1[n] + 0.01*K2[n] + 0.4798896504144996*K3[n] + 1.379008574103742*K4[n] - 3.290069515436081*K5[n] + 2.324710524099774*K6[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K7[n] = h*f_last[n];
+    }
+
+    // The answer and the embedded solution, in one pass.
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n] + 0.09646076681806523*K1[n] + 0.01*K2[n] + 0.4798896504144996*K3[n] + 1.379008574103742*K4[n] - 3.290069515436081*K5[n] + 2.324710524099774*K6[n];
+        y_embedded[n] = y[n] + 0.09824077787029101*K1[n] + 0.010816434459656746*K2[n] + 0.4720087724042376*K3[n] + 1.5237195812770048*K4[n] - 3.872426680888636*K5[n] + 2.7827926300289607*K6[n] - 0.015151515151515152*K7[n];
+    }
+    return 0;
+}
+
+/*
+ * Generated by nrpy_odiegm_codegen.py from butcher_Vern6 in nrpy_odiegm.h, don't edit by hand.
+ * One step of Vern6 from (x, y), the same as nrpy_odiegm_evolve_apply's stage loop:
+ * K holds the K-values (h*f at each stage, stage j at K + j*dimension, like the dense output),
+ * f_start is f(x, y), f_last comes back as f at the last stage.
+ * y_insert is scratch space for the stage inputs, as long as y. It's the caller's so that
+ * nothing the size of the system goes on the stack.
+ */
+int nrpy_odiegm_kernel_Vern6(const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],
+    double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]) {
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict K1 = K + number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        K1[n] = h*f_start[n];
+    }
+
+    // Stage 2.
+    double * restrict K2 = K + 2*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.06*K1[n];
+    }
+    dydt->function(x + 0.06*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K2[n] = h*f_last[n];
+    }
+
+    // Stage 3.
+    double * restrict K3 = K + 3*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.019239962962962962*K1[n] + 0.07669337037037037*K2[n];
+    }
+    dydt->function(x + 0.09593333333333333*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K3[n] = h*f_last[n];
+    }
+
+    // Stage 4.
+    double * restrict K4 = K + 4*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.035975*K1[n] + 0.107925*K3[n];
+    }
+    dydt->function(x + 0.1439*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K4[n] = h*f_last[n];
+    }
+
+    // Stage 5.
+    double * restrict K5 = K + 5*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 1.3186834152331484*K1[n] - 5.042058063628562*K3[n] + 4.220674648395414*K4[n];
+    }
+    dydt->function(x + 0.4973*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K5[n] = h*f_last[n];
+    }
+
+    // Stage 6.
+    double * restrict K6 = K + 6*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 41.872591664327516*K1[n] + 159.4325621631375*K3[n] - 122.11921356501003*K4[n] + 5.531743066200054*K5[n];
+    }
+    dydt->function(x + 0.9725*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K6[n] = h*f_last[n];
+    }
+
+    // Stage 7.
+    double * restrict K7 = K + 7*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 54.43015693531651*K1[n] + 207.06725136501848*K3[n] - 158.61081378459*K4[n] + 6.991816585950242*K5[n] - 0.018597231062203234*K6[n];
+    }
+    dydt->function(x + 0.9995*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K7[n] = h*f_last[n];
+    }
+
+    // Stage 8.
+    double * restrict K8 = K + 8*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 54.66374178728198*K1[n] + 207.95280625538936*K3[n] - 159.2889574744995*K4[n] + 7.018743740796944*K5[n] - 0.018338785905045722*K6[n] - 0.0005119484997882099*K7[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K8[n] = h*f_last[n];
+    }
+
+    // Stage 9.
+    double * restrict K9 = K + 9*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.03438957868357036*K1[n] + 0.2582624555633503*K4[n] + 0.4209371189673537*K5[n] + 4.40539646966931*K6[n] - 176.48311902429865*K7[n] + 172.36413340141507*K8[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K9[n] = h*f_last[n];
+    }
+
+    // The answer and the embedded solution, in one pass.
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n] + 0.03438957868357036*K1[n] + 0.2582624555633503*K4[n] + 0.4209371189673537*K5[n] + 4.40539646966931*K6[n] - 176.48311902429865*K7[n] + 172.36413340141507*K8[n];
+        y_embedded[n] = y[n] + 0.04909967648369985*K1[n] + 0.22511122295186925*K4[n] + 0.46946822530281707*K5[n] + 0.8065792249992284*K6[n] - 0.6071194891780128*K8[n] + 0.05686113944039828*K9[n];
+    }
+    return 0;
+}
+
+/*
+ * Generated by nrpy_odiegm_codegen.py from butcher_Vern7 in nrpy_odiegm.h, don't edit by hand.
+ * One step of Vern7 from (x, y), the same as nrpy_odiegm_evolve_apply's stage loop:
+ * K holds the K-values (h*f at each stage, stage j at K + j*dimension, like the dense output),
+ * f_start is f(x, y), f_last comes back as f at the last stage.
+ * y_insert is scratch space for the stage inputs, as long as y. It's the caller's so that
+ * nothing the size of the system goes on the stack.
+ */
+int nrpy_odiegm_kernel_Vern7(const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],
+    double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]) {
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict K1 = K + number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        K1[n] = h*f_start[n];
+    }
+
+    // Stage 2.
+    double * restrict K2 = K + 2*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.005*K1[n];
+    }
+    dydt->function(x + 0.005*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K2[n] = h*f_last[n];
+    }
+
+    // Stage 3.
+    double * restrict K3 = K + 3*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 1.07679012345679*K1[n] + 1.185679012345679*K2[n];
+    }
+    dydt->function(x + 0.10888888888888888*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K3[n] = h*f_last[n];
+    }
+
+    // Stage 4.
+    double * restrict K4 = K + 4*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.04083333333333333*K1[n] + 0.1225*K3[n];
+    }
+    dydt->function(x + 0.16333333333333333*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K4[n] = h*f_last[n];
+    }
+
+    // Stage 5.
+    double * restrict K5 = K + 5*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.6389139236255726*K1[n] - 2.455672638223657*K3[n] + 2.272258714598084*K4[n];
+    }
+    dydt->function(x + 0.4555*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K5[n] = h*f_last[n];
+    }
+
+    // Stage 6.
+    double * restrict K6 = K + 6*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 2.6615773750187572*K1[n] + 10.804513886456137*K3[n] - 8.3539146573962*K4[n] + 0.820487594956657*K5[n];
+    }
+    dydt->function(x + 0.6095094489978381*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K6[n] = h*f_last[n];
+    }
+
+    // Stage 7.
+    double * restrict K7 = K + 7*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 6.067741434696772*K1[n] - 24.711273635911088*K3[n] + 20.427517930788895*K4[n] - 1.9061579788166472*K5[n] + 1.006172249242068*K6[n];
+    }
+    dydt->function(x + 0.884*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K7[n] = h*f_last[n];
+    }
+
+    // Stage 8.
+    double * restrict K8 = K + 8*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 12.054670076253203*K1[n] - 49.75478495046899*K3[n] + 41.142888638604674*K4[n] - 4.461760149974004*K5[n] + 2.042334822239175*K6[n] - 0.09834843665406107*K7[n];
+    }
+    dydt->function(x + 0.925*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K8[n] = h*f_last[n];
+    }
+
+    // Stage 9.
+    double * restrict K9 = K + 9*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 10.138146522881808*K1[n] - 42.6411360317175*K3[n] + 35.76384003992257*K4[n] - 4.3480228403929075*K5[n] + 2.0098622683770357*K6[n] + 0.3487490460338272*K7[n] - 0.27143900510483127*K8[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K9[n] = h*f_last[n];
+    }
+
+    // Stage 10.
+    double * restrict K10 = K + 10*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 45.030072034298676*K1[n] + 187.3272437654589*K3[n] - 154.02882369350186*K4[n] + 18.56465306347536*K5[n] - 7.141809679295079*K6[n] + 1.3088085781613787*K7[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K10[n] = h*f_last[n];
+    }
+
+    // The answer and the embedded solution, in one pass.
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n] + 0.04715561848627222*K1[n] + 0.25750564298434153*K4[n] + 0.26216653977412624*K5[n] + 0.15216092656738558*K6[n] + 0.4939969170032485*K7[n] - 0.29430311714032503*K8[n] + 0.08131747232495111*K9[n];
+        y_embedded[n] = y[n] + 0.044608606606341174*K1[n] + 0.26716403785713727*K4[n] + 0.22010183001772932*K5[n] + 0.2188431703143157*K6[n] + 0.2289871705411204*K7[n] + 0.02029518466335628*K10[n];
+    }
+    return 0;
+}
+
+/*
+ * Generated by nrpy_odiegm_codegen.py from butcher_ADP8 in nrpy_odiegm.h, don't edit by hand.
+ * One step of ADP8 from (x, y), the same as nrpy_odiegm_evolve_apply's stage loop:
+ * K holds the K-values (h*f at each stage, stage j at K + j*dimension, like the dense output),
+ * f_start is f(x, y), f_last comes back as f at the last stage.
+ * y_insert is scratch space for the stage inputs, as long as y. It's the caller's so that
+ * nothing the size of the system goes on the stack.
+ */
+int nrpy_odiegm_kernel_ADP8(const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],
+    double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]) {
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict K1 = K + number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        K1[n] = h*f_start[n];
+    }
+
+    // Stage 2.
+    double * restrict K2 = K + 2*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (1.0/18.0)*K1[n];
+    }
+    dydt->function(x + 1.0/18.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K2[n] = h*f_last[n];
+    }
+
+    // Stage 3.
+    double * restrict K3 = K + 3*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (1.0/48.0)*K1[n] + (1.0/16.0)*K2[n];
+    }
+    dydt->function(x + 1.0/12.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K3[n] = h*f_last[n];
+    }
+
+    // Stage 4.
+    double * restrict K4 = K + 4*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (1.0/32.0)*K1[n] + (3.0/32.0)*K3[n];
+    }
+    dydt->function(x + 1.0/8.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K4[n] = h*f_last[n];
+    }
+
+    // Stage 5.
+    double * restrict K5 = K + 5*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (5.0/16.0)*K1[n] - 75.0/64.0*K3[n] + (75.0/64.0)*K4[n];
+    }
+    dydt->function(x + 5.0/16.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K5[n] = h*f_last[n];
+    }
+
+    // Stage 6.
+    double * restrict K6 = K + 6*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (3.0/80.0)*K1[n] + (3.0/16.0)*K4[n] + (3.0/20.0)*K5[n];
+    }
+    dydt->function(x + 3.0/8.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K6[n] = h*f_last[n];
+    }
+
+    // Stage 7.
+    double * restrict K7 = K + 7*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (29443841.0/614563906.0)*K1[n] + (77736538.0/692538347.0)*K4[n] - 28693883.0/1125000000.0*K5[n] + (23124283.0/1800000000.0)*K6[n];
+    }
+    dydt->function(x + 59.0/400.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K7[n] = h*f_last[n];
+    }
+
+    // Stage 8.
+    double * restrict K8 = K + 8*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (16016141.0/946692911.0)*K1[n] + (61564180.0/158732637.0)*K4[n] + (22789713.0/633445777.0)*K5[n] + (545815736.0/2771057229.0)*K6[n] - 180193667.0/1043307555.0*K7[n];
+    }
+    dydt->function(x + 93.0/200.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K8[n] = h*f_last[n];
+    }
+
+    // Stage 9.
+    double * restrict K9 = K + 9*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (39632708.0/573591083.0)*K1[n] - 433636366.0/683701615.0*K4[n] - 421739975.0/2616292301.0*K5[n] + (100302831.0/723423059.0)*K6[n] + (790204164.0/839813087.0)*K7[n] + (800635310.0/3783071287.0)*K8[n];
+    }
+    dydt->function(x + 5490023248.0/9719169821.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K9[n] = h*f_last[n];
+    }
+
+    // Stage 10.
+    double * restrict K10 = K + 10*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (246121993.0/1340847787.0)*K1[n] - 37695042795.0/15268766246.0*K4[n] - 309121744.0/1061227803.0*K5[n] - 12992083.0/490766935.0*K6[n] + (6005943493.0/2108947869.0)*K7[n] + (393006217.0/1396673457.0)*K8[n] + (123872331.0/1001029789.0)*K9[n];
+    }
+    dydt->function(x + 13.0/20.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K10[n] = h*f_last[n];
+    }
+
+    // Stage 11.
+    double * restrict K11 = K + 11*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 1028468189.0/846180014.0*K1[n] + (8478235783.0/508512852.0)*K4[n] + (1311729495.0/1432422823.0)*K5[n] - 10304129995.0/1701304382.0*K6[n] - 48777925059.0/3047939560.0*K7[n] + (15336726248.0/1032824649.0)*K8[n] - 45442868181.0/3398467696.0*K9[n] + (3065993473.0/597172653.0)*K10[n];
+    }
+    dydt->function(x + 1201146811.0/1299019798.0*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K11[n] = h*f_last[n];
+    }
+
+    // Stage 12.
+    double * restrict K12 = K + 12*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (185892177.0/718116043.0)*K1[n] - 3185094517.0/667107341.0*K4[n] - 477755414.0/1098053517.0*K5[n] - 703635378.0/230739211.0*K6[n] + (5731566787.0/1027545527.0)*K7[n] + (5232866602.0/850066563.0)*K8[n] - 4093664535.0/808688257.0*K9[n] + (3962137247.0/1805957418.0)*K10[n] + (65686358.0/487910083.0)*K11[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K12[n] = h*f_last[n];
+    }
+
+    // Stage 13.
+    double * restrict K13 = K + 13*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + (403863854.0/491063109.0)*K1[n] - 5068492393.0/434740067.0*K4[n] - 411421997.0/543043805.0*K5[n] + (652783627.0/914296604.0)*K6[n] + (11173962825.0/925320556.0)*K7[n] - 13158990841.0/6184727034.0*K8[n] + (3936647629.0/1978049680.0)*K9[n] - 160528059.0/685178525.0*K10[n] + (248638103.0/1413531060.0)*K11[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K13[n] = h*f_last[n];
+    }
+
+    // The answer and the embedded solution, in one pass.
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n] + (14005451.0/335480064.0)*K1[n] - 59238493.0/1068277825.0*K6[n] + (181606767.0/758867731.0)*K7[n] + (561292985.0/797845732.0)*K8[n] - 1041891430.0/1371343529.0*K9[n] + (760417239.0/1151165299.0)*K10[n] + (118820643.0/751138087.0)*K11[n] - 528747749.0/2220607170.0*K12[n] + (1.0/4.0)*K13[n];
+        y_embedded[n] = y[n] + (13451932.0/455176623.0)*K1[n] - 808719846.0/976000145.0*K6[n] + (1757004468.0/5645159321.0)*K7[n] + (656045339.0/265891186.0)*K8[n] - 3867574721.0/1518517206.0*K9[n] + (465885868.0/322736535.0)*K10[n] + (53011238.0/667516719.0)*K11[n] + (2.0/45.0)*K12[n];
+    }
+    return 0;
+}
+
+/*
+ * Generated by nrpy_odiegm_codegen.py from butcher_Vern9 in nrpy_odiegm.h, don't edit by hand.
+ * One step of Vern9 from (x, y), the same as nrpy_odiegm_evolve_apply's stage loop:
+ * K holds the K-values (h*f at each stage, stage j at K + j*dimension, like the dense output),
+ * f_start is f(x, y), f_last comes back as f at the last stage.
+ * y_insert is scratch space for the stage inputs, as long as y. It's the caller's so that
+ * nothing the size of the system goes on the stack.
+ */
+int nrpy_odiegm_kernel_Vern9(const nrpy_odiegm_system * dydt, double x, double h, const double y[], const double f_start[],
+    double K[], double y_insert[], double y_new[], double y_embedded[], double f_last[]) {
+    int number_of_equations = (int)(dydt->dimension);
+    double * restrict K1 = K + number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        K1[n] = h*f_start[n];
+    }
+
+    // Stage 2.
+    double * restrict K2 = K + 2*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.03462*K1[n];
+    }
+    dydt->function(x + 0.03462*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K2[n] = h*f_last[n];
+    }
+
+    // Stage 3.
+    double * restrict K3 = K + 3*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 0.0389335438857287*K1[n] + 0.13595789452451*K2[n];
+    }
+    dydt->function(x + 0.09702435063878045*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K3[n] = h*f_last[n];
+    }
+
+    // Stage 4.
+    double * restrict K4 = K + 4*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.03638413148954267*K1[n] + 0.10915239446862801*K3[n];
+    }
+    dydt->function(x + 0.14553652595817068*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K4[n] = h*f_last[n];
+    }
+
+    // Stage 5.
+    double * restrict K5 = K + 5*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 2.0257639143939694*K1[n] - 7.638023836496292*K3[n] + 6.173259922102322*K4[n];
+    }
+    dydt->function(x + 0.561*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K5[n] = h*f_last[n];
+    }
+
+    // Stage 6.
+    double * restrict K6 = K + 6*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.05112275589406061*K1[n] + 0.17708237945550218*K4[n] + 0.0008027762409222536*K5[n];
+    }
+    dydt->function(x + 0.22900791159048503*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K6[n] = h*f_last[n];
+    }
+
+    // Stage 7.
+    double * restrict K7 = K + 7*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.13160063579752163*K1[n] - 0.2957276252669636*K4[n] + 0.08781378035642955*K5[n] + 0.6213052975225274*K6[n];
+    }
+    dydt->function(x + 0.544992088409515*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K7[n] = h*f_last[n];
+    }
+
+    // Stage 8.
+    double * restrict K8 = K + 8*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.07166666666666667*K1[n] + 0.33055335789153195*K6[n] + 0.2427799754418014*K7[n];
+    }
+    dydt->function(x + 0.645*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K8[n] = h*f_last[n];
+    }
+
+    // Stage 9.
+    double * restrict K9 = K + 9*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.071806640625*K1[n] + 0.3294380283228177*K6[n] + 0.1165190029271823*K7[n] - 0.034013671875*K8[n];
+    }
+    dydt->function(x + 0.48375*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K9[n] = h*f_last[n];
+    }
+
+    // Stage 10.
+    double * restrict K10 = K + 10*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.04836757646340646*K1[n] + 0.03928989925676164*K6[n] + 0.10547409458903446*K7[n] - 0.021438652846483126*K8[n] - 0.10412291746271944*K9[n];
+    }
+    dydt->function(x + 0.06757*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K10[n] = h*f_last[n];
+    }
+
+    // Stage 11.
+    double * restrict K11 = K + 11*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 0.026645614872014785*K1[n] + 0.03333333333333333*K6[n] - 0.1631072244872467*K7[n] + 0.03396081684127761*K8[n] + 0.1572319413814626*K9[n] + 0.21522674780318796*K10[n];
+    }
+    dydt->function(x + 0.25*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K11[n] = h*f_last[n];
+    }
+
+    // Stage 12.
+    double * restrict K12 = K + 12*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.03689009248708622*K1[n] - 0.1465181576725543*K6[n] + 0.2242577768172024*K7[n] + 0.02294405717066073*K8[n] - 0.0035850052905728597*K9[n] + 0.08669223316444385*K10[n] + 0.43838406519683376*K11[n];
+    }
+    dydt->function(x + 0.6590650618730999*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K12[n] = h*f_last[n];
+    }
+
+    // Stage 13.
+    double * restrict K13 = K + 13*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 0.4866012215113341*K1[n] - 6.304602650282853*K6[n] - 0.2812456182894729*K7[n] - 2.679019236219849*K8[n] + 0.5188156639241577*K9[n] + 1.3653531876033418*K10[n] + 5.8850910885039465*K11[n] + 2.8028087862720636*K12[n];
+    }
+    dydt->function(x + 0.8206*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K13[n] = h*f_last[n];
+    }
+
+    // Stage 14.
+    double * restrict K14 = K + 14*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 0.4185367457753472*K1[n] + 6.724547581906459*K6[n] - 0.42544428016461133*K7[n] + 3.3432791530012653*K8[n] + 0.6170816631175374*K9[n] - 0.9299661239399329*K10[n] - 6.099948804751011*K11[n] - 3.002206187889399*K12[n] + 0.2553202529443446*K13[n];
+    }
+    dydt->function(x + 0.9012*h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K14[n] = h*f_last[n];
+    }
+
+    // Stage 15.
+    double * restrict K15 = K + 15*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] - 0.7793740861228848*K1[n] - 13.937342538107776*K6[n] + 1.2520488533793563*K7[n] - 14.691500408016868*K8[n] - 0.494705058533141*K9[n] + 2.2429749091462368*K10[n] + 13.367893803828643*K11[n] + 14.396650486650687*K12[n] - 0.79758133317768*K13[n] + 0.4409353709534278*K14[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K15[n] = h*f_last[n];
+    }
+
+    // Stage 16.
+    double * restrict K16 = K + 16*number_of_equations;
+    for (int n = 0; n < number_of_equations; n++) {
+        y_insert[n] = y[n] + 2.0580513374668867*K1[n] + 22.357937727968032*K6[n] + 0.9094981099755646*K7[n] + 35.89110098240264*K8[n] - 3.442515027624454*K9[n] - 4.865481358036369*K10[n] - 18.909803813543427*K11[n] - 34.26354448030452*K12[n] + 1.2647565216956427*K13[n];
+    }
+    dydt->function(x + h, y_insert, f_last, dydt->params);
+    for (int n = 0; n < number_of_equations; n++) {
+        K16[n] = h*f_last[n];
+    }
+
+    // The answer and the embedded solution, in one pass.
+    for (int n = 0; n < number_of_equations; n++) {
+        y_new[n] = y[n] + 0.014611976858423152*K1[n] - 0.3915211862331339*K8[n] + 0.23109325002895065*K9[n] + 0.12747667699928525*K10[n] + 0.2246434176204158*K11[n] + 0.5684352689748513*K12[n] + 0.058258715572158275*K13[n] + 0.13643174034822156*K14[n] + 0.030570139830827976*K15[n];
+        y_embedded[n] = y[n] + 0.01996996514886773*K1[n] + 2.19149930494933*K8[n] + 0.08857071848208439*K9[n] + 0.11405602348659657*K10[n] + 0.2533163805345107*K11[n] - 2.056564386240941*K12[n] + 0.340809679901312*K13[n] + 0.04834231373823958*K16[n];
+    }
+    return 0;
+}
+
+// The generated kernel for a built-in table, NULL if it doesn't have one.
+nrpy_odiegm_kernel nrpy_odiegm_builtin_kernel (const nrpy_odiegm_step_type * step_type) {
+    if (step_type->butcher == (void *)butcher_ADP5) {
+        return nrpy_odiegm_kernel_ADP5;
+    }
+    if (step_type->butcher == (void *)butcher_Tsit5) {
+        return nrpy_odiegm_kernel_Tsit5;
+    }
+    if (step_type->butcher == (void *)butcher_Vern6) {
+        return nrpy_odiegm_kernel_Vern6;
+    }
+    if (step_type->butcher == (void *)butcher_Vern7) {
+        return nrpy_odiegm_kernel_Vern7;
+    }
+    if (step_type->butcher == (void *)butcher_ADP8) {
+        return nrpy_odiegm_kernel_ADP8;
+    }
+    if (step_type->butcher == (void *)butcher_Vern9) {
+        return nrpy_odiegm_kernel_Vern9;
+    }
+    return NULL;
+}
@@ -23,6 +23,7 @@ int main()
     // in nrpy_odiegm_user_methods.c
 
     double step = 0.00001; // the "step" value. Initial step if using an adaptive method.
+    // Set it to zero (or anything negative) and Odie will estimate a good initial step itself. 
     double current_position = 0.0; // where the boundary/initial condition is. 
     // Same for every equation in the system.
     int number_of_equations = 4; // How many equations are in our system?
@@ -35,6 +36,14 @@ int main()
     // If we are not using the AB method this is set to 0 later automatically. 4 by default. 
     bool no_adaptive_step = false; // Sometimes we just want to step forward uniformly 
     // without using GSL's awkward setup. False by default. 
+    bool enthalpy_formulation = false; // Integrate the star in pseudo-enthalpy instead of radius? 
+    // Then the star ends exactly at h = 0 instead of wherever the pressure happens to cross 0, usually 
+    // in far fewer steps. Needs enthalpy_of_pressure and enthalpy_const_eval in nrpy_odiegm_user_methods.c. 
+    double enthalpy_step = 0.0; // The step in pseudo-enthalpy for methods that don't adapt it. 
+    // Zero (or anything negative) estimates it. Adaptive methods always estimate their first step. 
+    bool logarithmic_position = false; // Step in ln(x) instead of x? Then the step (and the limits on it 
+    // in d->c) are in ln(x), which suits anything spread over many decades of x. x has to stay positive, 
+    // which it does once series_start has moved us off the center. 
 
     bool report_error_actual = false;
     bool report_error_estimates = false;
@@ -47,6 +56,10 @@ int main()
     double absolute_error_limit = 1e-14; // How big do we let the absolute error be?
     double relative_error_limit = 1e-14; // How big do we let the relative error be?
     // Default: 1e-14 for both.
+    int error_norm = 0; // How the errors of the different equations are combined when judging a step.
+    // 0 lets the worst equation decide (max norm, the default), 1 uses the RMS over all equations. 
+    // Each equation can also get its own limits, or be left out of step control entirely, 
+    // see nrpy_odiegm_control_set_tolerances below. 
     // Note: there are a lot more error control numbers that can be set inside the 
     // control "object" (struct) d->c.
 
@@ -56,12 +69,33 @@ int main()
     const nrpy_odiegm_step_type * step_type;
     step_type = nrpy_odiegm_step_AB;
     // Here is where the method is actually set, by specific name since that's what GSL does. 
+    // At tight error limits try nrpy_odiegm_step_Tsit5 or _Vern7, see nrpy_odiegm_benchmark.c. 
+    // Tsit5 can also fill in between steps, see nrpy_odiegm_evolve_dense_output. 
+    // nrpy_odiegm_step_GBS (extrapolation) is another option for smooth problems at tight limits. 
+    // nrpy_odiegm_step_set_extrapolation_threads(d->s, threads) runs it on several cores, 
+    // but only if diffy_Q_eval is thread-safe. The TOV one here isn't, it writes into cp. 
+    // For a long solve where only the end (or a few points) matter, nrpy_odiegm_parareal_alloc 
+    // and nrpy_odiegm_parareal_apply spread it over threads in time instead. Same thread-safety caveat. 
+    // Second order systems (y'' = f(x,y), orbits and the like) don't need doubling into first order form: 
+    // write f into an nrpy_odiegm_system_nystrom and step with nrpy_odiegm_evolve_apply_nystrom 
+    // and nrpy_odiegm_step_RKN6 (fixed steps) or _Nystrom4. 
+    // For very long runs of a Hamiltonian system (H = T(p) + V(q)), nrpy_odiegm_system_split with 
+    // nrpy_odiegm_evolve_apply_split and a symplectic method (nrpy_odiegm_step_Verlet, _ForestRuth, 
+    // _Yoshida6, _Yoshida8, _BlanesMoan) keeps the energy error bounded instead of drifting. 
+    // For very big systems (method of lines and so on) where memory is what runs out, 
+    // nrpy_odiegm_step_CK4 and _Williamson3 (fixed steps) keep two arrays the size of the state besides y. 
+    // If that state is NRPy+ gridfunctions, nrpy_odiegm_driver_alloc_gridfunctions steps them in place 
+    // and leaves the ghost zones out of the error estimate. 
+    // If the equations are cheap enough that calling them is most of the cost, give the system a 
+    // batch_function too (several points per call), the solver uses it wherever points are independent. 
 
     const nrpy_odiegm_step_type * step_type_2;
     step_type_2 = nrpy_odiegm_step_AB;
     // This is a second step type "object" (struct) for hybridizing. 
     // Only used if the original type is AB.
     // Set to AB to use pure AB method. 
+    // (For hybridizing an explicit method with an implicit one when the system turns stiff, 
+    // see nrpy_odiegm_step_set_stiff_switching instead. That one switches both ways automatically.)
 
     // AFTER THIS POINT THERE SHOULD BE NO NEED FOR USER INPUT, THE CODE SHOULD HANDLE ITSELF. 
 
@@ -75,10 +109,23 @@ int main()
     // nrpy_odiegm_user_methods.c manually.
     // The methods that make use of it it need to be declared as well, if they are used.
 
-    nrpy_odiegm_system system = {diffy_Q_eval,known_Q_eval,number_of_equations,&cp};
+    nrpy_odiegm_system system = {diffy_Q_eval,known_Q_eval,number_of_equations,&cp,NULL,NULL,NULL,NULL};
     // This is the system of equations we solve.
     // The second slot was originally the Jacobian in GSL, but we use it to pass a 
     // true answer function that may or may not be used.
+    // A fifth entry would be the Jacobian. It's only used by the implicit methods 
+    // (nrpy_odiegm_step_ROS3P, _RODAS4 and _ESDIRK3, for stiff systems), and when it's left out 
+    // they build the Jacobian with finite differences. 
+    // For big systems with a sparse Jacobian (method of lines, networks) put a sixth entry, 
+    // e.g. nrpy_odiegm_sparsity_banded_alloc(number_of_equations,1,1) for a tridiagonal one. 
+    // Then the finite differences only cost a few function calls per Jacobian. 
+    // Too big even for that? nrpy_odiegm_step_set_matrix_free(d->s, 30) after the driver is made 
+    // never stores a Jacobian at all, and a seventh entry can hand GMRES a preconditioner. 
+#ifdef TOV_RHS_SIMD
+    system.batch_function = diffy_Q_eval_batch;
+    // Only there when nrpy_odiegm_TOV_rhs.c was generated with --simd, 
+    // then several stage points get evaluated per call, SIMD_width at a time. 
+#endif
 
     nrpy_odiegm_driver *d;
     d = nrpy_odiegm_driver_alloc_y_new(&system, step_type, step, absolute_error_limit, relative_error_limit); 
@@ -100,6 +147,14 @@ int main()
     }
     d->s->adams_bashforth_order = adams_bashforth_order;
     d->e->no_adaptive_step = no_adaptive_step;
+    d->c->error_norm = error_norm;
+    // Uncomment to give every equation its own error limits. Equations marked false in the mask 
+    // no longer have any say in the step size. Passing NULL for any of the arrays uses the 
+    // scalar limits (or counts every equation) for that part. 
+    // double absolute_error_limits[4] = {1e-14, 1e-14, 1e-14, 1e-14};
+    // double relative_error_limits[4] = {1e-14, 1e-14, 1e-14, 1e-14};
+    // bool error_mask[4] = {true, true, true, true};
+    // nrpy_odiegm_control_set_tolerances(d->c, number_of_equations, absolute_error_limits, relative_error_limits, error_mask);
     // Based on what type of method we are using, we adjust some parameters within the driver.
 
     if (method_type == 2) {
@@ -178,6 +233,152 @@ int main()
         fprintf(fp2,"\n");
     }
 
+    // The equations may not be usable right where they start (the TOV equations are 0/0 at the center), 
+    // so series_start gets to move us a short way out first, with a series expansion good to the error limit. 
+    // Systems that don't need it just return current_position. 
+    double x_center = 0.0;
+    if (enthalpy_formulation == true) {
+        x_center = -enthalpy_of_pressure(y[0]); // Where the center is in pseudo-enthalpy, see below. 
+    }
+    double series_position = series_start(current_position, y, &cp, relative_error_limit);
+    bool series_started = (series_position != current_position);
+    if (series_started == true) {
+        current_position = series_position;
+        assign_constants(c,&cp);
+        fprintf(fp2, "Position:,\t%15.14e,\t",current_position);
+        for (int n = 0; n < number_of_equations; n++) {
+            fprintf(fp2, "Equation %i:,\t%15.14e,\t",n, y[n]);
+        }
+        for (int n = 0; n < number_of_constants; n++) {
+            fprintf(fp2, "Constant %i:,\t%15.14e,\t",n, c[n]);
+        }
+        fprintf(fp2,"\n");
+        // The series is as good as the error limit, so there's nothing to report as an error either. 
+        if (report_error_estimates == true) {
+            fprintf(fp2, "Errors Estimates:,\t");
+            for (int n = 0; n < number_of_equations; n++) {
+                fprintf(fp2, "Equation %i:,\t0.0,\t",n);
+            }
+            fprintf(fp2,"\n");
+        }
+        if (report_error_actual == true) {
+            fprintf(fp2, "Errors:,\t");
+            for (int n = 0; n < number_of_equations; n++) {
+                fprintf(fp2, "Equation %i:,\t0.0,\t",n);
+                fprintf(fp2, "Truth:,\t%15.14e,\t",y[n]);
+            }
+            fprintf(fp2,"\n");
+        }
+        printf("Series start to %15.14e.\n",current_position);
+    }
+
+    if (enthalpy_formulation == true) {
+        // The star in pseudo-enthalpy h instead of radius (Lindblom 1992). h runs from its central 
+        // value down to exactly 0 at the surface, so the surface is the end of a fixed interval instead 
+        // of somewhere the pressure crosses 0. Odie only steps forward, so the independent variable is 
+        // x = -h, from -h_c up to 0, and the radius becomes one of the variables. 
+        // Which variables exactly is up to radius_to_enthalpy in nrpy_odiegm_user_methods.c, 
+        // the file still gets the usual ones. 
+        nrpy_odiegm_system system_enthalpy = {diffy_Q_eval_enthalpy,known_Q_eval,number_of_equations+1,&cp,NULL,NULL,NULL,NULL};
+        nrpy_odiegm_driver *d_enthalpy;
+        d_enthalpy = nrpy_odiegm_driver_alloc_y_new(&system_enthalpy, step_type, enthalpy_step, absolute_error_limit, relative_error_limit);
+        d_enthalpy->s->adams_bashforth_order = adams_bashforth_order;
+        d_enthalpy->e->no_adaptive_step = no_adaptive_step;
+        d_enthalpy->c->error_norm = error_norm;
+
+        double y_enthalpy[number_of_equations+1];
+        double x = radius_to_enthalpy(current_position, y, y_enthalpy);
+        bool fixed_steps = (method_type == 0 || method_type == 2 || no_adaptive_step == true);
+        if (enthalpy_step <= 0.0 || fixed_steps == false) {
+            enthalpy_step = nrpy_odiegm_initial_step(&system_enthalpy, d_enthalpy->c, d_enthalpy->s, x, y_enthalpy);
+        }
+        if (fixed_steps == false && enthalpy_step > x - x_center) {
+            // Near the center the equations have terms like (4 pi rho - 3m/r^3)/r^2, which are fine 
+            // along the solution but punish any step that's large next to r^2, and the estimate above 
+            // can't see that. So an adaptive method starts no further than the series already took us. 
+            enthalpy_step = x - x_center;
+        }
+        if (fixed_steps == true) {
+            // Fixed steps get evened out so they land on the surface, rather than finishing with a stub. 
+            enthalpy_step = -x/ceil(-x/enthalpy_step);
+        }
+
+        int i = 0;
+        while (x < 0.0 && i < size) {
+            // The same hybrid footwork as the main loop below. 
+            if (method_type == 2 && i == 0 && step_type_2 != nrpy_odiegm_step_AB) {
+                d_enthalpy->s->type = step_type_2;
+                d_enthalpy->s->rows = step_type_2->rows;
+                d_enthalpy->s->columns = step_type_2->columns;
+                d_enthalpy->s->method_type = 0;
+                d_enthalpy->s->adams_bashforth_order = adams_bashforth_order;
+                d_enthalpy->e->no_adaptive_step = true;
+            } else if (step_type != step_type_2 && method_type == 2 && i == adams_bashforth_order) {
+                d_enthalpy->s->type = step_type;
+                d_enthalpy->s->rows = step_type->rows;
+                d_enthalpy->s->columns = step_type->columns;
+                d_enthalpy->s->method_type = 2;
+                d_enthalpy->s->adams_bashforth_order = adams_bashforth_order;
+                d_enthalpy->e->no_adaptive_step = true;
+            }
+
+            nrpy_odiegm_evolve_apply(d_enthalpy->e, d_enthalpy->c, d_enthalpy->s, &system_enthalpy, &x, 0.0, &enthalpy_step, y_enthalpy);
+            // t1 = 0 is the surface, evolve_apply cuts the last step short to land on it exactly. 
+            i++;
+
+            current_position = enthalpy_to_radius(x, y_enthalpy, y, &cp);
+            assign_constants(c,&cp);
+            // Same file format as the main loop. 
+            fprintf(fp2, "Position:,\t%15.14e,\t",current_position);
+            for (int n = 0; n < number_of_equations; n++) {
+                fprintf(fp2, "Equation %i:,\t%15.14e,\t",n, y[n]);
+            }
+            for (int n = 0; n < number_of_constants; n++) {
+                fprintf(fp2, "Constant %i:,\t%15.14e,\t",n, c[n]);
+            }
+            fprintf(fp2,"\n");
+            if (report_error_estimates == true) {
+                // These are for the enthalpy variables, not the ones printed above. 
+                fprintf(fp2, "Error Estimates:,\t");
+                for (int n = 0; n < number_of_equations; n++) {
+                    fprintf(fp2, "Equation %i:,\t%15.14e,\t",n,(d_enthalpy->e->yerr[n])); 
+                }
+                fprintf(fp2,"\n");
+            }
+            if (report_error_actual == true) {
+                // There's no known solution in terms of h, so these are all zero. 
+                fprintf(fp2, "Errors:,\t");
+                for (int n = 0; n < number_of_equations; n++) {
+                    fprintf(fp2, "Equation %i:,\t0.0,\t",n);
+                    fprintf(fp2, "Truth:,\t%15.14e,\t",y[n]);
+                }
+                fprintf(fp2,"\n");
+            }
+        }
+
+        // current_position and y are back in radius for whatever comes after the surface. 
+        printf("Surface at %15.14e after %i steps in enthalpy.\n",current_position,i);
+        nrpy_odiegm_driver_free(d_enthalpy);
+    }
+
+    nrpy_odiegm_transform log_position = {&system, nrpy_odiegm_log_to_s, nrpy_odiegm_log_to_x, nrpy_odiegm_log_dx_ds, NULL, false, 0.0, 0.0};
+    // s = ln(x), for logarithmic_position. 
+
+    if (step <= 0.0 || ((series_started == true || enthalpy_formulation == true) && method_type != 2 && no_adaptive_step == false)) {
+        // No initial step was given, so estimate one from the initial conditions. 
+        // Same if we just jumped off the center: the step given was sized for creeping out of it, 
+        // an adaptive method can start with one sized for where it actually is. 
+        // And the same again if the star itself was done in enthalpy. 
+        if (logarithmic_position == true) {
+            nrpy_odiegm_system system_log = {nrpy_odiegm_transformed_function, NULL, number_of_equations, &log_position, NULL, NULL, NULL, NULL};
+            step = nrpy_odiegm_initial_step(&system_log, d->c, d->s, log(current_position), y);
+        } else {
+            step = nrpy_odiegm_initial_step(&system, d->c, d->s, current_position, y);
+        }
+        d->h = step;
+        printf("Estimated initial step: %15.14e.\n",step);
+    }
+
     // SECTION II: The Loop
 
     // This loop fills out all the data.
@@ -204,7 +405,12 @@ int main()
             d->e->no_adaptive_step = true;
         }
 
-        nrpy_odiegm_evolve_apply(d->e, d->c, d->s, &system, &current_position, current_position+step, &step, y);
+        if (logarithmic_position == true) {
+            nrpy_odiegm_evolve_apply_transformed(d->e, d->c, d->s, &log_position, &current_position, HUGE_VAL, &step, y);
+            // The same step in ln(x). There's no end point to land on, do_we_terminate decides when to stop. 
+        } else {
+            nrpy_odiegm_evolve_apply(d->e, d->c, d->s, &system, &current_position, current_position+step, &step, y);
+        }
         // This is the line that actually performs the step.
 
         exception_handler(current_position,y);
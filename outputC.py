@@ -32,8 +32,9 @@ outCparams = namedtuple('outCparams', 'preindent includebraces declareoutputvars
 nrpyAbs = sp.Function('nrpyAbs')
 custom_functions_for_SymPy_ccode = {
     "nrpyAbs": "fabs",
-    'Pow': [(lambda b, e: e == 0.5, lambda b, e: 'sqrt(%s)'     % (b)),
-            (lambda b, e: e ==-0.5, lambda b, e: '(1.0/sqrt(%s))'     % (b)),
+    # Rationals, not 0.5: newer SymPy no longer has Rational(1, 2) == 0.5.
+    'Pow': [(lambda b, e: e == sp.S.Half, lambda b, e: 'sqrt(%s)'     % (b)),
+            (lambda b, e: e ==-sp.S.Half, lambda b, e: '(1.0/sqrt(%s))'     % (b)),
             (lambda b, e: e == sp.S.One/3, lambda b, e: 'cbrt(%s)' % (b)),
             (lambda b, e: e ==-sp.S.One/3, lambda b, e: '(1.0/cbrt(%s))' % (b)),
             (lambda b, e: e == 2, lambda b, e: '((%s)*(%s))'                % (b,b)),